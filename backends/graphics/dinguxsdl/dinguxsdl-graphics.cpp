@@ -37,6 +37,8 @@ static const OSystem::GraphicsMode s_supportedGraphicsModes[] = {
 
 DINGUXSdlGraphicsManager::DINGUXSdlGraphicsManager(SdlEventSource *boss)
 	: SurfaceSdlGraphicsManager(boss) {
+	// The screen updates here only handle 16bpp
+	_trueColorScaling = false;
 }
 
 const OSystem::GraphicsMode *DINGUXSdlGraphicsManager::getSupportedGraphicsModes() const {
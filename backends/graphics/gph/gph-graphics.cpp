@@ -37,6 +37,8 @@ static const OSystem::GraphicsMode s_supportedGraphicsModes[] = {
 
 GPHGraphicsManager::GPHGraphicsManager(SdlEventSource *sdlEventSource)
 	: SurfaceSdlGraphicsManager(sdlEventSource) {
+	// The screen updates here only handle 16bpp
+	_trueColorScaling = false;
 }
 
 const OSystem::GraphicsMode *GPHGraphicsManager::getSupportedGraphicsModes() const {
@@ -47,6 +47,8 @@ static const OSystem::GraphicsMode s_supportedGraphicsModes[] = {
 
 LinuxmotoSdlGraphicsManager::LinuxmotoSdlGraphicsManager(SdlEventSource *sdlEventSource)
  : SurfaceSdlGraphicsManager(sdlEventSource) {
+	// The screen updates here only handle 16bpp
+	_trueColorScaling = false;
 }
 
 const OSystem::GraphicsMode *LinuxmotoSdlGraphicsManager::getSupportedGraphicsModes() const {
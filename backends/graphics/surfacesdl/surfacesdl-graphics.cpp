@@ -35,6 +35,7 @@
 #ifdef USE_RGB_COLOR
 #include "common/list.h"
 #endif
+#include "graphics/conversion.h"
 #include "graphics/font.h"
 #include "graphics/fontman.h"
 #include "graphics/scaler.h"
@@ -84,7 +85,7 @@ static const int s_gfxModeSwitchTable[][4] = {
 	};
 
 #ifdef USE_SCALERS
-static int cursorStretch200To240(uint8 *buf, uint32 pitch, int width, int height, int srcX, int srcY, int origSrcY);
+static int cursorStretch200To240(uint8 *buf, uint32 pitch, int bytesPerPixel, int width, int height, int srcX, int srcY, int origSrcY);
 #endif
 
 AspectRatio::AspectRatio(int w, int h) {
@@ -126,7 +127,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_screenFormat(Graphics::PixelFormat::createFormatCLUT8()),
 	_cursorFormat(Graphics::PixelFormat::createFormatCLUT8()),
 #endif
-	_overlayVisible(false),
+	_trueColorScaling(false), _overlayVisible(false),
 	_overlayscreen(0), _tmpscreen2(0),
 	_scalerProc(0), _screenChangeCount(0),
 	_mouseVisible(false), _mouseNeedsRedraw(false), _mouseData(0), _mouseSurface(0),
@@ -155,9 +156,14 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_mouseBackup.x = _mouseBackup.y = _mouseBackup.w = _mouseBackup.h = 0;
 
 	memset(&_mouseCurState, 0, sizeof(_mouseCurState));
+	memset(&_dirtyRectStats, 0, sizeof(_dirtyRectStats));
 
 	_graphicsMutex = g_system->createMutex();
 
+	// Scaling into a 32bpp screen is opt-in until it has seen more testing
+	if (ConfMan.hasKey("sdl_true_color_scaling"))
+		_trueColorScaling = ConfMan.getBool("sdl_true_color_scaling");
+
 #ifdef USE_SDL_DEBUG_FOCUSRECT
 	if (ConfMan.hasKey("use_sdl_debug_focusrect"))
 		_enableFocusRectDebugCode = ConfMan.getBool("use_sdl_debug_focusrect");
@@ -188,6 +194,17 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 #else
 	_videoMode.fullscreen = true;
 #endif
+
+	// Number of additional threads used for scaling. By default we use one
+	// per extra CPU core, where SDL can tell us how many there are.
+	int scalerThreads = 0;
+	if (ConfMan.hasKey("scaler_threads"))
+		scalerThreads = ConfMan.getInt("scaler_threads");
+#if SDL_VERSION_ATLEAST(1, 3, 0)
+	else
+		scalerThreads = SDL_GetCPUCount() - 1;
+#endif
+	_scalerPool.start(scalerThreads);
 }
 
 SurfaceSdlGraphicsManager::~SurfaceSdlGraphicsManager() {
@@ -195,6 +212,7 @@ SurfaceSdlGraphicsManager::~SurfaceSdlGraphicsManager() {
 	if (g_system->getEventManager()->getEventDispatcher() != NULL)
 		g_system->getEventManager()->getEventDispatcher()->unregisterObserver(this);
 
+	_scalerPool.stop();
 	unloadGFXMode();
 	if (_mouseSurface)
 		SDL_FreeSurface(_mouseSurface);
@@ -765,9 +783,20 @@ bool SurfaceSdlGraphicsManager::loadGFXMode() {
 		fixupResolutionForAspectRatio(_videoMode.desiredAspectRatio, _videoMode.hardwareWidth, _videoMode.hardwareHeight);
 	}
 
-	_hwscreen = SDL_SetVideoMode(_videoMode.hardwareWidth, _videoMode.hardwareHeight, 16,
-		_videoMode.fullscreen ? (SDL_FULLSCREEN|SDL_SWSURFACE) : SDL_SWSURFACE
-	);
+	const Uint32 videoFlags = _videoMode.fullscreen ? (SDL_FULLSCREEN|SDL_SWSURFACE) : SDL_SWSURFACE;
+
+	// Scale into 32bpp when the display uses it, otherwise SDL converts the
+	// whole 16bpp surface on every update. The 8888 scalers need the
+	// channels in ARGB order.
+	_hwscreen = NULL;
+	if (_trueColorScaling && SDL_VideoModeOK(_videoMode.hardwareWidth, _videoMode.hardwareHeight, 32, videoFlags) == 32) {
+		_hwscreen = SDL_SetVideoMode(_videoMode.hardwareWidth, _videoMode.hardwareHeight, 32, videoFlags);
+		if (_hwscreen && (_hwscreen->format->BytesPerPixel != 4 || _hwscreen->format->Rmask != 0xFF0000 ||
+		                  _hwscreen->format->Gmask != 0xFF00 || _hwscreen->format->Bmask != 0xFF))
+			_hwscreen = NULL;
+	}
+	if (!_hwscreen)
+		_hwscreen = SDL_SetVideoMode(_videoMode.hardwareWidth, _videoMode.hardwareHeight, 16, videoFlags);
 #ifdef USE_RGB_COLOR
 	detectSupportedFormats();
 #endif
@@ -785,12 +814,12 @@ bool SurfaceSdlGraphicsManager::loadGFXMode() {
 	}
 
 	//
-	// Create the surface used for the graphics in 16 bit before scaling, and also the overlay
+	// Create the surface used for the graphics in the hardware format before scaling, and also the overlay
 	//
 
 	// Need some extra bytes around when using 2xSaI
 	_tmpscreen = SDL_CreateRGBSurface(SDL_SWSURFACE, _videoMode.screenWidth + 3, _videoMode.screenHeight + 3,
-						16,
+						_hwscreen->format->BitsPerPixel,
 						_hwscreen->format->Rmask,
 						_hwscreen->format->Gmask,
 						_hwscreen->format->Bmask,
@@ -799,12 +828,20 @@ bool SurfaceSdlGraphicsManager::loadGFXMode() {
 	if (_tmpscreen == NULL)
 		error("allocating _tmpscreen failed");
 
+	updatePaletteMap(0, 256);
+
+	// The GUI only draws 16bpp, so with a 32bpp hardware screen the overlay
+	// and the OSD use RGB565 and SDL converts them when they are blitted
+	Uint32 rMask16 = 0xF800, gMask16 = 0x07E0, bMask16 = 0x001F, aMask16 = 0;
+	if (_hwscreen->format->BytesPerPixel == 2) {
+		rMask16 = _hwscreen->format->Rmask;
+		gMask16 = _hwscreen->format->Gmask;
+		bMask16 = _hwscreen->format->Bmask;
+		aMask16 = _hwscreen->format->Amask;
+	}
+
 	_overlayscreen = SDL_CreateRGBSurface(SDL_SWSURFACE, _videoMode.overlayWidth, _videoMode.overlayHeight,
-						16,
-						_hwscreen->format->Rmask,
-						_hwscreen->format->Gmask,
-						_hwscreen->format->Bmask,
-						_hwscreen->format->Amask);
+						16, rMask16, gMask16, bMask16, aMask16);
 
 	if (_overlayscreen == NULL)
 		error("allocating _overlayscreen failed");
@@ -822,7 +859,7 @@ bool SurfaceSdlGraphicsManager::loadGFXMode() {
 	_overlayFormat.aShift = _overlayscreen->format->Ashift;
 
 	_tmpscreen2 = SDL_CreateRGBSurface(SDL_SWSURFACE, _videoMode.overlayWidth + 3, _videoMode.overlayHeight + 3,
-						16,
+						_hwscreen->format->BitsPerPixel,
 						_hwscreen->format->Rmask,
 						_hwscreen->format->Gmask,
 						_hwscreen->format->Bmask,
@@ -835,11 +872,7 @@ bool SurfaceSdlGraphicsManager::loadGFXMode() {
 	_osdSurface = SDL_CreateRGBSurface(SDL_SWSURFACE | SDL_RLEACCEL | SDL_SRCCOLORKEY | SDL_SRCALPHA,
 						_hwscreen->w,
 						_hwscreen->h,
-						16,
-						_hwscreen->format->Rmask,
-						_hwscreen->format->Gmask,
-						_hwscreen->format->Bmask,
-						_hwscreen->format->Amask);
+						16, rMask16, gMask16, bMask16, aMask16);
 	if (_osdSurface == NULL)
 		error("allocating _osdSurface failed");
 	SDL_SetColorKey(_osdSurface, SDL_RLEACCEL | SDL_SRCCOLORKEY | SDL_SRCALPHA, kOSDColorKey);
@@ -849,8 +882,10 @@ bool SurfaceSdlGraphicsManager::loadGFXMode() {
 		_videoMode.screenWidth * _videoMode.scaleFactor - 1,
 		effectiveScreenHeight() - 1);
 
-	// Distinguish 555 and 565 mode
-	if (_hwscreen->format->Rmask == 0x7C00)
+	// Distinguish 8888, 555 and 565 mode
+	if (_hwscreen->format->BytesPerPixel == 4)
+		InitScalers(8888);
+	else if (_hwscreen->format->Rmask == 0x7C00)
 		InitScalers(555);
 	else
 		InitScalers(565);
@@ -986,6 +1021,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		SDL_SetColors(_screen, _currentPalette + _paletteDirtyStart,
 			_paletteDirtyStart,
 			_paletteDirtyEnd - _paletteDirtyStart);
+		updatePaletteMap(_paletteDirtyStart, _paletteDirtyEnd - _paletteDirtyStart);
 
 		_paletteDirtyEnd = 0;
 
@@ -1049,14 +1085,25 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		SDL_Rect dst;
 		uint32 srcPitch, dstPitch;
 		SDL_Rect *lastRect = _dirtyRectList + _numDirtyRects;
+		const int bytesPerPixel = _hwscreen->format->BytesPerPixel;
 
 		for (r = _dirtyRectList; r != lastRect; ++r) {
 			dst = *r;
 			dst.x++;	// Shift rect by one since 2xSai needs to access the data around
 			dst.y++;	// any pixel to scale it, and we want to avoid mem access crashes.
 
-			if (SDL_BlitSurface(origSurf, r, srcSurf, &dst) != 0)
+			if (origSurf->format->BytesPerPixel == 1) {
+				// Paletted game screens are converted in one pass,
+				// straight to the pixels the scalers work on
+				const int w = MIN<int>(r->w, origSurf->w - r->x);
+				const int h = MIN<int>(r->h, origSurf->h - r->y);
+				if (w > 0 && h > 0)
+					Graphics::crossBlitMap((byte *)srcSurf->pixels + dst.y * srcSurf->pitch + dst.x * bytesPerPixel,
+						(const byte *)origSurf->pixels + r->y * origSurf->pitch + r->x,
+						srcSurf->pitch, origSurf->pitch, w, h, bytesPerPixel, _paletteMap);
+			} else if (SDL_BlitSurface(origSurf, r, srcSurf, &dst) != 0) {
 				error("SDL_BlitSurface failed: %s", SDL_GetError());
+			}
 		}
 
 		SDL_LockSurface(srcSurf);
@@ -1079,23 +1126,42 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 				orig_dst_y = dst_y;
 				dst_y = dst_y * scale1;
 
-				if (_videoMode.aspectRatioCorrection && !_overlayVisible)
+				const bool aspectCorrect = _videoMode.aspectRatioCorrection && !_overlayVisible;
+				if (aspectCorrect)
 					dst_y = real2Aspect(dst_y);
 
 				assert(scalerProc != NULL);
-				scalerProc((byte *)srcSurf->pixels + (r->x * 2 + 2) + (r->y + 1) * srcPitch, srcPitch,
-					(byte *)_hwscreen->pixels + rx1 * 2 + dst_y * dstPitch, dstPitch, r->w, dst_h);
+
+				// The scaler pool also takes care of the aspect ratio
+				// correction, so that it can be done on all threads.
+				// The NASM versions of the HQ scalers keep their state in
+				// globals, so they can only be run on one thread at once.
+				ScalerWorkerPool *pool = &_scalerPool;
+#ifdef USE_NASM
+				if (scalerProc == HQ2x || scalerProc == HQ3x)
+					pool = 0;
+#endif
+				_dirtyRectStats.scaledPixels += r->w * dst_h;
+
+				const byte *srcPtr = (const byte *)srcSurf->pixels + (r->x + 1) * bytesPerPixel + (r->y + 1) * srcPitch;
+				byte *dstPtr = (byte *)_hwscreen->pixels + rx1 * bytesPerPixel + dst_y * dstPitch;
+				if (pool) {
+					dst_h = pool->scaleRect(scalerProc, scale1, srcPtr, srcPitch, dstPtr, dstPitch, r->w, dst_h,
+						aspectCorrect ? orig_dst_y : -1, rx1, (byte *)_hwscreen->pixels);
+				} else {
+					scalerProc(srcPtr, srcPitch, dstPtr, dstPitch, r->w, dst_h);
+					dst_h *= scale1;
+#ifdef USE_SCALERS
+					if (aspectCorrect)
+						dst_h = stretch200To240((uint8 *) _hwscreen->pixels, dstPitch, r->w * scale1, dst_h, rx1, dst_y, orig_dst_y * scale1);
+#endif
+				}
 			}
 
 			r->x = rx1;
 			r->y = dst_y;
 			r->w = r->w * scale1;
-			r->h = dst_h * scale1;
-
-#ifdef USE_SCALERS
-			if (_videoMode.aspectRatioCorrection && orig_dst_y < height && !_overlayVisible)
-				r->h = stretch200To240((uint8 *) _hwscreen->pixels, dstPitch, r->w, r->h, r->x, r->y, orig_dst_y * scale1);
-#endif
+			r->h = dst_h;
 		}
 		SDL_UnlockSurface(srcSurf);
 		SDL_UnlockSurface(_hwscreen);
@@ -1189,6 +1255,8 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 
 		// Finally, blit all our changes to the screen
 		SDL_UpdateRects(_hwscreen, _numDirtyRects, _dirtyRectList);
+
+		updateDirtyRectStats();
 	}
 
 	_numDirtyRects = 0;
@@ -1196,6 +1264,23 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	_mouseNeedsRedraw = false;
 }
 
+void SurfaceSdlGraphicsManager::updateDirtyRectStats() {
+	_dirtyRectStats.frames++;
+	if (_forceFull)
+		_dirtyRectStats.fullUpdates++;
+	_dirtyRectStats.rects += _numDirtyRects;
+	for (int i = 0; i < _numDirtyRects; ++i)
+		_dirtyRectStats.uploadedPixels += _dirtyRectList[i].w * _dirtyRectList[i].h;
+
+	if (_dirtyRectStats.frames == kDirtyRectStatsFrames) {
+		const uint32 frames = _dirtyRectStats.frames;
+		debug(2, "Screen updates: %d frames, %d full, %d rects/frame, %d pixels scaled/frame, %d pixels uploaded/frame",
+			frames, _dirtyRectStats.fullUpdates, _dirtyRectStats.rects / frames,
+			_dirtyRectStats.scaledPixels / frames, _dirtyRectStats.uploadedPixels / frames);
+		memset(&_dirtyRectStats, 0, sizeof(_dirtyRectStats));
+	}
+}
+
 bool SurfaceSdlGraphicsManager::saveScreenshot(const char *filename) {
 	assert(_hwscreen != NULL);
 
@@ -1330,15 +1415,53 @@ void SurfaceSdlGraphicsManager::fillScreen(uint32 col) {
 	unlockScreen();
 }
 
+static inline int rectArea(const SDL_Rect &r) {
+	return r.w * r.h;
+}
+
+static inline SDL_Rect rectUnion(const SDL_Rect &a, const SDL_Rect &b) {
+	const int x1 = MIN<int>(a.x, b.x);
+	const int y1 = MIN<int>(a.y, b.y);
+	const int x2 = MAX<int>(a.x + a.w, b.x + b.w);
+	const int y2 = MAX<int>(a.y + a.h, b.y + b.h);
+
+	SDL_Rect r;
+	r.x = x1;
+	r.y = y1;
+	r.w = x2 - x1;
+	r.h = y2 - y1;
+	return r;
+}
+
+/**
+ * Check whether two dirty rects should be replaced by their union. This is
+ * the case when they overlap or touch each other, and the union does not
+ * cover much more than the two rects themselves.
+ */
+static bool shouldMergeRects(const SDL_Rect &a, const SDL_Rect &b) {
+	const int ix1 = MAX<int>(a.x, b.x);
+	const int iy1 = MAX<int>(a.y, b.y);
+	const int ix2 = MIN<int>(a.x + a.w, b.x + b.w);
+	const int iy2 = MIN<int>(a.y + a.h, b.y + b.h);
+
+	// Neither overlapping nor adjacent
+	if (ix1 > ix2 || iy1 > iy2)
+		return false;
+
+	const int intersection = (ix2 - ix1) * (iy2 - iy1);
+	const int covered = rectArea(a) + rectArea(b) - intersection;
+	const int wasted = rectArea(rectUnion(a, b)) - covered;
+
+	// Allow the union to waste a quarter of the area it actually needs to
+	// update; scaling a few extra pixels is cheaper than handling another
+	// rect and scaling the overlap twice.
+	return wasted * 4 <= covered;
+}
+
 void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool realCoordinates) {
 	if (_forceFull)
 		return;
 
-	if (_numDirtyRects == NUM_DIRTY_RECT) {
-		_forceFull = true;
-		return;
-	}
-
 	int height, width;
 
 	if (!_overlayVisible && !realCoordinates) {
@@ -1388,14 +1511,63 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool re
 		return;
 	}
 
-	if (w > 0 && h > 0) {
-		SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
+	if (w <= 0 || h <= 0)
+		return;
+
+	SDL_Rect rect;
+	rect.x = x;
+	rect.y = y;
+	rect.w = w;
+	rect.h = h;
+
+	// Coalesce the new rect with the rects already in the list. A merged
+	// rect may in turn overlap other ones, so keep going until nothing
+	// changes anymore. Note that the union of two rects which were made
+	// stretchable is stretchable too.
+	bool merged;
+	do {
+		merged = false;
+		for (int i = 0; i < _numDirtyRects; ++i) {
+			if (shouldMergeRects(rect, _dirtyRectList[i])) {
+				rect = rectUnion(rect, _dirtyRectList[i]);
+				_dirtyRectList[i] = _dirtyRectList[--_numDirtyRects];
+				merged = true;
+				break;
+			}
+		}
+	} while (merged);
+
+	// If the list is full, merge with the rect whose area grows least.
+	if (_numDirtyRects == NUM_DIRTY_RECT) {
+		int best = 0;
+		int bestGrowth = 0x7FFFFFFF;
+		for (int i = 0; i < _numDirtyRects; ++i) {
+			const int growth = rectArea(rectUnion(rect, _dirtyRectList[i])) - rectArea(_dirtyRectList[i]);
+			if (growth < bestGrowth) {
+				best = i;
+				bestGrowth = growth;
+			}
+		}
 
-		r->x = x;
-		r->y = y;
-		r->w = w;
-		r->h = h;
+		rect = rectUnion(rect, _dirtyRectList[best]);
+		_dirtyRectList[best] = _dirtyRectList[--_numDirtyRects];
 	}
+
+	_dirtyRectList[_numDirtyRects++] = rect;
+
+	// Real coordinates are only used for rects added after scaling, at
+	// which point a full update can't be forced anymore.
+	if (realCoordinates)
+		return;
+
+	// Once most of the screen is dirty, a single full update is cheaper than
+	// scaling and uploading many rects.
+	int dirtyArea = 0;
+	for (int i = 0; i < _numDirtyRects; ++i)
+		dirtyArea += rectArea(_dirtyRectList[i]);
+
+	if (dirtyArea * 100 >= width * height * kFullUpdatePercentage)
+		_forceFull = true;
 }
 
 int16 SurfaceSdlGraphicsManager::getHeight() {
@@ -1456,6 +1628,11 @@ void SurfaceSdlGraphicsManager::grabPalette(byte *colors, uint start, uint num)
 	}
 }
 
+void SurfaceSdlGraphicsManager::updatePaletteMap(uint start, uint num) {
+	for (uint i = start; i < start + num; ++i)
+		_paletteMap[i] = SDL_MapRGB(_tmpscreen->format, _currentPalette[i].r, _currentPalette[i].g, _currentPalette[i].b);
+}
+
 void SurfaceSdlGraphicsManager::setCursorPalette(const byte *colors, uint start, uint num) {
 	assert(colors);
 	const byte *b = colors;
@@ -1581,18 +1758,30 @@ void SurfaceSdlGraphicsManager::clearOverlay() {
 	if (SDL_BlitSurface(_screen, &src, _tmpscreen, &dst) != 0)
 		error("SDL_BlitSurface failed: %s", SDL_GetError());
 
+	// The scalers write pixels of the hardware screen. With a 32bpp screen
+	// they go to _tmpscreen2 first and are converted for the overlay.
+	SDL_Surface *scaled = _overlayscreen;
+	if (_tmpscreen2->format->BytesPerPixel != _overlayscreen->format->BytesPerPixel)
+		scaled = _tmpscreen2;
+
 	SDL_LockSurface(_tmpscreen);
-	SDL_LockSurface(_overlayscreen);
-	_scalerProc((byte *)(_tmpscreen->pixels) + _tmpscreen->pitch + 2, _tmpscreen->pitch,
-	(byte *)_overlayscreen->pixels, _overlayscreen->pitch, _videoMode.screenWidth, _videoMode.screenHeight);
+	SDL_LockSurface(scaled);
+	_scalerProc((byte *)(_tmpscreen->pixels) + _tmpscreen->pitch + _tmpscreen->format->BytesPerPixel, _tmpscreen->pitch,
+	(byte *)scaled->pixels, scaled->pitch, _videoMode.screenWidth, _videoMode.screenHeight);
 
 #ifdef USE_SCALERS
 	if (_videoMode.aspectRatioCorrection)
-		stretch200To240((uint8 *)_overlayscreen->pixels, _overlayscreen->pitch,
+		stretch200To240((uint8 *)scaled->pixels, scaled->pitch,
 						_videoMode.overlayWidth, _videoMode.screenHeight * _videoMode.scaleFactor, 0, 0, 0);
 #endif
 	SDL_UnlockSurface(_tmpscreen);
-	SDL_UnlockSurface(_overlayscreen);
+	SDL_UnlockSurface(scaled);
+
+	if (scaled != _overlayscreen) {
+		SDL_Rect overlayRect = {0, 0, _videoMode.overlayWidth, _videoMode.overlayHeight};
+		if (SDL_BlitSurface(scaled, &overlayRect, _overlayscreen, NULL) != 0)
+			error("SDL_BlitSurface failed: %s", SDL_GetError());
+	}
 
 	_forceFull = true;
 }
@@ -1753,7 +1942,7 @@ void SurfaceSdlGraphicsManager::setMouseCursor(const void *buf, uint w, uint h,
 		_mouseOrigSurface = SDL_CreateRGBSurface(SDL_SWSURFACE | SDL_RLEACCEL | SDL_SRCCOLORKEY | SDL_SRCALPHA,
 						_mouseCurState.w + 2,
 						_mouseCurState.h + 2,
-						16,
+						_hwscreen->format->BitsPerPixel,
 						_hwscreen->format->Rmask,
 						_hwscreen->format->Gmask,
 						_hwscreen->format->Bmask,
@@ -1794,19 +1983,32 @@ void SurfaceSdlGraphicsManager::blitCursor() {
 	w = _mouseCurState.w;
 	h = _mouseCurState.h;
 
-	SDL_LockSurface(_mouseOrigSurface);
+	// The cursor is scaled like the screen, so its surfaces have the pixel
+	// size of the hardware screen, which depends on the graphics mode
+	const int bytesPerPixel = _hwscreen->format->BytesPerPixel;
+	if (_mouseOrigSurface->format->BytesPerPixel != bytesPerPixel) {
+		SDL_FreeSurface(_mouseOrigSurface);
+		_mouseOrigSurface = SDL_CreateRGBSurface(SDL_SWSURFACE | SDL_RLEACCEL | SDL_SRCCOLORKEY | SDL_SRCALPHA,
+						w + 2,
+						h + 2,
+						_hwscreen->format->BitsPerPixel,
+						_hwscreen->format->Rmask,
+						_hwscreen->format->Gmask,
+						_hwscreen->format->Bmask,
+						_hwscreen->format->Amask);
 
-	// Make whole surface transparent
-	for (i = 0; i < h + 2; i++) {
-		dstPtr = (byte *)_mouseOrigSurface->pixels + _mouseOrigSurface->pitch * i;
-		for (j = 0; j < w + 2; j++) {
-			*(uint16 *)dstPtr = kMouseColorKey;
-			dstPtr += 2;
-		}
+		if (_mouseOrigSurface == NULL)
+			error("allocating _mouseOrigSurface failed");
+		SDL_SetColorKey(_mouseOrigSurface, SDL_RLEACCEL | SDL_SRCCOLORKEY | SDL_SRCALPHA, kMouseColorKey);
 	}
 
+	// Make whole surface transparent
+	SDL_FillRect(_mouseOrigSurface, NULL, kMouseColorKey);
+
+	SDL_LockSurface(_mouseOrigSurface);
+
 	// Draw from [1,1] since AdvMame2x adds artefact at 0,0
-	dstPtr = (byte *)_mouseOrigSurface->pixels + _mouseOrigSurface->pitch + 2;
+	dstPtr = (byte *)_mouseOrigSurface->pixels + _mouseOrigSurface->pitch + bytesPerPixel;
 
 	SDL_Color *palette;
 
@@ -1826,25 +2028,32 @@ void SurfaceSdlGraphicsManager::blitCursor() {
 				if (color != _mouseKeyColor) {	// transparent, don't draw
 					uint8 r, g, b;
 					_cursorFormat.colorToRGB(color, r, g, b);
-					*(uint16 *)dstPtr = SDL_MapRGB(_mouseOrigSurface->format,
-						r, g, b);
+					const Uint32 pixel = SDL_MapRGB(_mouseOrigSurface->format, r, g, b);
+					if (bytesPerPixel == 2)
+						*(uint16 *)dstPtr = pixel;
+					else
+						*(uint32 *)dstPtr = pixel;
 				}
-				dstPtr += 2;
+				dstPtr += bytesPerPixel;
 				srcPtr += _cursorFormat.bytesPerPixel;
 			} else {
 #endif
 				color = *srcPtr;
 				if (color != _mouseKeyColor) {	// transparent, don't draw
-					*(uint16 *)dstPtr = SDL_MapRGB(_mouseOrigSurface->format,
+					const Uint32 pixel = SDL_MapRGB(_mouseOrigSurface->format,
 						palette[color].r, palette[color].g, palette[color].b);
+					if (bytesPerPixel == 2)
+						*(uint16 *)dstPtr = pixel;
+					else
+						*(uint32 *)dstPtr = pixel;
 				}
-				dstPtr += 2;
+				dstPtr += bytesPerPixel;
 				srcPtr++;
 #ifdef USE_RGB_COLOR
 			}
 #endif
 		}
-		dstPtr += _mouseOrigSurface->pitch - w * 2;
+		dstPtr += _mouseOrigSurface->pitch - w * bytesPerPixel;
 	}
 
 	int rW, rH;
@@ -1880,7 +2089,8 @@ void SurfaceSdlGraphicsManager::blitCursor() {
 		_mouseCurState.rHotY = real2Aspect(_mouseCurState.rHotY);
 	}
 
-	if (_mouseCurState.rW != rW || _mouseCurState.rH != rH) {
+	if (_mouseCurState.rW != rW || _mouseCurState.rH != rH ||
+		!_mouseSurface || _mouseSurface->format->BytesPerPixel != bytesPerPixel) {
 		_mouseCurState.rW = rW;
 		_mouseCurState.rH = rH;
 
@@ -1890,7 +2100,7 @@ void SurfaceSdlGraphicsManager::blitCursor() {
 		_mouseSurface = SDL_CreateRGBSurface(SDL_SWSURFACE | SDL_RLEACCEL | SDL_SRCCOLORKEY | SDL_SRCALPHA,
 						_mouseCurState.rW,
 						_mouseCurState.rH,
-						16,
+						_hwscreen->format->BitsPerPixel,
 						_hwscreen->format->Rmask,
 						_hwscreen->format->Gmask,
 						_hwscreen->format->Bmask,
@@ -1919,13 +2129,13 @@ void SurfaceSdlGraphicsManager::blitCursor() {
 		scalerProc = Normal1x;
 	}
 
-	scalerProc((byte *)_mouseOrigSurface->pixels + _mouseOrigSurface->pitch + 2,
+	scalerProc((byte *)_mouseOrigSurface->pixels + _mouseOrigSurface->pitch + bytesPerPixel,
 		_mouseOrigSurface->pitch, (byte *)_mouseSurface->pixels, _mouseSurface->pitch,
 		_mouseCurState.w, _mouseCurState.h);
 
 #ifdef USE_SCALERS
 	if (!_cursorDontScale && _videoMode.aspectRatioCorrection)
-		cursorStretch200To240((uint8 *)_mouseSurface->pixels, _mouseSurface->pitch, rW, rH1, 0, 0, 0);
+		cursorStretch200To240((uint8 *)_mouseSurface->pixels, _mouseSurface->pitch, bytesPerPixel, rW, rH1, 0, 0, 0);
 #endif
 
 	SDL_UnlockSurface(_mouseSurface);
@@ -1935,18 +2145,18 @@ void SurfaceSdlGraphicsManager::blitCursor() {
 #ifdef USE_SCALERS
 // Basically it is kVeryFastAndUglyAspectMode of stretch200To240 from
 // common/scale/aspect.cpp
-static int cursorStretch200To240(uint8 *buf, uint32 pitch, int width, int height, int srcX, int srcY, int origSrcY) {
+static int cursorStretch200To240(uint8 *buf, uint32 pitch, int bytesPerPixel, int width, int height, int srcX, int srcY, int origSrcY) {
 	int maxDstY = real2Aspect(origSrcY + height - 1);
 	int y;
-	const uint8 *startSrcPtr = buf + srcX * 2 + (srcY - origSrcY) * pitch;
-	uint8 *dstPtr = buf + srcX * 2 + maxDstY * pitch;
+	const uint8 *startSrcPtr = buf + srcX * bytesPerPixel + (srcY - origSrcY) * pitch;
+	uint8 *dstPtr = buf + srcX * bytesPerPixel + maxDstY * pitch;
 
 	for (y = maxDstY; y >= srcY; y--) {
 		const uint8 *srcPtr = startSrcPtr + aspect2Real(y) * pitch;
 
 		if (srcPtr == dstPtr)
 			break;
-		memcpy(dstPtr, srcPtr, width * 2);
+		memcpy(dstPtr, srcPtr, width * bytesPerPixel);
 		dstPtr -= pitch;
 	}
 
@@ -25,6 +25,7 @@
 
 #include "backends/graphics/graphics.h"
 #include "backends/graphics/sdl/sdl-graphics.h"
+#include "backends/graphics/surfacesdl/surfacesdl-scalerpool.h"
 #include "graphics/pixelformat.h"
 #include "graphics/scaler.h"
 #include "common/events.h"
@@ -180,11 +181,26 @@ protected:
 	void detectSupportedFormats();
 #endif
 
+	/**
+	 * Whether the hardware screen may use 32bpp when the display does, so
+	 * that the scalers write 8888 pixels. This is off unless the
+	 * "sdl_true_color_scaling" config option is set. Subclasses with their
+	 * own 16bpp drawing code always turn it off.
+	 */
+	bool _trueColorScaling;
+
 	/** Temporary screen (for scalers) */
 	SDL_Surface *_tmpscreen;
 	/** Temporary screen (for scalers) */
 	SDL_Surface *_tmpscreen2;
 
+	/**
+	 * The palette in the pixel format of the scalers, used to convert a
+	 * paletted game screen straight into _tmpscreen.
+	 */
+	uint32 _paletteMap[256];
+	void updatePaletteMap(uint start, uint num);
+
 	SDL_Surface *_overlayscreen;
 	bool _overlayVisible;
 	Graphics::PixelFormat _overlayFormat;
@@ -230,6 +246,9 @@ protected:
 
 	ScalerProc *_scalerProc;
 	int _scalerType;
+
+	/** Worker threads used to scale large dirty rects in parallel */
+	ScalerWorkerPool _scalerPool;
 	int _transactionMode;
 
 	bool _screenIsLocked;
@@ -242,10 +261,34 @@ protected:
 		MAX_SCALING = 3
 	};
 
+	enum {
+		/** Percentage of the screen above which a full update is forced */
+		kFullUpdatePercentage = 75,
+		/** Number of frames over which the dirty rect statistics are gathered */
+		kDirtyRectStatsFrames = 600
+	};
+
 	// Dirty rect management
 	SDL_Rect _dirtyRectList[NUM_DIRTY_RECT];
 	int _numDirtyRects;
 
+	/**
+	 * Work done by the screen updates, reported (debug level 2) and reset
+	 * every kDirtyRectStatsFrames frames.
+	 */
+	struct DirtyRectStats {
+		uint32 frames;
+		uint32 fullUpdates;
+		uint32 rects;
+		/** Game (or overlay) pixels passed through the scaler */
+		uint32 scaledPixels;
+		/** Hardware screen pixels passed to SDL_UpdateRects */
+		uint32 uploadedPixels;
+	};
+	DirtyRectStats _dirtyRectStats;
+
+	void updateDirtyRectStats();
+
 	struct MousePos {
 		// The mouse position, using either virtual (game) or real
 		// (overlay) coordinates.
@@ -0,0 +1,221 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/graphics/surfacesdl/surfacesdl-scalerpool.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+#include "graphics/scaler/aspect.h"
+
+ScalerWorkerPool::ScalerWorkerPool()
+	: _nextBand(0), _pendingBands(0), _numThreads(0), _shouldQuit(false),
+	  _mutex(0), _workCond(0), _doneCond(0) {
+	memset(&_job, 0, sizeof(_job));
+	memset(_threads, 0, sizeof(_threads));
+}
+
+ScalerWorkerPool::~ScalerWorkerPool() {
+	stop();
+}
+
+void ScalerWorkerPool::start(int numThreads) {
+	stop();
+
+	numThreads = CLIP<int>(numThreads, 0, kMaxThreads);
+	if (!numThreads)
+		return;
+
+	_mutex = SDL_CreateMutex();
+	_workCond = SDL_CreateCond();
+	_doneCond = SDL_CreateCond();
+	_shouldQuit = false;
+	_nextBand = _pendingBands = 0;
+	_job.numBands = 0;
+
+	for (int i = 0; i < numThreads; ++i) {
+		_threads[i] = SDL_CreateThread(workerThreadEntry, this);
+		if (!_threads[i]) {
+			warning("Could not create scaler thread: %s", SDL_GetError());
+			break;
+		}
+		_numThreads++;
+	}
+
+	if (!_numThreads)
+		stop();
+}
+
+void ScalerWorkerPool::stop() {
+	if (_numThreads) {
+		// Signal the workers to end, and wait for them to actually finish.
+		SDL_LockMutex(_mutex);
+		_shouldQuit = true;
+		SDL_CondBroadcast(_workCond);
+		SDL_UnlockMutex(_mutex);
+
+		for (int i = 0; i < _numThreads; ++i) {
+			SDL_WaitThread(_threads[i], NULL);
+			_threads[i] = 0;
+		}
+		_numThreads = 0;
+	}
+
+	if (_mutex) {
+		SDL_DestroyMutex(_mutex);
+		_mutex = 0;
+	}
+	if (_workCond) {
+		SDL_DestroyCond(_workCond);
+		_workCond = 0;
+	}
+	if (_doneCond) {
+		SDL_DestroyCond(_doneCond);
+		_doneCond = 0;
+	}
+}
+
+int ScalerWorkerPool::scaleRect(ScalerProc *scalerProc, int scaleFactor,
+                                const uint8 *srcPtr, uint32 srcPitch,
+                                uint8 *dstPtr, uint32 dstPitch, int width, int height,
+                                int aspectY, int dstX, uint8 *dstBuf) {
+	_job.scalerProc = scalerProc;
+	_job.scaleFactor = scaleFactor;
+	_job.srcPtr = srcPtr;
+	_job.srcPitch = srcPitch;
+	_job.dstPtr = dstPtr;
+	_job.dstPitch = dstPitch;
+	_job.width = width;
+	_job.height = height;
+	_job.aspectY = aspectY;
+	_job.dstX = dstX;
+	_job.dstBuf = dstBuf;
+
+	if (!_numThreads || width * height < kMinParallelPixels) {
+		scaleBand(0, height);
+	} else {
+		// Give every thread, including the calling one, about two bands to
+		// balance the load a bit. Bands are an even number of rows apart,
+		// which keeps the pattern of DotMatrix intact. With aspect ratio
+		// correction they also have to start on a screen row which is a
+		// multiple of 5, since the stretched output of those rows does not
+		// depend on the row above.
+		int bandHeight = height / (2 * (_numThreads + 1));
+		bandHeight = MAX<int>(kMinBandHeight, bandHeight - bandHeight % kMinBandHeight);
+
+		int firstBandHeight = bandHeight;
+		if (aspectY >= 0) {
+			int offset = (5 - aspectY % 5) % 5;
+			if (offset & 1)
+				offset += 5;
+			firstBandHeight += offset;
+		}
+		if (firstBandHeight > height)
+			firstBandHeight = height;
+
+		SDL_LockMutex(_mutex);
+		_job.bandHeight = bandHeight;
+		_job.firstBandHeight = firstBandHeight;
+		_job.numBands = 1 + (height - firstBandHeight + bandHeight - 1) / bandHeight;
+		_nextBand = 0;
+		_pendingBands = _job.numBands;
+		SDL_CondBroadcast(_workCond);
+
+		processBands();
+
+		while (_pendingBands > 0)
+			SDL_CondWait(_doneCond, _mutex);
+		_job.numBands = 0;
+		SDL_UnlockMutex(_mutex);
+	}
+
+#ifdef USE_SCALERS
+	if (aspectY >= 0)
+		return 1 + real2Aspect((aspectY + height) * scaleFactor - 1) - real2Aspect(aspectY * scaleFactor);
+#endif
+	return height * scaleFactor;
+}
+
+void ScalerWorkerPool::processBands() {
+	while (_nextBand < _job.numBands) {
+		const int band = _nextBand++;
+
+		int srcY = 0;
+		int h = _job.firstBandHeight;
+		if (band > 0) {
+			srcY = _job.firstBandHeight + (band - 1) * _job.bandHeight;
+			h = MIN(_job.bandHeight, _job.height - srcY);
+		}
+
+		SDL_UnlockMutex(_mutex);
+		scaleBand(srcY, h);
+		SDL_LockMutex(_mutex);
+
+		if (--_pendingBands == 0)
+			SDL_CondSignal(_doneCond);
+	}
+}
+
+void ScalerWorkerPool::scaleBand(int srcY, int h) {
+	const int scale = _job.scaleFactor;
+	uint8 *dstPtr = _job.dstPtr + srcY * scale * _job.dstPitch;
+
+#ifdef USE_SCALERS
+	if (_job.aspectY >= 0) {
+		const int origDstY = (_job.aspectY + srcY) * scale;
+		const int dstY = real2Aspect(origDstY);
+
+		dstPtr = _job.dstPtr + (dstY - real2Aspect(_job.aspectY * scale)) * _job.dstPitch;
+		_job.scalerProc(_job.srcPtr + srcY * _job.srcPitch, _job.srcPitch, dstPtr, _job.dstPitch, _job.width, h);
+		stretch200To240(_job.dstBuf, _job.dstPitch, _job.width * scale, h * scale, _job.dstX, dstY, origDstY);
+		return;
+	}
+#endif
+
+	_job.scalerProc(_job.srcPtr + srcY * _job.srcPitch, _job.srcPitch, dstPtr, _job.dstPitch, _job.width, h);
+}
+
+void ScalerWorkerPool::workerThread() {
+	SDL_LockMutex(_mutex);
+	while (true) {
+		// Wait till there is a band left to scale
+		while (!_shouldQuit && _nextBand >= _job.numBands)
+			SDL_CondWait(_workCond, _mutex);
+
+		if (_shouldQuit)
+			break;
+
+		processBands();
+	}
+	SDL_UnlockMutex(_mutex);
+}
+
+int SDLCALL ScalerWorkerPool::workerThreadEntry(void *arg) {
+	ScalerWorkerPool *pool = (ScalerWorkerPool *)arg;
+	assert(pool);
+	pool->workerThread();
+	return 0;
+}
+
+#endif
@@ -0,0 +1,141 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_GRAPHICS_SURFACESDL_SCALERPOOL_H
+#define BACKENDS_GRAPHICS_SURFACESDL_SCALERPOOL_H
+
+#include "graphics/scaler.h"
+
+#include "backends/platform/sdl/sdl-sys.h"
+
+/**
+ * Pool of worker threads used by the SDL graphics manager to scale large
+ * dirty rects in parallel.
+ *
+ * A rect is cut into horizontal bands which are scaled (and optionally
+ * aspect corrected) independently. Scalers read one row above and below
+ * every source row, so neighbouring bands share those rows of the source
+ * surface; since the source is only read while scaling, no copying of the
+ * overlap rows is needed. The calling thread processes bands as well and
+ * returns once every band of the rect has been written.
+ */
+class ScalerWorkerPool {
+public:
+	enum {
+		kMaxThreads = 8
+	};
+
+	ScalerWorkerPool();
+	~ScalerWorkerPool();
+
+	/**
+	 * Start numThreads worker threads. Passing 0 leaves the pool stopped,
+	 * in which case scaleRect() processes all bands on the calling thread.
+	 */
+	void start(int numThreads);
+
+	/**
+	 * Stop all worker threads and wait for them to finish.
+	 */
+	void stop();
+
+	/** Number of worker threads currently running. */
+	int getNumThreads() const { return _numThreads; }
+
+	/**
+	 * Scale a rect, splitting it into bands processed by all workers.
+	 *
+	 * The arguments match those of ScalerProc, with the addition of the
+	 * scale factor (needed to locate the destination of each band) and the
+	 * aspect ratio correction parameters.
+	 *
+	 * @param aspectY	When >= 0, the bands are additionally stretched by
+	 *					stretch200To240(). aspectY is the unscaled screen y
+	 *					coordinate of the first row of the rect and dstPtr
+	 *					must point to the aspect corrected position of
+	 *					that row. Bands then start on rows which
+	 *					stretch200To240() never interpolates from above, so
+	 *					they can be stretched independently.
+	 * @param dstX		Destination x coordinate of the rect in pixels, used
+	 *					for aspect ratio correction only.
+	 * @param dstBuf	Start of the destination surface, used for aspect
+	 *					ratio correction only.
+	 * @return			The number of destination rows written.
+	 */
+	int scaleRect(ScalerProc *scalerProc, int scaleFactor,
+	               const uint8 *srcPtr, uint32 srcPitch,
+	               uint8 *dstPtr, uint32 dstPitch, int width, int height,
+	               int aspectY = -1, int dstX = 0, uint8 *dstBuf = 0);
+
+private:
+	enum {
+		/** Minimal height of a band in source rows, band heights are multiples of it */
+		kMinBandHeight = 10,
+		/** Rects with fewer source pixels are always scaled in one go */
+		kMinParallelPixels = 64 * 64
+	};
+
+	struct Job {
+		ScalerProc *scalerProc;
+		int scaleFactor;
+		const uint8 *srcPtr;
+		uint32 srcPitch;
+		uint8 *dstPtr;
+		uint32 dstPitch;
+		int width, height;
+		int aspectY, dstX;
+		uint8 *dstBuf;
+
+		int bandHeight;
+		int firstBandHeight;
+		int numBands;
+	};
+
+	Job _job;
+	int _nextBand;
+	int _pendingBands;
+
+	int _numThreads;
+	bool _shouldQuit;
+
+	SDL_Thread *_threads[kMaxThreads];
+	SDL_mutex *_mutex;
+	SDL_cond *_workCond;
+	SDL_cond *_doneCond;
+
+	/**
+	 * Process bands of the current job until none are left. Must be called
+	 * with _mutex held, returns with _mutex held.
+	 */
+	void processBands();
+
+	/**
+	 * Scale (and aspect correct) h source rows of the current job, starting
+	 * at source row srcY of the rect.
+	 */
+	void scaleBand(int srcY, int h);
+
+	void workerThread();
+	static int SDLCALL workerThreadEntry(void *arg);
+};
+
+#endif
@@ -51,6 +51,9 @@ WINCESdlGraphicsManager::WINCESdlGraphicsManager(SdlEventSource *sdlEventSource)
 	  _mouseBackupOld(NULL), _mouseBackupDim(0), _mouseBackupToolbar(NULL),
 	  _usesEmulatedMouse(false), _forceHideMouse(false), _freeLook(false),
 	  _hasfocus(true), _zoomUp(false), _zoomDown(false) {
+	// The screen updates here only handle 16bpp
+	_trueColorScaling = false;
+
 	memset(&_mouseCurState, 0, sizeof(_mouseCurState));
 	if (_isSmartphone) {
 		_mouseCurState.x = 20;
@@ -65,10 +65,12 @@ MODULE_OBJS += \
 	events/sdl/sdl-events.o \
 	graphics/sdl/sdl-graphics.o \
 	graphics/surfacesdl/surfacesdl-graphics.o \
+	graphics/surfacesdl/surfacesdl-scalerpool.o \
 	mixer/doublebuffersdl/doublebuffersdl-mixer.o \
 	mixer/sdl/sdl-mixer.o \
 	mutex/sdl/sdl-mutex.o \
 	plugins/sdl/sdl-provider.o \
+	saves/sdl/sdl-saves.o \
 	timer/sdl/sdl-timer.o
 	
 # SDL 1.3 removed audio CD support
@@ -35,6 +35,7 @@
 #include "common/textconsole.h"
 
 #include "backends/saves/default/default-saves.h"
+#include "backends/saves/sdl/sdl-saves.h"
 
 // Audio CD support was removed with SDL 1.3
 #if SDL_VERSION_ATLEAST(1, 3, 0)
@@ -186,8 +187,11 @@ void OSystem_SDL::initBackend() {
 		}
 	}
 
-	if (_savefileManager == 0)
-		_savefileManager = new DefaultSaveFileManager();
+	if (_savefileManager == 0) {
+		DefaultSaveFileManager *saveFileManager = new DefaultSaveFileManager();
+		saveFileManager->setWriter(new SdlSaveFileWriter());
+		_savefileManager = saveFileManager;
+	}
 
 	if (_mixerManager == 0) {
 		_mixerManager = new SdlMixerManager();
@@ -39,6 +39,7 @@
 
 #include "backends/platform/sdl/win32/win32.h"
 #include "backends/saves/windows/windows-saves.h"
+#include "backends/saves/sdl/sdl-saves.h"
 #include "backends/fs/windows/windows-fs-factory.h"
 #include "backends/taskbar/win32/win32-taskbar.h"
 
@@ -76,8 +77,11 @@ void OSystem_Win32::initBackend() {
 	}
 
 	// Create the savefile manager
-	if (_savefileManager == 0)
-		_savefileManager = new WindowsSaveFileManager();
+	if (_savefileManager == 0) {
+		WindowsSaveFileManager *saveFileManager = new WindowsSaveFileManager();
+		saveFileManager->setWriter(new SdlSaveFileWriter());
+		_savefileManager = saveFileManager;
+	}
 
 	// Invoke parent implementation of this method
 	OSystem_SDL::initBackend();
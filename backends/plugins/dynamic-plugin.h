@@ -24,6 +24,7 @@
 #define BACKENDS_PLUGINS_DYNAMICPLUGIN_H
 
 #include "base/plugins.h"
+#include "common/debug.h"
 #include "common/textconsole.h"
 
 
@@ -37,9 +38,21 @@ protected:
 
 	const Common::String _filename;
 
+	uint32 _codeSize, _dataSize;
+
+	/**
+	 * Remember the sizes of the code and data which the loaded plugin file
+	 * takes in memory.
+	 */
+	void setMappedSize(uint32 codeSize, uint32 dataSize) {
+		_codeSize = codeSize;
+		_dataSize = dataSize;
+		debug(1, "Plugin '%s' takes %d bytes of code and %d bytes of data", _filename.c_str(), codeSize, dataSize);
+	}
+
 public:
 	DynamicPlugin(const Common::String &filename) :
-		_filename(filename) {}
+		_filename(filename), _codeSize(0), _dataSize(0) {}
 
 	virtual bool loadPlugin() {
 		// Validate the plugin API version
@@ -99,11 +112,17 @@ public:
 
 	virtual void unloadPlugin() {
 		delete _pluginObject;
+		_pluginObject = 0;
+		_codeSize = _dataSize = 0;
 	}
 
 	virtual const char *getFileName() const {
 		return _filename.c_str();
 	}
+
+	virtual uint32 getMappedSize() const {
+		return _codeSize + _dataSize;
+	}
 };
 
 #endif
@@ -45,7 +45,10 @@ DLObject::DLObject() :
 	_symbol_cnt(0),
 	_symtab_sect(-1),
 	_dtors_start(0),
-	_dtors_end(0) {
+	_dtors_end(0),
+	_textSize(0),
+	_dataSize(0),
+	_bssSize(0) {
 }
 
 DLObject::~DLObject() {
@@ -298,6 +301,23 @@ bool DLObject::loadStringTable(Elf32_Shdr *shdr) {
 	return true;
 }
 
+// Sum up the sizes of the sections which occupy memory, by kind
+void DLObject::measureSections(Elf32_Ehdr *ehdr, Elf32_Shdr *shdr) {
+	_textSize = _dataSize = _bssSize = 0;
+
+	for (uint32 i = 0; i < ehdr->e_shnum; i++) {
+		if (!(shdr[i].sh_flags & SHF_ALLOC))
+			continue;
+
+		if (shdr[i].sh_flags & SHF_EXECINSTR)
+			_textSize += shdr[i].sh_size;
+		else if (shdr[i].sh_type == SHT_NOBITS)
+			_bssSize += shdr[i].sh_size;
+		else
+			_dataSize += shdr[i].sh_size;
+	}
+}
+
 void DLObject::relocateSymbols(ptrdiff_t offset) {
 	// Loop over symbols, add relocation offset
 	Elf32_Sym *s = _symtab;
@@ -381,6 +401,8 @@ bool DLObject::load() {
 	if (!shdr)
 		return false;
 
+	measureSections(&ehdr, shdr);
+
 	_symtab_sect = loadSymbolTable(&ehdr, shdr);
 	if (_symtab_sect < 0) {
 		free(shdr);
@@ -402,6 +424,7 @@ bool DLObject::load() {
 		return false;
 	}
 
+	free(shdr);
 	return true;
 }
 
@@ -57,6 +57,8 @@ protected:
 	int32 _symtab_sect;
 	void *_dtors_start, *_dtors_end;
 
+	uint32 _textSize, _dataSize, _bssSize;
+
 	virtual void unload();
 	bool load();
 
@@ -67,6 +69,7 @@ protected:
 	int findSymbolTableSection(Elf32_Ehdr *ehdr, Elf32_Shdr *shdr);
 	int loadSymbolTable(Elf32_Ehdr *ehdr, Elf32_Shdr *shdr);
 	bool loadStringTable(Elf32_Shdr *shdr);
+	void measureSections(Elf32_Ehdr *ehdr, Elf32_Shdr *shdr);
 	virtual void relocateSymbols(ptrdiff_t offset);
 
 	// architecture specific
@@ -97,6 +100,11 @@ public:
 	bool close();
 	void *symbol(const char *name);
 	void discardSymtab();
+
+	/** Sizes of the code, initialized data and bss sections of the plugin. */
+	uint32 getTextSize() const { return _textSize; }
+	uint32 getDataSize() const { return _dataSize; }
+	uint32 getBssSize() const { return _bssSize; }
 };
 
 #endif /* defined(DYNAMIC_MODULES) && defined(USE_ELF_LOADER) */
@@ -135,6 +135,8 @@ bool ELFPlugin::loadPlugin() {
 	}
 
 	bool ret = DynamicPlugin::loadPlugin();
+	if (ret)
+		setMappedSize(_dlHandle->getTextSize(), _dlHandle->getDataSize() + _dlHandle->getBssSize());
 
 #ifdef ELF_LOADER_CXA_ATEXIT
 	if (ret) {
@@ -163,11 +165,23 @@ void ELFPlugin::unloadPlugin() {
 		}
 #endif
 
+		const uint32 size = _dlHandle->getTextSize() + _dlHandle->getDataSize() + _dlHandle->getBssSize();
+
 		if (!_dlHandle->close())
 			warning("elfloader: Failed unloading plugin '%s'", _filename.c_str());
 
 		delete _dlHandle;
 		_dlHandle = 0;
+
+		debug(1, "elfloader: Unloaded plugin '%s', freeing %d bytes", _filename.c_str(), size);
+
+#if defined(UNCACHED_PLUGINS) && !defined(ELF_NO_MEM_MANAGER)
+		// Only one plugin is in memory at a time, so nothing may be left
+		// on the plugin heap now.
+		if (ELFMemMan.getAllocatedSize())
+			warning("elfloader: %d bytes of the plugin heap still in use after unloading '%s'",
+					ELFMemMan.getAllocatedSize(), _filename.c_str());
+#endif
 	}
 }
 
@@ -50,6 +50,9 @@ public:
 	void *pluginAllocate(uint32 align, uint32 size);
 	void pluginDeallocate(void *ptr);
 
+	/** Number of bytes currently allocated on the plugin heap. */
+	uint32 getAllocatedSize() const { return _bytesAllocated; }
+
 private:
    friend class Common::Singleton<ELFMemoryManager>;
 
@@ -30,6 +30,64 @@
 
 #include <dlfcn.h>
 
+// dl_iterate_phdr() is a GNU extension, which uClibc doesn't always have
+#if defined(__GLIBC__) && !defined(__UCLIBC__)
+#define HAVE_DL_ITERATE_PHDR
+#include <link.h>
+#endif
+
+#ifdef HAVE_DL_ITERATE_PHDR
+
+struct SharedObjectSize {
+	const void *address;
+	uint32 codeSize, dataSize;
+};
+
+static int findSharedObjectSize(struct dl_phdr_info *info, size_t, void *data) {
+	SharedObjectSize *size = (SharedObjectSize *)data;
+	const ElfW(Addr) address = (ElfW(Addr))size->address;
+	bool found = false;
+	uint32 codeSize = 0, dataSize = 0;
+
+	for (int i = 0; i < info->dlpi_phnum; i++) {
+		const ElfW(Phdr) &phdr = info->dlpi_phdr[i];
+		if (phdr.p_type != PT_LOAD)
+			continue;
+
+		const ElfW(Addr) start = info->dlpi_addr + phdr.p_vaddr;
+		if (address >= start && address < start + phdr.p_memsz)
+			found = true;
+
+		if (phdr.p_flags & PF_X)
+			codeSize += phdr.p_memsz;
+		else
+			dataSize += phdr.p_memsz;
+	}
+
+	if (!found)
+		return 0;
+
+	size->codeSize = codeSize;
+	size->dataSize = dataSize;
+	return 1;
+}
+
+#endif
+
+bool getSharedObjectSize(const void *address, uint32 &codeSize, uint32 &dataSize) {
+#ifdef HAVE_DL_ITERATE_PHDR
+	SharedObjectSize size = { address, 0, 0 };
+	if (!dl_iterate_phdr(findSharedObjectSize, &size))
+		return false;
+
+	codeSize = size.codeSize;
+	dataSize = size.dataSize;
+	return true;
+#else
+	return false;
+#endif
+}
+
 
 class POSIXPlugin : public DynamicPlugin {
 protected:
@@ -54,6 +112,11 @@ public:
 	POSIXPlugin(const Common::String &filename)
 		: DynamicPlugin(filename), _dlHandle(0) {}
 
+	~POSIXPlugin() {
+		if (_dlHandle)
+			unloadPlugin();
+	}
+
 	bool loadPlugin() {
 		assert(!_dlHandle);
 		_dlHandle = dlopen(_filename.c_str(), RTLD_LAZY);
@@ -63,7 +126,13 @@ public:
 			return false;
 		}
 
-		return DynamicPlugin::loadPlugin();
+		if (!DynamicPlugin::loadPlugin())
+			return false;
+
+		uint32 codeSize, dataSize;
+		if (getSharedObjectSize(dlsym(_dlHandle, "PLUGIN_getObject"), codeSize, dataSize))
+			setMappedSize(codeSize, dataSize);
+		return true;
 	}
 
 	void unloadPlugin() {
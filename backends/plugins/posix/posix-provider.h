@@ -32,6 +32,14 @@ protected:
 	Plugin *createPlugin(const Common::FSNode &node) const;
 };
 
+/**
+ * Get the sizes of the code and data segments which the dynamic linker
+ * mapped for the shared object containing the given address.
+ *
+ * @return false if the sizes are not available on this system
+ */
+bool getSharedObjectSize(const void *address, uint32 &codeSize, uint32 &dataSize);
+
 #endif // defined(DYNAMIC_MODULES) && defined(POSIX)
 
 #endif
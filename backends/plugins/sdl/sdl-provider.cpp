@@ -28,6 +28,12 @@
 #include "backends/plugins/dynamic-plugin.h"
 #include "common/fs.h"
 
+#if defined(POSIX)
+#include "backends/plugins/posix/posix-provider.h"
+#elif defined(_WIN32)
+#include "backends/plugins/win32/win32-provider.h"
+#endif
+
 #include "backends/platform/sdl/sdl-sys.h"
 
 class SDLPlugin : public DynamicPlugin {
@@ -53,6 +59,11 @@ public:
 	SDLPlugin(const Common::String &filename)
 		: DynamicPlugin(filename), _dlHandle(0) {}
 
+	~SDLPlugin() {
+		if (_dlHandle)
+			unloadPlugin();
+	}
+
 	bool loadPlugin() {
 		assert(!_dlHandle);
 		_dlHandle = SDL_LoadObject(_filename.c_str());
@@ -62,7 +73,19 @@ public:
 			return false;
 		}
 
-		return DynamicPlugin::loadPlugin();
+		if (!DynamicPlugin::loadPlugin())
+			return false;
+
+		// SDL uses the dynamic linker of the system
+		uint32 codeSize, dataSize;
+#if defined(POSIX)
+		if (getSharedObjectSize(SDL_LoadFunction(_dlHandle, "PLUGIN_getObject"), codeSize, dataSize))
+			setMappedSize(codeSize, dataSize);
+#elif defined(_WIN32)
+		if (getModuleSize(_dlHandle, codeSize, dataSize))
+			setMappedSize(codeSize, dataSize);
+#endif
+		return true;
 	}
 
 	void unloadPlugin() {
@@ -65,6 +65,11 @@ public:
 	Win32Plugin(const Common::String &filename)
 		: DynamicPlugin(filename), _dlHandle(0) {}
 
+	~Win32Plugin() {
+		if (_dlHandle)
+			unloadPlugin();
+	}
+
 	bool loadPlugin() {
 		assert(!_dlHandle);
 #ifndef _WIN32_WCE
@@ -80,7 +85,13 @@ public:
 			debug(1, "Success loading plugin '%s', handle %08X", _filename.c_str(), (uint32) _dlHandle);
 		}
 
-		return DynamicPlugin::loadPlugin();
+		if (!DynamicPlugin::loadPlugin())
+			return false;
+
+		uint32 codeSize, dataSize;
+		if (getModuleSize(_dlHandle, codeSize, dataSize))
+			setMappedSize(codeSize, dataSize);
+		return true;
 	}
 
 	void unloadPlugin() {
@@ -96,6 +107,32 @@ public:
 };
 
 
+bool getModuleSize(const void *module, uint32 &codeSize, uint32 &dataSize) {
+#ifndef _WIN32_WCE
+	// The module handle is the address the module was mapped at
+	const IMAGE_DOS_HEADER *dosHeader = (const IMAGE_DOS_HEADER *)module;
+	if (dosHeader->e_magic != IMAGE_DOS_SIGNATURE)
+		return false;
+
+	const IMAGE_NT_HEADERS *ntHeaders = (const IMAGE_NT_HEADERS *)((const byte *)module + dosHeader->e_lfanew);
+	if (ntHeaders->Signature != IMAGE_NT_SIGNATURE)
+		return false;
+
+	codeSize = dataSize = 0;
+	const IMAGE_SECTION_HEADER *section = IMAGE_FIRST_SECTION(ntHeaders);
+	for (uint i = 0; i < ntHeaders->FileHeader.NumberOfSections; i++, section++) {
+		if (section->Characteristics & IMAGE_SCN_CNT_CODE)
+			codeSize += section->Misc.VirtualSize;
+		else
+			dataSize += section->Misc.VirtualSize;
+	}
+	return true;
+#else
+	// On Windows CE, module handles are not addresses
+	return false;
+#endif
+}
+
 Plugin* Win32PluginProvider::createPlugin(const Common::FSNode &node) const {
 	return new Win32Plugin(node.getPath());
 }
@@ -34,6 +34,14 @@ protected:
 	bool isPluginFilename(const Common::FSNode &node) const;
 };
 
+/**
+ * Get the sizes of the code and data sections of a loaded module, from the
+ * PE headers mapped at its start.
+ *
+ * @return false if the sizes are not available on this system
+ */
+bool getModuleSize(const void *module, uint32 &codeSize, uint32 &dataSize);
+
 #endif // defined(DYNAMIC_MODULES) && defined(_WIN32)
 
 #endif
@@ -24,26 +24,369 @@
 
 #if !defined(DISABLE_DEFAULT_SAVEFILEMANAGER)
 
+#if defined(WIN32) && !defined(_WIN32_WCE)
+#if defined(ARRAYSIZE)
+#undef ARRAYSIZE
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>	// for MoveFileEx()
+#undef ARRAYSIZE // winnt.h defines ARRAYSIZE, but we want our own one...
+#endif
+
 #include "backends/saves/default/default-saves.h"
 
+#include "common/array.h"
 #include "common/savefile.h"
 #include "common/util.h"
 #include "common/fs.h"
 #include "common/archive.h"
 #include "common/config-manager.h"
+#include "common/md5.h"
+#include "common/memstream.h"
+#include "common/textconsole.h"
 #include "common/zlib.h"
 
 #ifndef _WIN32_WCE
-#include <errno.h>	// for removeSavefile()
+#include <errno.h>	// for removeSavefile() and replaceSaveFile()
 #endif
 
-DefaultSaveFileManager::DefaultSaveFileManager() {
+PendingSaveFile::PendingSaveFile(const Common::String &path_, byte *data_, uint32 size_, bool compress_)
+	: data(data_), size(size_), compress(compress_), next(0) {
+	// Copy the paths, so that they share no reference count with strings
+	// of the engine thread
+	const uint32 length = path_.size();
+	path = (char *)malloc(length + 1);
+	memcpy(path, path_.c_str(), length + 1);
+	tempPath = (char *)malloc(length + 5);
+	memcpy(tempPath, path_.c_str(), length);
+	memcpy(tempPath + length, ".tmp", 5);
+}
+
+PendingSaveFile::~PendingSaveFile() {
+	free(path);
+	free(tempPath);
+	free(data);
+	delete next;
+}
+
+bool SaveFileWriter::write(PendingSaveFile *save) {
+	bool success = store(*save);
+	if (success && save->next)
+		success = store(*save->next);
+	delete save;
+	return success;
+}
+
+bool SaveFileWriter::store(const PendingSaveFile &save) {
+	Common::WriteStream *stream = Common::FSNode(save.tempPath).createWriteStream();
+	if (!stream)
+		return false;
+
+	Common::WriteStream *file = save.compress ? Common::wrapCompressedWriteStream(stream) : stream;
+	file->write(save.data, save.size);
+	file->finalize();
+	const bool success = !file->err();
+	delete file;
+
+	if (!success) {
+		remove(save.tempPath);
+		return false;
+	}
+
+	return replaceSaveFile(save);
+}
+
+bool SaveFileWriter::replaceSaveFile(const PendingSaveFile &save) {
+#if defined(WIN32) && !defined(_WIN32_WCE)
+	// Replaces an existing savefile in one step
+	if (MoveFileEx(save.tempPath, save.path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+		return true;
+#else
+	if (rename(save.tempPath, save.path) == 0)
+		return true;
+
+#ifndef _WIN32_WCE
+	// Not every system lets rename() replace an existing file. Only then
+	// the old savefile is removed first, and from there on the temporary
+	// file is the only copy of the savefile, so it is kept if the rename
+	// fails again.
+	if (errno == EEXIST && remove(save.path) == 0)
+		return rename(save.tempPath, save.path) == 0;
+#endif
+#endif
+
+	// The old savefile is still there
+	remove(save.tempPath);
+	return false;
+}
+
+namespace {
+
+enum {
+	kDeltaTag = MKTAG('S', 'V', 'D', 'L'),
+	kDeltaVersion = 1,
+	kDeltaHeaderSize = 36,
+	kDeltaBlockSize = 64
+};
+
+Common::String getDeltaBaseName(const Common::String &filename) {
+	return "." + filename + ".base";
+}
+
+void dropDeltaBase(SaveFileDeltaMap &bases, const Common::String &path) {
+	SaveFileDeltaMap::iterator base = bases.find(path);
+	if (base != bases.end()) {
+		free(base->_value.data);
+		bases.erase(base);
+	}
+}
+
+void clearDeltaBases(SaveFileDeltaMap &bases) {
+	for (SaveFileDeltaMap::iterator i = bases.begin(); i != bases.end(); ++i)
+		free(i->_value.data);
+	bases.clear();
+}
+
+/**
+ * Encode the data as the blocks which differ from the base.
+ *
+ * The delta starts with the tag, the version, the size and the MD5 of the
+ * base, the size of the data and the number of runs. Each run is its
+ * offset and its length, followed by the data. Everything outside the runs
+ * is the same as in the base.
+ *
+ * @return	the delta, or 0 if the data differs too much from the base
+ */
+byte *encodeDelta(const SaveFileDeltaBase &base, const byte *data, uint32 size, uint32 &deltaSize) {
+	// Offsets and lengths of the changed runs
+	Common::Array<uint32> runs;
+	uint32 changed = 0;
+
+	for (uint32 pos = 0; pos < size; pos += kDeltaBlockSize) {
+		const uint32 length = MIN<uint32>(kDeltaBlockSize, size - pos);
+		if (pos + length <= base.size && !memcmp(data + pos, base.data + pos, length))
+			continue;
+
+		if (!runs.empty() && runs[runs.size() - 2] + runs.back() == pos)
+			runs.back() += length;
+		else {
+			runs.push_back(pos);
+			runs.push_back(length);
+		}
+		changed += length;
+	}
+
+	// Larger deltas would only grow with each version, a new base is
+	// cheaper then
+	if (changed > size / 2)
+		return 0;
+
+	deltaSize = kDeltaHeaderSize + runs.size() * 4 + changed;
+	byte *delta = (byte *)malloc(deltaSize);
+	if (!delta)
+		return 0;
+
+	WRITE_BE_UINT32(delta, kDeltaTag);
+	WRITE_LE_UINT32(delta + 4, kDeltaVersion);
+	WRITE_LE_UINT32(delta + 8, base.size);
+	memcpy(delta + 12, base.md5, 16);
+	WRITE_LE_UINT32(delta + 28, size);
+	WRITE_LE_UINT32(delta + 32, runs.size() / 2);
+
+	byte *out = delta + kDeltaHeaderSize;
+	for (uint i = 0; i < runs.size(); i += 2) {
+		WRITE_LE_UINT32(out, runs[i]);
+		WRITE_LE_UINT32(out + 4, runs[i + 1]);
+		memcpy(out + 8, data + runs[i], runs[i + 1]);
+		out += 8 + runs[i + 1];
+	}
+
+	return delta;
+}
+
+/**
+ * Put the data of a delta savefile back together with its base file.
+ * Takes ownership of the delta stream, whose tag was already read.
+ *
+ * @return	the data, or 0 if the base file is missing or does not match
+ */
+Common::SeekableReadStream *decodeDelta(Common::SeekableReadStream *delta, const Common::FSNode &baseFile) {
+	const uint32 version = delta->readUint32LE();
+	const uint32 baseSize = delta->readUint32LE();
+	uint8 baseMD5[16];
+	delta->read(baseMD5, 16);
+	const uint32 size = delta->readUint32LE();
+	uint32 runCount = delta->readUint32LE();
+
+	Common::SeekableReadStream *base = 0;
+	if (version == kDeltaVersion && baseFile.exists())
+		base = Common::wrapCompressedReadStream(baseFile.createReadStream());
+
+	byte *data = 0;
+	bool success = base && base->size() == (int32)baseSize;
+	if (success) {
+		data = (byte *)malloc(MAX(size, baseSize));
+		success = data && base->read(data, baseSize) == baseSize;
+	}
+
+	if (success) {
+		uint8 md5[16];
+		Common::MemoryReadStream baseData(data, baseSize);
+		Common::computeStreamMD5(baseData, md5);
+		success = !memcmp(md5, baseMD5, 16);
+	}
+
+	if (success) {
+		if (size > baseSize)
+			memset(data + baseSize, 0, size - baseSize);
+
+		for (; runCount > 0 && success; runCount--) {
+			const uint32 offset = delta->readUint32LE();
+			const uint32 length = delta->readUint32LE();
+			success = !delta->err() && !delta->eos() && offset <= size && length <= size - offset &&
+				delta->read(data + offset, length) == length;
+		}
+	}
+
+	delete base;
+	delete delta;
+
+	if (!success) {
+		free(data);
+		return 0;
+	}
+
+	return new Common::MemoryReadStream(data, size, DisposeAfterUse::YES);
 }
 
-DefaultSaveFileManager::DefaultSaveFileManager(const Common::String &defaultSavepath) {
+/**
+ * Collects the data written by the engine in memory, and hands it to the
+ * SaveFileWriter once it is finalized.
+ */
+class SaveFileWriteStream : public Common::WriteStream {
+public:
+	SaveFileWriteStream(SaveFileWriter *writer, uint32 &changeCount, const Common::String &path, bool compress,
+		SaveFileDeltaMap *deltaBases = 0, const Common::String &basePath = Common::String())
+		: _writer(writer), _changeCount(changeCount), _path(path), _compress(compress), _deltaBases(deltaBases), _basePath(basePath),
+		_data(new Common::MemoryWriteStreamDynamic()), _err(false) {
+	}
+
+	~SaveFileWriteStream() {
+		finalize();
+	}
+
+	uint32 write(const void *dataPtr, uint32 dataSize) {
+		if (!_data) {
+			_err = true;
+			return 0;
+		}
+
+		return _data->write(dataPtr, dataSize);
+	}
+
+	bool err() const { return _err; }
+	void clearErr() { _err = false; }
+
+	void finalize() {
+		if (!_data)
+			return;
+
+		// The pending savefile takes over the memory
+		PendingSaveFile *save = new PendingSaveFile(_path, _data->getData(), _data->size(), _compress);
+		delete _data;
+		_data = 0;
+		_changeCount++;
+
+		if (_deltaBases)
+			save = makeDelta(save);
+
+		if (!_writer->write(save)) {
+			warning("Could not write savefile '%s'", _path.c_str());
+			_err = true;
+
+			// The base file may not have been stored
+			if (_deltaBases)
+				dropDeltaBase(*_deltaBases, _path);
+		}
+	}
+
+private:
+	SaveFileWriter *_writer;
+	uint32 &_changeCount;
+	Common::String _path;
+	bool _compress;
+	/** The bases of the delta savefiles, or 0 to always store the complete data */
+	SaveFileDeltaMap *_deltaBases;
+	Common::String _basePath;
+	Common::MemoryWriteStreamDynamic *_data;
+	bool _err;
+
+	/**
+	 * Turn the complete savefile into a delta against its base. Without a
+	 * base, or if the data differs too much from it, the complete savefile
+	 * is stored and becomes the new base. The base file is only stored
+	 * after the savefile, so that the savefile on the disk is never a delta
+	 * against a different base.
+	 */
+	PendingSaveFile *makeDelta(PendingSaveFile *save) {
+		SaveFileDeltaMap::iterator base = _deltaBases->find(_path);
+		if (base != _deltaBases->end()) {
+			uint32 deltaSize;
+			byte *delta = encodeDelta(base->_value, save->data, save->size, deltaSize);
+			if (delta) {
+				free(save->data);
+				save->data = delta;
+				save->size = deltaSize;
+				return save;
+			}
+		}
+
+		byte *baseData = (byte *)malloc(save->size);
+		byte *baseFileData = (byte *)malloc(save->size);
+		if (!baseData || !baseFileData) {
+			free(baseData);
+			free(baseFileData);
+			dropDeltaBase(*_deltaBases, _path);
+			return save;
+		}
+
+		memcpy(baseData, save->data, save->size);
+		memcpy(baseFileData, save->data, save->size);
+		save->next = new PendingSaveFile(_basePath, baseFileData, save->size, _compress);
+
+		dropDeltaBase(*_deltaBases, _path);
+		SaveFileDeltaBase &newBase = (*_deltaBases)[_path];
+		newBase.data = baseData;
+		newBase.size = save->size;
+		Common::MemoryReadStream stream(baseData, save->size);
+		Common::computeStreamMD5(stream, newBase.md5);
+
+		return save;
+	}
+};
+
+} // End of anonymous namespace
+
+// The change count starts at 1, 0 means that changes aren't tracked
+DefaultSaveFileManager::DefaultSaveFileManager() : _writer(new SaveFileWriter()), _changeCount(1) {
+}
+
+DefaultSaveFileManager::DefaultSaveFileManager(const Common::String &defaultSavepath) : _writer(new SaveFileWriter()), _changeCount(1) {
 	ConfMan.registerDefault("savepath", defaultSavepath);
 }
 
+DefaultSaveFileManager::~DefaultSaveFileManager() {
+	// Writers store their pending savefiles before they are gone
+	delete _writer;
+
+	clearDeltaBases(_deltaBases);
+}
+
+void DefaultSaveFileManager::setWriter(SaveFileWriter *writer) {
+	delete _writer;
+	_writer = writer;
+}
+
 
 void DefaultSaveFileManager::checkPath(const Common::FSNode &dir) {
 	clearError();
@@ -54,11 +397,24 @@ void DefaultSaveFileManager::checkPath(const Common::FSNode &dir) {
 	}
 }
 
+void DefaultSaveFileManager::checkWriter() {
+	if (_writer->reportFailures() > 0) {
+		setError(Common::kWritingFailed, "Could not write savefiles");
+
+		// Base files may not have been stored, so start over with new ones
+		clearDeltaBases(_deltaBases);
+	}
+}
+
 Common::StringArray DefaultSaveFileManager::listSavefiles(const Common::String &pattern) {
+	// Savefiles being written have to be complete first
+	_writer->flush();
+
 	Common::String savePathName = getSavePath();
 	checkPath(Common::FSNode(savePathName));
 	if (getError().getCode() != Common::kNoError)
 		return Common::StringArray();
+	checkWriter();
 
 	// recreate FSNode since checkPath may have changed/created the directory
 	Common::FSNode savePath(savePathName);
@@ -70,6 +426,10 @@ Common::StringArray DefaultSaveFileManager::listSavefiles(const Common::String &
 
 	if (dir.listMatchingMembers(savefiles, search) > 0) {
 		for (Common::ArchiveMemberList::const_iterator file = savefiles.begin(); file != savefiles.end(); ++file) {
+			// Skip the base files of delta savefiles and the savegame indexes
+			// of the launcher
+			if ((*file)->getName().matchString(".*.base") || (*file)->getName().matchString(".*.index"))
+				continue;
 			results.push_back((*file)->getName());
 		}
 	}
@@ -78,11 +438,15 @@ Common::StringArray DefaultSaveFileManager::listSavefiles(const Common::String &
 }
 
 Common::InSaveFile *DefaultSaveFileManager::openForLoading(const Common::String &filename) {
+	// Savefiles being written have to be complete first
+	_writer->flush();
+
 	// Ensure that the savepath is valid. If not, generate an appropriate error.
 	Common::String savePathName = getSavePath();
 	checkPath(Common::FSNode(savePathName));
 	if (getError().getCode() != Common::kNoError)
 		return 0;
+	checkWriter();
 
 	// recreate FSNode since checkPath may have changed/created the directory
 	Common::FSNode savePath(savePathName);
@@ -92,34 +456,66 @@ Common::InSaveFile *DefaultSaveFileManager::openForLoading(const Common::String
 		return 0;
 
 	// Open the file for reading
-	Common::SeekableReadStream *sf = file.createReadStream();
+	Common::SeekableReadStream *sf = Common::wrapCompressedReadStream(file.createReadStream());
+
+	if (sf && sf->size() >= kDeltaHeaderSize) {
+		if (sf->readUint32BE() == kDeltaTag) {
+			sf = decodeDelta(sf, savePath.getChild(getDeltaBaseName(filename)));
+			if (!sf)
+				setError(Common::kReadingFailed, "The base file of the delta savefile '" + filename + "' is missing or does not match");
+			return sf;
+		}
+		sf->seek(0);
+	}
 
-	return Common::wrapCompressedReadStream(sf);
+	return sf;
 }
 
 Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String &filename, bool compress) {
+	return createSaveFile(filename, compress, false);
+}
+
+Common::OutSaveFile *DefaultSaveFileManager::openForSavingDelta(const Common::String &filename, bool compress) {
+	return createSaveFile(filename, compress, true);
+}
+
+Common::OutSaveFile *DefaultSaveFileManager::createSaveFile(const Common::String &filename, bool compress, bool delta) {
 	// Ensure that the savepath is valid. If not, generate an appropriate error.
 	Common::String savePathName = getSavePath();
 	checkPath(Common::FSNode(savePathName));
 	if (getError().getCode() != Common::kNoError)
 		return 0;
+	checkWriter();
 
 	// recreate FSNode since checkPath may have changed/created the directory
 	Common::FSNode savePath(savePathName);
 
+	// The savefile is only created once it has been written completely,
+	// so check now that this can succeed
+	if (!savePath.isWritable()) {
+		setError(Common::kWritePermissionDenied, "Write permission denied: "+savePath.getPath());
+		return 0;
+	}
+
 	Common::FSNode file = savePath.getChild(filename);
 
-	// Open the file for saving
-	Common::WriteStream *sf = file.createWriteStream();
+	if (delta) {
+		Common::FSNode baseFile = savePath.getChild(getDeltaBaseName(filename));
+		return new SaveFileWriteStream(_writer, _changeCount, file.getPath(), compress, &_deltaBases, baseFile.getPath());
+	}
 
-	return compress ? Common::wrapCompressedWriteStream(sf) : sf;
+	return new SaveFileWriteStream(_writer, _changeCount, file.getPath(), compress);
 }
 
 bool DefaultSaveFileManager::removeSavefile(const Common::String &filename) {
+	// Savefiles being written have to be complete first
+	_writer->flush();
+
 	Common::String savePathName = getSavePath();
 	checkPath(Common::FSNode(savePathName));
 	if (getError().getCode() != Common::kNoError)
 		return false;
+	checkWriter();
 
 	// recreate FSNode since checkPath may have changed/created the directory
 	Common::FSNode savePath(savePathName);
@@ -139,6 +535,13 @@ bool DefaultSaveFileManager::removeSavefile(const Common::String &filename) {
 #endif
 		return false;
 	} else {
+		// A delta savefile leaves its base file behind
+		Common::FSNode baseFile = savePath.getChild(getDeltaBaseName(filename));
+		if (baseFile.exists())
+			remove(baseFile.getPath().c_str());
+		dropDeltaBase(_deltaBases, file.getPath());
+
+		_changeCount++;
 		return true;
 	}
 }
@@ -27,19 +27,132 @@
 #include "common/savefile.h"
 #include "common/str.h"
 #include "common/fs.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/noncopyable.h"
+
+/**
+ * A finalized savefile which still has to be stored: the data written by
+ * the engine and the path of the file it goes to.
+ */
+struct PendingSaveFile : public Common::NonCopyable {
+	PendingSaveFile(const Common::String &path_, byte *data_, uint32 size_, bool compress_);
+	~PendingSaveFile();
+
+	/**
+	 * The paths of the savefile and of the temporary file written first.
+	 * They are plain strings, so that writers can use them on any thread.
+	 */
+	char *path;
+	char *tempPath;
+	byte *data;
+	uint32 size;
+	bool compress;
+
+	/**
+	 * A savefile which is only stored after this one was stored, and
+	 * dropped if this one fails. Deleted together with this one.
+	 */
+	PendingSaveFile *next;
+};
+
+/**
+ * The complete data of a savefile written with openForSavingDelta(). Later
+ * versions of the savefile are stored as the changes against it.
+ */
+struct SaveFileDeltaBase {
+	byte *data;
+	uint32 size;
+	uint8 md5[16];
+};
+
+typedef Common::HashMap<Common::String, SaveFileDeltaBase> SaveFileDeltaMap;
+
+/**
+ * Stores the finalized savefiles of the DefaultSaveFileManager. This one
+ * does so right away on the calling thread. Backends can replace it by one
+ * which stores them on another thread, so that the engine does not wait for
+ * the compression and the disk.
+ */
+class SaveFileWriter {
+public:
+	virtual ~SaveFileWriter() {}
+
+	/**
+	 * Store the savefile and delete it, now or later.
+	 *
+	 * @return	false if the savefile could not be stored. Writers storing
+	 *			it later return true and report failures in reportFailures().
+	 */
+	virtual bool write(PendingSaveFile *save);
+
+	/**
+	 * Wait until all savefiles passed to write() have been stored.
+	 */
+	virtual void flush() {}
+
+	/**
+	 * Warn about the savefiles which could not be stored later, since the
+	 * last call. Only called on the engine thread.
+	 *
+	 * @return	the number of savefiles which could not be stored
+	 */
+	virtual uint reportFailures() { return 0; }
+
+	/**
+	 * Compress the savefile if requested and write it to a temporary file,
+	 * which then replaces the savefile. This way an interrupted save never
+	 * leaves a partly written savefile behind. The file is written through
+	 * a FSNode, so this may only be called on the engine thread.
+	 *
+	 * @return	true on success, false if the savefile could not be written
+	 */
+	static bool store(const PendingSaveFile &save);
+
+protected:
+	/**
+	 * Let the written temporary file replace the savefile. Only uses the C
+	 * library and the Win32 API, so it can be called from any thread.
+	 *
+	 * If the savefile had to be removed before the temporary file could be
+	 * renamed, and the rename still fails, the temporary file is kept as
+	 * the only copy of the new savefile.
+	 *
+	 * @return	true on success, false if the savefile was not replaced
+	 */
+	static bool replaceSaveFile(const PendingSaveFile &save);
+};
 
 /**
  * Provides a default savefile manager implementation for common platforms.
+ *
+ * Savefiles are written to memory and only stored when they are finalized
+ * or deleted, see SaveFileWriter.
+ *
+ * Savefiles opened with openForSavingDelta() are first stored completely,
+ * and a copy of the data is stored as the base file ".<name>.base". Later
+ * versions during the same session are stored as the blocks which differ
+ * from the base, as long as that is less than half of the data.
+ * openForLoading() puts them back together with the base file.
  */
 class DefaultSaveFileManager : public Common::SaveFileManager {
 public:
 	DefaultSaveFileManager();
 	DefaultSaveFileManager(const Common::String &defaultSavepath);
+	virtual ~DefaultSaveFileManager();
 
 	virtual Common::StringArray listSavefiles(const Common::String &pattern);
 	virtual Common::InSaveFile *openForLoading(const Common::String &filename);
 	virtual Common::OutSaveFile *openForSaving(const Common::String &filename, bool compress = true);
+	virtual Common::OutSaveFile *openForSavingDelta(const Common::String &filename, bool compress = true);
 	virtual bool removeSavefile(const Common::String &filename);
+	virtual uint32 getChangeCount() const { return _changeCount; }
+
+	/**
+	 * Replace the writer storing the finalized savefiles. Takes ownership
+	 * of the writer.
+	 */
+	void setWriter(SaveFileWriter *writer);
 
 protected:
 	/**
@@ -54,6 +167,27 @@ protected:
 	 * Sets the internal error and error message accordingly.
 	 */
 	virtual void checkPath(const Common::FSNode &dir);
+
+	/**
+	 * Reports the savefiles which the writer could not store in the
+	 * background. Sets the internal error accordingly, the requested
+	 * operation still goes ahead.
+	 */
+	void checkWriter();
+
+	/**
+	 * Opens a savefile for openForSaving() and openForSavingDelta().
+	 */
+	Common::OutSaveFile *createSaveFile(const Common::String &filename, bool compress, bool delta);
+
+	SaveFileWriter *_writer;
+	uint32 _changeCount;
+
+	/**
+	 * The bases of the savefiles written with openForSavingDelta() during
+	 * this session, by path. They match the base files on the disk.
+	 */
+	SaveFileDeltaMap _deltaBases;
 };
 
 #endif
@@ -149,4 +149,19 @@ void POSIXSaveFileManager::checkPath(const Common::FSNode &dir) {
 	}
 }
 
+bool POSIXSaveFileManager::getSavefileInfo(const Common::String &filename, uint32 &size, uint32 &modificationTime) {
+	// Savefiles being written have to be complete first
+	_writer->flush();
+
+	const Common::String path = Common::FSNode(getSavePath()).getChild(filename).getPath();
+	struct stat sb;
+
+	if (stat(path.c_str(), &sb) != 0 || !S_ISREG(sb.st_mode))
+		return false;
+
+	size = sb.st_size;
+	modificationTime = sb.st_mtime;
+	return true;
+}
+
 #endif
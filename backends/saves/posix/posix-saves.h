@@ -28,14 +28,17 @@
 #if defined(POSIX) && !defined(DISABLE_DEFAULT_SAVEFILEMANAGER)
 /**
  * Customization of the DefaultSaveFileManager for POSIX platforms.
- * The only two differences are that the default constructor sets
- * up the savepath based on HOME, and that checkPath tries to
- * create the savedir, if missing, via the mkdir() syscall.
+ * The differences are that the default constructor sets up the
+ * savepath based on HOME, that checkPath tries to create the savedir,
+ * if missing, via the mkdir() syscall, and that the size and
+ * modification time of savefiles are taken from stat().
  */
 class POSIXSaveFileManager : public DefaultSaveFileManager {
 public:
 	POSIXSaveFileManager();
 
+	virtual bool getSavefileInfo(const Common::String &filename, uint32 &size, uint32 &modificationTime);
+
 protected:
 	/**
 	 * Checks the given path for read access, existence, etc.
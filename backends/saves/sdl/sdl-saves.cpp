@@ -0,0 +1,179 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// The writer thread writes savefiles with stdio
+#define FORBIDDEN_SYMBOL_EXCEPTION_FILE
+#define FORBIDDEN_SYMBOL_EXCEPTION_fopen
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND) && !defined(DISABLE_DEFAULT_SAVEFILEMANAGER)
+
+#include "backends/saves/sdl/sdl-saves.h"
+#include "backends/fs/stdiostream.h"
+
+#include "common/textconsole.h"
+#include "common/zlib.h"
+
+#if defined(WIN32) && !defined(_WIN32_WCE)
+#include <io.h>	// for _commit()
+#elif defined(POSIX)
+#include <unistd.h>	// for fsync()
+#endif
+
+SdlSaveFileWriter::SdlSaveFileWriter()
+	: _busy(false), _shouldQuit(false), _thread(0), _mutex(0), _workCond(0), _doneCond(0) {
+	_mutex = SDL_CreateMutex();
+	_workCond = SDL_CreateCond();
+	_doneCond = SDL_CreateCond();
+
+	_thread = SDL_CreateThread(writerThreadEntry, this);
+	if (!_thread)
+		warning("Could not create savefile writer thread: %s", SDL_GetError());
+}
+
+SdlSaveFileWriter::~SdlSaveFileWriter() {
+	if (_thread) {
+		// The thread stores what is left in the queue before it ends
+		SDL_LockMutex(_mutex);
+		_shouldQuit = true;
+		SDL_CondSignal(_workCond);
+		SDL_UnlockMutex(_mutex);
+
+		SDL_WaitThread(_thread, NULL);
+		reportFailures();
+	}
+
+	SDL_DestroyMutex(_mutex);
+	SDL_DestroyCond(_workCond);
+	SDL_DestroyCond(_doneCond);
+}
+
+bool SdlSaveFileWriter::write(PendingSaveFile *save) {
+	if (!_thread)
+		return SaveFileWriter::write(save);
+
+	SDL_LockMutex(_mutex);
+	_queue.push_back(save);
+	SDL_CondSignal(_workCond);
+	SDL_UnlockMutex(_mutex);
+
+	return true;
+}
+
+void SdlSaveFileWriter::flush() {
+	if (!_thread)
+		return;
+
+	SDL_LockMutex(_mutex);
+	while (!_queue.empty() || _busy)
+		SDL_CondWait(_doneCond, _mutex);
+	SDL_UnlockMutex(_mutex);
+}
+
+uint SdlSaveFileWriter::reportFailures() {
+	if (!_thread)
+		return 0;
+
+	SDL_LockMutex(_mutex);
+	Common::List<PendingSaveFile *> failed = _failed;
+	_failed.clear();
+	SDL_UnlockMutex(_mutex);
+
+	uint count = 0;
+	for (Common::List<PendingSaveFile *>::iterator i = failed.begin(); i != failed.end(); ++i) {
+		warning("Could not write savefile '%s'", (*i)->path);
+		delete *i;
+		count++;
+	}
+
+	return count;
+}
+
+void SdlSaveFileWriter::writerThread() {
+	SDL_LockMutex(_mutex);
+
+	while (true) {
+		while (_queue.empty() && !_shouldQuit)
+			SDL_CondWait(_workCond, _mutex);
+
+		if (_queue.empty())
+			break;
+
+		PendingSaveFile *save = _queue.front();
+		_queue.pop_front();
+		_busy = true;
+		SDL_UnlockMutex(_mutex);
+
+		// Failures are reported later by the engine thread
+		const bool success = storeWithStdio(*save) && (!save->next || storeWithStdio(*save->next));
+		if (success)
+			delete save;
+
+		SDL_LockMutex(_mutex);
+		if (!success)
+			_failed.push_back(save);
+		_busy = false;
+		SDL_CondBroadcast(_doneCond);
+	}
+
+	SDL_UnlockMutex(_mutex);
+}
+
+int SDLCALL SdlSaveFileWriter::writerThreadEntry(void *arg) {
+	((SdlSaveFileWriter *)arg)->writerThread();
+	return 0;
+}
+
+bool SdlSaveFileWriter::storeWithStdio(const PendingSaveFile &save) {
+	FILE *handle = fopen(save.tempPath, "wb");
+	if (!handle)
+		return false;
+
+	Common::WriteStream *stream = new StdioStream(handle);
+	Common::WriteStream *file = save.compress ? Common::wrapCompressedWriteStream(stream) : stream;
+	file->write(save.data, save.size);
+	file->finalize();
+	bool success = !file->err();
+
+	// The data has to be on the disk before it replaces the savefile,
+	// otherwise a crash of the system could still lose both
+#if defined(WIN32) && !defined(_WIN32_WCE)
+	if (success)
+		success = (_commit(_fileno(handle)) == 0);
+#elif defined(POSIX)
+	if (success)
+		success = (fsync(fileno(handle)) == 0);
+#endif
+
+	delete file;
+
+	if (!success) {
+		remove(save.tempPath);
+		return false;
+	}
+
+	return replaceSaveFile(save);
+}
+
+#endif
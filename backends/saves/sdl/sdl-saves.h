@@ -0,0 +1,77 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#if !defined(BACKEND_SDL_SAVES_H) && !defined(DISABLE_DEFAULT_SAVEFILEMANAGER)
+#define BACKEND_SDL_SAVES_H
+
+#include "backends/saves/default/default-saves.h"
+#include "backends/platform/sdl/sdl-sys.h"
+
+#include "common/list.h"
+
+/**
+ * Savefile writer which compresses and writes the savefiles on a thread of
+ * its own, so that the engine can continue as soon as it has serialized its
+ * state. Savefiles are stored in the order they were finalized. If the
+ * thread can't be created, savefiles are stored right away instead.
+ *
+ * The thread only uses storeWithStdio() and the savefile lists, and leaves
+ * warnings and all Common::String handling to the engine thread.
+ */
+class SdlSaveFileWriter : public SaveFileWriter {
+public:
+	SdlSaveFileWriter();
+
+	/**
+	 * Store all pending savefiles and stop the thread.
+	 */
+	~SdlSaveFileWriter();
+
+	bool write(PendingSaveFile *save);
+	void flush();
+	uint reportFailures();
+
+private:
+	Common::List<PendingSaveFile *> _queue;
+	/** The savefiles which could not be stored, until they are reported */
+	Common::List<PendingSaveFile *> _failed;
+	/** Whether the thread is storing a savefile it took from the queue */
+	bool _busy;
+	bool _shouldQuit;
+
+	SDL_Thread *_thread;
+	SDL_mutex *_mutex;
+	SDL_cond *_workCond;
+	SDL_cond *_doneCond;
+
+	void writerThread();
+	static int SDLCALL writerThreadEntry(void *arg);
+
+	/**
+	 * Like SaveFileWriter::store(), but writes the temporary file with stdio
+	 * and syncs it to the disk before it replaces the savefile. Only uses
+	 * the C library and zlib, so it can be called on the writer thread.
+	 */
+	static bool storeWithStdio(const PendingSaveFile &save);
+};
+
+#endif
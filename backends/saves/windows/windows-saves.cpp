@@ -79,4 +79,20 @@ WindowsSaveFileManager::WindowsSaveFileManager() {
 	}
 }
 
+bool WindowsSaveFileManager::getSavefileInfo(const Common::String &filename, uint32 &size, uint32 &modificationTime) {
+	// Savefiles being written have to be complete first
+	_writer->flush();
+
+	const Common::String path = Common::FSNode(getSavePath()).getChild(filename).getPath();
+	WIN32_FILE_ATTRIBUTE_DATA data;
+
+	if (!GetFileAttributesEx(path.c_str(), GetFileExInfoStandard, &data) || (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+		return false;
+
+	size = data.nFileSizeLow;
+	// FILETIME counts 100 nanosecond intervals
+	modificationTime = (uint32)((((uint64)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime) / 10000000);
+	return true;
+}
+
 #endif
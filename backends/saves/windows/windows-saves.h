@@ -31,6 +31,8 @@
 class WindowsSaveFileManager : public DefaultSaveFileManager {
 public:
 	WindowsSaveFileManager();
+
+	virtual bool getSavefileInfo(const Common::String &filename, uint32 &size, uint32 &modificationTime);
 };
 
 #endif
@@ -578,13 +578,12 @@ static void listGames() {
 	printf("Game ID              Full Title                                            \n"
 	       "-------------------- ------------------------------------------------------\n");
 
-	const EnginePlugin::List &plugins = EngineMan.getPlugins();
-	EnginePlugin::List::const_iterator iter = plugins.begin();
-	for (iter = plugins.begin(); iter != plugins.end(); ++iter) {
-		GameList list = (**iter)->getSupportedGames();
-		for (GameList::iterator v = list.begin(); v != list.end(); ++v) {
-			printf("%-20s %s\n", v->gameid().c_str(), v->description().c_str());
-		}
+	// The games of plugins which were loaded before are taken from the
+	// plugin manifest, without loading the plugins again.
+	GameList list;
+	PluginMan.getSupportedGames(list);
+	for (GameList::iterator v = list.begin(); v != list.end(); ++v) {
+		printf("%-20s %s\n", v->gameid().c_str(), v->description().c_str());
 	}
 }
 
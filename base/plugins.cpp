@@ -22,13 +22,16 @@
 
 #include "base/plugins.h"
 
+#include "base/version.h"
+
 #include "common/func.h"
 #include "common/debug.h"
 #include "common/config-manager.h"
-
-#ifdef DYNAMIC_MODULES
 #include "common/fs.h"
-#endif
+#include "common/stream.h"
+#include "common/system.h"
+
+#include "engines/metaengine.h"
 
 // Plugin versioning
 
@@ -282,29 +285,27 @@ void PluginManagerUncached::init() {
 			}
  		}
  	}
+
+	_manifest.load(_allEnginePlugins);
+
+	// Older versions listed the plugin files of games in the config file
+	if (ConfMan.hasMiscDomain("plugin_files"))
+		ConfMan.removeMiscDomain("plugin_files");
 }
 
 /**
- * Try to load the plugin by searching in the ConfigManager for a matching
- * gameId under the domain 'plugin_files'.
+ * Try to load the plugin by searching for the gameId in the manifest. The
+ * manifest has the games of every plugin file which was ever loaded, so
+ * this only fails for unknown gameIds, or for plugins which were never
+ * loaded before.
  **/
 bool PluginManagerUncached::loadPluginFromGameId(const Common::String &gameId) {
-	Common::ConfigManager::Domain *domain = ConfMan.getDomain("plugin_files");
-
-	if (domain) {
-		if (domain->contains(gameId)) {
-			Common::String filename = (*domain)[gameId];
-
-		    if (loadPluginByFileName(filename)) {
-				return true;
-			}
-		}
-	}
-	return false;
+	Common::String description;
+	return loadPluginByFileName(_manifest.findGame(gameId, description));
 }
 
 /**
- * Load a plugin with a filename taken from ConfigManager.
+ * Load a plugin with a filename taken from the manifest.
  **/
 bool PluginManagerUncached::loadPluginByFileName(const Common::String &filename) {
 	if (filename.empty())
@@ -323,24 +324,6 @@ bool PluginManagerUncached::loadPluginByFileName(const Common::String &filename)
 	return false;
 }
 
-/**
- * Update the config manager with a plugin file name that we found can handle
- * the game.
- **/
-void PluginManagerUncached::updateConfigWithFileName(const Common::String &gameId) {
-	// Check if we have a filename for the current plugin
-	if ((*_currentPlugin)->getFileName()) {
-		if (!ConfMan.hasMiscDomain("plugin_files"))
-			ConfMan.addMiscDomain("plugin_files");
-
-		Common::ConfigManager::Domain *domain = ConfMan.getDomain("plugin_files");
-		assert(domain);
-		(*domain)[gameId] = (*_currentPlugin)->getFileName();
-
-		ConfMan.flushToDisk();
-	}
-}
-
 void PluginManagerUncached::loadFirstPlugin() {
 	unloadPluginsExcept(PLUGIN_TYPE_ENGINE, NULL, false);
 
@@ -348,6 +331,7 @@ void PluginManagerUncached::loadFirstPlugin() {
 	for (_currentPlugin = _allEnginePlugins.begin(); _currentPlugin != _allEnginePlugins.end(); ++_currentPlugin) {
 		if ((*_currentPlugin)->loadPlugin()) {
 			addToPluginsInMemList(*_currentPlugin);
+			addToManifest(*_currentPlugin);
 			break;
 		}
 	}
@@ -359,23 +343,107 @@ bool PluginManagerUncached::loadNextPlugin() {
 	for (++_currentPlugin; _currentPlugin != _allEnginePlugins.end(); ++_currentPlugin) {
 		if ((*_currentPlugin)->loadPlugin()) {
 			addToPluginsInMemList(*_currentPlugin);
+			addToManifest(*_currentPlugin);
 			return true;
 		}
 	}
 	return false;	// no more in list
 }
 
+/**
+ * Get the games of all engine plugins. Only the plugins which are not in
+ * the manifest yet are loaded, one at a time.
+ **/
+void PluginManagerUncached::getSupportedGames(GameList &games) {
+	for (PluginList::iterator p = _allEnginePlugins.begin(); p != _allEnginePlugins.end(); ++p) {
+		if (_manifest.getGames(*p, games))
+			continue;
+
+		unloadPluginsExcept(PLUGIN_TYPE_ENGINE, NULL, false);
+		if ((*p)->loadPlugin()) {
+			addToPluginsInMemList(*p);
+			addToManifest(*p);
+			_currentPlugin = p;
+			games.push_back((*(EnginePlugin *)*p)->getSupportedGames());
+		}
+	}
+	_manifest.save();
+}
+
 /**
  * Used by only the cached plugin manager. The uncached manager can only have
  * one plugin in memory at a time.
+ *
+ * Plugin files whose games are in the manifest are not loaded until they
+ * are needed, see getPlugins() and loadPluginFromGameId(). Like in
+ * PluginManagerUncached::init(), all plugin files are assumed to be engine
+ * plugins.
  **/
 void PluginManager::loadAllPlugins() {
+	PluginList filePlugins;
 	for (ProviderList::iterator pp = _providers.begin();
 	                            pp != _providers.end();
 	                            ++pp) {
 		PluginList pl((*pp)->getPlugins());
-		Common::for_each(pl.begin(), pl.end(), Common::bind1st(Common::mem_fun(&PluginManager::tryLoadPlugin), this));
+		if ((*pp)->isFilePluginProvider())
+			filePlugins.push_back(pl);
+		else
+			Common::for_each(pl.begin(), pl.end(), Common::bind1st(Common::mem_fun(&PluginManager::tryLoadPlugin), this));
 	}
+
+	_manifest.load(filePlugins);
+	for (PluginList::iterator p = filePlugins.begin(); p != filePlugins.end(); ++p) {
+		if (_manifest.contains(*p))
+			_deferredEnginePlugins.push_back(*p);
+		else if (tryLoadPlugin(*p))
+			addToManifest(*p);
+	}
+	_manifest.save();
+}
+
+/**
+ * Load the engine plugins which loadAllPlugins() left out.
+ **/
+void PluginManager::loadDeferredPlugins() {
+	PluginList deferred;
+	SWAP(deferred, _deferredEnginePlugins);
+	Common::for_each(deferred.begin(), deferred.end(), Common::bind1st(Common::mem_fun(&PluginManager::tryLoadPlugin), this));
+}
+
+/**
+ * Load only the deferred plugin file which supports the given gameId,
+ * according to the manifest.
+ **/
+bool PluginManager::loadPluginFromGameId(const Common::String &gameId) {
+	Common::String description;
+	const Common::String filename = _manifest.findGame(gameId, description);
+	if (filename.empty())
+		return false;
+
+	for (uint i = 0; i < _deferredEnginePlugins.size(); ++i) {
+		if (filename == _deferredEnginePlugins[i]->getFileName())
+			return tryLoadPlugin(_deferredEnginePlugins.remove_at(i));
+	}
+	return false;
+}
+
+/**
+ * Get the games of all engine plugins, taking those of the deferred plugins
+ * from the manifest.
+ **/
+void PluginManager::getSupportedGames(GameList &games) {
+	const PluginList &plugins = _pluginsInMem[PLUGIN_TYPE_ENGINE];
+	for (PluginList::const_iterator p = plugins.begin(); p != plugins.end(); ++p)
+		games.push_back((*(EnginePlugin *)*p)->getSupportedGames());
+
+	for (PluginList::const_iterator p = _deferredEnginePlugins.begin(); p != _deferredEnginePlugins.end(); ++p)
+		_manifest.getGames(*p, games);
+}
+
+const PluginList &PluginManager::getPlugins(PluginType t) {
+	if (t == PLUGIN_TYPE_ENGINE)
+		loadDeferredPlugins();
+	return _pluginsInMem[t];
 }
 
 void PluginManager::unloadAllPlugins() {
@@ -383,7 +451,22 @@ void PluginManager::unloadAllPlugins() {
 		unloadPluginsExcept((PluginType)i, NULL);
 }
 
+/**
+ * Sum up the memory taken by the code and data of all loaded plugin files.
+ **/
+uint32 PluginManager::getMappedSize() const {
+	uint32 size = 0;
+	for (int i = 0; i < PLUGIN_TYPE_MAX; i++) {
+		for (PluginList::const_iterator p = _pluginsInMem[i].begin(); p != _pluginsInMem[i].end(); ++p)
+			size += (*p)->getMappedSize();
+	}
+	return size;
+}
+
 void PluginManager::unloadPluginsExcept(PluginType type, const Plugin *plugin, bool deletePlugin /*=true*/) {
+	const uint countBefore = _pluginsInMem[type].size();
+	const uint32 sizeBefore = getMappedSize();
+
 	Plugin *found = NULL;
 	for (PluginList::iterator p = _pluginsInMem[type].begin(); p != _pluginsInMem[type].end(); ++p) {
 		if (*p == plugin) {
@@ -398,6 +481,16 @@ void PluginManager::unloadPluginsExcept(PluginType type, const Plugin *plugin, b
 	if (found != NULL) {
 		_pluginsInMem[type].push_back(found);
 	}
+
+	if (_pluginsInMem[type].size() != countBefore)
+		debug(1, "Unloaded %d of %d plugins, the plugins in memory now take %d instead of %d bytes of code and data",
+				countBefore - _pluginsInMem[type].size(), countBefore, getMappedSize(), sizeBefore);
+
+	if (type == PLUGIN_TYPE_ENGINE && deletePlugin) {
+		for (PluginList::iterator p = _deferredEnginePlugins.begin(); p != _deferredEnginePlugins.end(); ++p)
+			delete *p;
+		_deferredEnginePlugins.clear();
+	}
 }
 
 /*
@@ -442,9 +535,170 @@ void PluginManager::addToPluginsInMemList(Plugin *plugin) {
 	}
 }
 
-// Engine plugins
+/**
+ * Add the games of a loaded engine plugin file to the manifest, unless they
+ * are already in there.
+ **/
+void PluginManager::addToManifest(Plugin *plugin) {
+	if (!plugin->getFileName() || plugin->getType() != PLUGIN_TYPE_ENGINE || _manifest.contains(plugin))
+		return;
 
-#include "engines/metaengine.h"
+	_manifest.setGames(plugin, (*(EnginePlugin *)plugin)->getSupportedGames());
+}
+
+// Plugin manifest
+
+/**
+ * The cache file is stored next to the default config file. The first line
+ * identifies the ScummVM version; every plugin file starts with a line
+ * "plugin <size> <file name>", followed by a line "game <gameId>
+ * <description>" for each of its games.
+ **/
+Common::String PluginManifest::getFileName() {
+	return g_system->getDefaultConfigFileName() + ".plugins";
+}
+
+static Common::String getManifestHeader() {
+	return Common::String::format("# %s, engine plugin version %d", gScummVMFullVersion, PLUGIN_TYPE_ENGINE_VERSION);
+}
+
+PluginManifest::Entry &PluginManifest::getEntry(const Plugin *plugin) {
+	const Common::String filename(plugin->getFileName());
+	EntryMap::iterator i = _entries.find(filename);
+	if (i != _entries.end())
+		return i->_value;
+
+	Entry &entry = _entries[filename];
+	Common::SeekableReadStream *file = Common::FSNode(filename).createReadStream();
+	if (file)
+		entry.size = file->size();
+	delete file;
+	return entry;
+}
+
+void PluginManifest::load(const PluginList &plugins) {
+	EntryMap stored;
+	Common::SeekableReadStream *in = Common::FSNode(getFileName()).createReadStream();
+	if (in && in->readLine() == getManifestHeader()) {
+		Entry *entry = 0;
+		while (!in->eos() && !in->err()) {
+			const Common::String line = in->readLine();
+			if (line.hasPrefix("plugin ")) {
+				char *name;
+				const long size = strtol(line.c_str() + 7, &name, 10);
+				if (*name != ' ')
+					break;
+				entry = &stored[name + 1];
+				entry->size = size;
+				entry->known = true;
+			} else if (line.hasPrefix("game ") && entry) {
+				const char *gameId = line.c_str() + 5;
+				const char *description = strchr(gameId, ' ');
+				if (!description)
+					break;
+				entry->games.push_back(Common::String(gameId, description));
+				entry->games.push_back(description + 1);
+			} else if (!line.empty()) {
+				break;
+			}
+		}
+	}
+	delete in;
+
+	_entries.clear();
+	_changed = false;
+	for (PluginList::const_iterator p = plugins.begin(); p != plugins.end(); ++p) {
+		if (!(*p)->getFileName())
+			continue;
+
+		Entry &entry = getEntry(*p);
+		EntryMap::iterator i = stored.find((*p)->getFileName());
+		if (i != stored.end() && i->_value.size == entry.size && entry.size != -1) {
+			entry.known = true;
+			entry.games = i->_value.games;
+			stored.erase(i);
+		}
+	}
+
+	// Drop the entries of plugin files which are gone
+	if (!stored.empty())
+		_changed = true;
+}
+
+void PluginManifest::save() {
+	if (!_changed)
+		return;
+
+	Common::WriteStream *out = Common::FSNode(getFileName()).createWriteStream();
+	if (!out) {
+		debug(1, "Could not write the plugin manifest '%s'", getFileName().c_str());
+		return;
+	}
+
+	out->writeString(getManifestHeader() + "\n");
+	for (EntryMap::const_iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		if (!i->_value.known)
+			continue;
+
+		out->writeString(Common::String::format("plugin %d %s\n", i->_value.size, i->_key.c_str()));
+		for (uint g = 0; g + 1 < i->_value.games.size(); g += 2)
+			out->writeString("game " + i->_value.games[g] + " " + i->_value.games[g + 1] + "\n");
+	}
+	out->finalize();
+	delete out;
+
+	_changed = false;
+}
+
+bool PluginManifest::contains(const Plugin *plugin) const {
+	if (!plugin->getFileName())
+		return false;
+
+	EntryMap::const_iterator i = _entries.find(plugin->getFileName());
+	return i != _entries.end() && i->_value.known;
+}
+
+bool PluginManifest::getGames(const Plugin *plugin, GameList &games) const {
+	if (!contains(plugin))
+		return false;
+
+	const Common::StringArray &entryGames = _entries[plugin->getFileName()].games;
+	for (uint g = 0; g + 1 < entryGames.size(); g += 2)
+		games.push_back(GameDescriptor(entryGames[g], entryGames[g + 1]));
+	return true;
+}
+
+void PluginManifest::setGames(const Plugin *plugin, const GameList &games) {
+	Entry &entry = getEntry(plugin);
+	if (entry.size == -1)
+		return;
+
+	entry.games.clear();
+	for (GameList::const_iterator g = games.begin(); g != games.end(); ++g) {
+		entry.games.push_back(g->gameid());
+		entry.games.push_back(g->description());
+	}
+	entry.known = true;
+	_changed = true;
+}
+
+Common::String PluginManifest::findGame(const Common::String &gameId, Common::String &description) const {
+	for (EntryMap::const_iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		if (!i->_value.known)
+			continue;
+
+		const Common::StringArray &games = i->_value.games;
+		for (uint g = 0; g + 1 < games.size(); g += 2) {
+			if (games[g] == gameId) {
+				description = games[g + 1];
+				return i->_key;
+			}
+		}
+	}
+	return Common::String();
+}
+
+// Engine plugins
 
 namespace Common {
 DECLARE_SINGLETON(EngineManager);
@@ -452,10 +706,11 @@ DECLARE_SINGLETON(EngineManager);
 
 /**
  * This function works for both cached and uncached PluginManagers.
- * For the cached version, most of the logic here will short circuit.
  *
- * For the uncached version, we first try to find the plugin using the gameId
- * and only if we can't find it there, we loop through the plugins.
+ * Callers which only need the description get it from the plugin manifest.
+ * Otherwise we first try to load the plugin which the manifest lists for
+ * the gameId, and only if we can't find it there, we loop through the
+ * plugins.
  **/
 GameDescriptor EngineManager::findGame(const Common::String &gameName, const EnginePlugin **plugin) const {
 	GameDescriptor result;
@@ -467,6 +722,13 @@ GameDescriptor EngineManager::findGame(const Common::String &gameName, const Eng
 		return result;
 	}
 
+	// Without a plugin to return, the manifest has all we need
+	if (!plugin) {
+		Common::String description;
+		if (!PluginMan.findGameInManifest(gameName, description).empty())
+			return GameDescriptor(gameName, description);
+	}
+
 	// Now look for the game using the gameId. This is much faster than scanning plugin
 	// by plugin
 	if (PluginMan.loadPluginFromGameId(gameName))  {
@@ -480,12 +742,10 @@ GameDescriptor EngineManager::findGame(const Common::String &gameName, const Eng
 	PluginMan.loadFirstPlugin();
 	do {
 		result = findGameInLoadedPlugins(gameName, plugin);
-		if (!result.gameid().empty()) {
-			// Update with new plugin file name
-			PluginMan.updateConfigWithFileName(gameName);
+		if (!result.gameid().empty())
 			break;
-		}
 	} while (PluginMan.loadNextPlugin());
+	PluginMan.saveManifest();
 
 	return result;
 }
@@ -495,7 +755,7 @@ GameDescriptor EngineManager::findGame(const Common::String &gameName, const Eng
  **/
 GameDescriptor EngineManager::findGameInLoadedPlugins(const Common::String &gameName, const EnginePlugin **plugin) const {
 	// Find the GameDescriptor for this target
-	const EnginePlugin::List &plugins = getPlugins();
+	const EnginePlugin::List &plugins = (const EnginePlugin::List &)PluginMan.getLoadedPlugins(PLUGIN_TYPE_ENGINE);
 	GameDescriptor result;
 
 	if (plugin)
@@ -527,6 +787,7 @@ GameList EngineManager::detectGames(const Common::FSList &fslist) const {
 			candidates.push_back((**iter)->detectGames(fslist));
 		}
 	} while (PluginManager::instance().loadNextPlugin());
+	PluginManager::instance().saveManifest();
 	return candidates;
 }
 
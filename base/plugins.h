@@ -25,7 +25,10 @@
 
 #include "common/array.h"
 #include "common/fs.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
 #include "common/str.h"
+#include "common/str-array.h"
 #include "backends/plugins/elf/version.h"
 
 
@@ -192,6 +195,13 @@ public:
 	 * object to be loaded into memory, unlike getName()
 	 **/
 	virtual const char *getFileName() const { return 0; }
+
+	/**
+	 * The getMappedSize() function gets the memory taken by the code and
+	 * static data of a loaded plugin file, if it is known. It returns 0 for
+	 * static plugins.
+	 **/
+	virtual uint32 getMappedSize() const { return 0; }
 };
 
 /** List of Plugin instances. */
@@ -299,6 +309,64 @@ protected:
 
 #endif // DYNAMIC_MODULES
 
+class GameList;
+
+/**
+ * The games supported by each engine plugin file, kept in a cache file
+ * next to the default config file. It allows to find the plugin of a game,
+ * or to list all games, without loading every plugin. The entry of a
+ * plugin file is dropped once the size of the file changes.
+ */
+class PluginManifest {
+public:
+	PluginManifest() : _changed(false) {}
+
+	/**
+	 * Read the cache file, and keep the entries of the given plugin files
+	 * which didn't change since they were written.
+	 */
+	void load(const PluginList &plugins);
+
+	/** Write the cache file, if any entry was added since it was read. */
+	void save();
+
+	/** Whether the games of the plugin file are known. */
+	bool contains(const Plugin *plugin) const;
+
+	/**
+	 * Append the known games of the plugin file to the list.
+	 * @return false if the games of the plugin file are unknown
+	 */
+	bool getGames(const Plugin *plugin, GameList &games) const;
+
+	/** Remember the games of a loaded engine plugin. */
+	void setGames(const Plugin *plugin, const GameList &games);
+
+	/**
+	 * Look up the plugin file which supports the given gameId.
+	 * @param gameId		the gameId to look for
+	 * @param description	set to the description of the game, if found
+	 * @return the name of the plugin file, or an empty string
+	 */
+	Common::String findGame(const Common::String &gameId, Common::String &description) const;
+
+private:
+	struct Entry {
+		Entry() : size(-1), known(false) {}
+
+		int32 size;		///< Size of the plugin file, or -1 if it can't be read
+		bool known;		///< Whether the games of the plugin file are known
+		Common::StringArray games;	///< The gameId and description of each game, one after the other
+	};
+	typedef Common::HashMap<Common::String, Entry> EntryMap;
+
+	static Common::String getFileName();
+	Entry &getEntry(const Plugin *plugin);
+
+	EntryMap _entries;
+	bool _changed;
+};
+
 #define PluginMan PluginManager::instance()
 
 /**
@@ -310,10 +378,15 @@ protected:
 	typedef Common::Array<PluginProvider *> ProviderList;
 
 	PluginList _pluginsInMem[PLUGIN_TYPE_MAX];
+	PluginList _deferredEnginePlugins;	///< Engine plugin files in the manifest which are not loaded yet
 	ProviderList _providers;
+	PluginManifest _manifest;
 
 	bool tryLoadPlugin(Plugin *plugin);
 	void addToPluginsInMemList(Plugin *plugin);
+	void addToManifest(Plugin *plugin);
+	void loadDeferredPlugins();
+	uint32 getMappedSize() const;
 
 	static PluginManager *_instance;
 	PluginManager();
@@ -328,10 +401,14 @@ public:
 
 	// Functions used by the uncached PluginManager
 	virtual void init()	{}
-	virtual void loadFirstPlugin() {}
 	virtual bool loadNextPlugin() { return false; }
-	virtual bool loadPluginFromGameId(const Common::String &gameId) { return false; }
-	virtual void updateConfigWithFileName(const Common::String &gameId) {}
+
+	// Functions used by both PluginManagers
+	virtual void loadFirstPlugin() { loadDeferredPlugins(); }
+	virtual bool loadPluginFromGameId(const Common::String &gameId);
+	virtual void getSupportedGames(GameList &games);
+	Common::String findGameInManifest(const Common::String &gameId, Common::String &description) const { return _manifest.findGame(gameId, description); }
+	void saveManifest() { _manifest.save(); }
 
 	// Functions used only by the cached PluginManager
 	virtual void loadAllPlugins();
@@ -339,7 +416,13 @@ public:
 
 	void unloadPluginsExcept(PluginType type, const Plugin *plugin, bool deletePlugin = true);
 
-	const PluginList &getPlugins(PluginType t) { return _pluginsInMem[t]; }
+	/**
+	 * Return the plugins of the given type. The cached PluginManager first
+	 * loads the engine plugins which were deferred because their games are
+	 * in the manifest.
+	 */
+	const PluginList &getPlugins(PluginType t);
+	const PluginList &getLoadedPlugins(PluginType t) const { return _pluginsInMem[t]; }
 };
 
 /**
@@ -360,7 +443,7 @@ public:
 	virtual void loadFirstPlugin();
 	virtual bool loadNextPlugin();
 	virtual bool loadPluginFromGameId(const Common::String &gameId);
-	virtual void updateConfigWithFileName(const Common::String &gameId);
+	virtual void getSupportedGames(GameList &games);
 
 	virtual void loadAllPlugins() {} 	// we don't allow this
 };
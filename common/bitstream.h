@@ -26,8 +26,11 @@
 #define COMMON_BITSTREAM_H
 
 #include "common/scummsys.h"
+#include "common/types.h"
 #include "common/textconsole.h"
 #include "common/stream.h"
+#include "common/endian.h"
+#include "common/util.h"
 
 namespace Common {
 
@@ -61,12 +64,18 @@ public:
 	/** Read a bit from the bit stream, without changing the stream's position. */
 	virtual uint32 peekBit() = 0;
 
-	/** Read a multi-bit value from the bit stream, without changing the stream's position. */
+	/**
+	 * Read a multi-bit value from the bit stream, without changing the stream's position.
+	 * Bits past the end of the stream are read as 0.
+	 */
 	virtual uint32 peekBits(uint8 n) = 0;
 
 	/** Add a bit to the value x, making it an n+1-bit value. */
 	virtual void addBit(uint32 &x, uint32 n) = 0;
 
+	/** Are the bits read from MSB to LSB, i.e. is the first bit read the highest one of a multi-bit value? */
+	virtual bool isMSBFirst() const = 0;
+
 protected:
 	BitStream() {
 	}
@@ -225,14 +234,24 @@ public:
 	/**
 	 * Read a multi-bit value from the bit stream, without changing the stream's position.
 	 *
-	 * The bit order is the same as in getBits().
+	 * The bit order is the same as in getBits(). Bits past the end of the
+	 * stream are read as 0, so that a value can be peeked at even if it
+	 * is shorter than n bits.
 	 */
 	uint32 peekBits(uint8 n) {
 		uint32 value   = _value;
 		uint8  inValue = _inValue;
 		uint32 curPos  = _stream->pos();
 
-		uint32 v = getBits(n);
+		uint32 left = size() - pos();
+		uint32 v;
+		if (n <= left) {
+			v = getBits(n);
+		} else {
+			v = getBits(left);
+			if (isMSB2LSB && left)
+				v <<= n - left;
+		}
 
 		_stream->seek(curPos);
 		_inValue = inValue;
@@ -262,6 +281,10 @@ public:
 			x = (x & ~(1 << n)) | (getBit() << n);
 	}
 
+	bool isMSBFirst() const {
+		return isMSB2LSB;
+	}
+
 	/** Rewind the bit stream back to the start. */
 	void rewind() {
 		_stream->seek(0);
@@ -320,6 +343,243 @@ typedef BitStreamImpl<32, false, true > BitStream32BEMSB;
 /** 32-bit big-endian data, LSB to MSB. */
 typedef BitStreamImpl<32, false, false> BitStream32BELSB;
 
+/**
+ * A bit stream reading directly from a memory buffer.
+ *
+ * This has the same interface and memory layout parameters as
+ * BitStreamImpl, but it isn't derived from BitStream. Its methods are not
+ * virtual, so they can be inlined into the decoders using them, and
+ * instead of reading the data value by value, it loads the 32 bits
+ * around the current position from memory at once.
+ *
+ * Data whose byte order doesn't match the bit order (for example 16-bit
+ * little-endian values read MSB to LSB) is copied and rearranged when the
+ * bit stream is created, so that the bits are in byte order.
+ */
+template<int valueBits, bool isLE, bool isMSB2LSB>
+class BitStreamMemoryImpl {
+private:
+	const byte *_data; ///< The data, with the bytes in the order of the bits.
+	byte *_ownData;    ///< Memory to free on destruction, or 0.
+	uint32 _size;      ///< Size of the data in bytes, in whole values.
+	uint32 _pos;       ///< Position in bits.
+
+	/** Does the data need to be rearranged to have the bits in byte order? */
+	static bool needsSwap() {
+		return (valueBits > 8) && (isLE == isMSB2LSB);
+	}
+
+	/** Set up the data, taking ownership of it if disposeMemory is set. */
+	void init(const byte *data, uint32 size, DisposeAfterUse::Flag disposeMemory) {
+		if ((valueBits != 8) && (valueBits != 16) && (valueBits != 32))
+			error("BitStreamMemoryImpl: Invalid memory layout %d, %d, %d", valueBits, isLE, isMSB2LSB);
+
+		_size = size & ~((uint32) ((valueBits >> 3) - 1));
+		_pos = 0;
+
+		if (!needsSwap()) {
+			_data = data;
+			_ownData = (disposeMemory == DisposeAfterUse::YES) ? const_cast<byte *>(data) : 0;
+			return;
+		}
+
+		byte *swapped = (byte *)malloc(MAX<uint32>(_size, 1));
+		if (!swapped)
+			error("BitStreamMemoryImpl: Out of memory");
+
+		const uint32 valueBytes = valueBits >> 3;
+		for (uint32 i = 0; i < _size; i += valueBytes)
+			for (uint32 j = 0; j < valueBytes; j++)
+				swapped[i + j] = data[i + valueBytes - 1 - j];
+
+		if (disposeMemory == DisposeAfterUse::YES)
+			free(const_cast<byte *>(data));
+
+		_data = swapped;
+		_ownData = swapped;
+	}
+
+	/** Return the byte at this offset, or 0 past the end of the data. */
+	inline uint32 getByte(uint32 offset) const {
+		return (offset < _size) ? _data[offset] : 0;
+	}
+
+	/** Load the 32 bits starting at this byte offset, in bit order. */
+	inline uint32 loadBits(uint32 offset) const {
+		if (offset + 4 <= _size)
+			return isMSB2LSB ? READ_BE_UINT32(_data + offset) : READ_LE_UINT32(_data + offset);
+
+		// Near the end of the data, fill up with zeros
+		if (isMSB2LSB)
+			return (getByte(offset) << 24) | (getByte(offset + 1) << 16) | (getByte(offset + 2) << 8) | getByte(offset + 3);
+		else
+			return getByte(offset) | (getByte(offset + 1) << 8) | (getByte(offset + 2) << 16) | (getByte(offset + 3) << 24);
+	}
+
+public:
+	/** Create a bit stream reading this memory buffer, and optionally free() it on destruction. */
+	BitStreamMemoryImpl(const byte *data, uint32 size, DisposeAfterUse::Flag disposeMemory = DisposeAfterUse::NO) {
+		init(data, size, disposeMemory);
+	}
+
+	/** Create a bit stream with a copy of the whole contents of this stream. */
+	explicit BitStreamMemoryImpl(SeekableReadStream &stream) {
+		const uint32 size = stream.size();
+		byte *data = (byte *)malloc(MAX<uint32>(size, 1));
+		if (!data)
+			error("BitStreamMemoryImpl: Out of memory");
+
+		stream.seek(0);
+		if (stream.read(data, size) != size)
+			error("BitStreamMemoryImpl: Read error");
+
+		init(data, size, DisposeAfterUse::YES);
+	}
+
+	~BitStreamMemoryImpl() {
+		free(_ownData);
+	}
+
+	/** Read a bit from the bit stream. */
+	inline uint32 getBit() {
+		if (_pos >= (_size << 3))
+			error("BitStreamMemoryImpl::getBit(): End of bit stream reached");
+
+		const uint32 b = _data[_pos >> 3];
+		const uint32 shift = isMSB2LSB ? (7 - (_pos & 7)) : (_pos & 7);
+		_pos++;
+
+		return (b >> shift) & 1;
+	}
+
+	/**
+	 * Read a multi-bit value from the bit stream.
+	 *
+	 * The bit order is the same as in BitStreamImpl::getBits().
+	 */
+	inline uint32 getBits(uint8 n) {
+		if (n > (_size << 3) - _pos)
+			error("BitStreamMemoryImpl::getBits(): End of bit stream reached");
+
+		const uint32 v = peekBits(n);
+		_pos += n;
+
+		return v;
+	}
+
+	/** Read a bit from the bit stream, without changing the stream's position. */
+	inline uint32 peekBit() {
+		const uint32 v = getBit();
+		_pos--;
+
+		return v;
+	}
+
+	/**
+	 * Read a multi-bit value from the bit stream, without changing the stream's position.
+	 *
+	 * Bits past the end of the stream are read as 0.
+	 */
+	inline uint32 peekBits(uint8 n) {
+		if (n == 0)
+			return 0;
+
+		if (n > 32)
+			error("BitStreamMemoryImpl::peekBits(): Too many bits requested to be read");
+
+		const uint32 offset = _pos >> 3;
+		const uint32 shift  = _pos & 7;
+
+		uint32 v = loadBits(offset);
+
+		// A value not aligned to a byte may reach into a fifth byte
+		if (isMSB2LSB) {
+			v <<= shift;
+			if (n + shift > 32)
+				v |= getByte(offset + 4) >> (8 - shift);
+
+			return v >> (32 - n);
+		} else {
+			v >>= shift;
+			if (n + shift > 32)
+				v |= getByte(offset + 4) << (32 - shift);
+
+			return (n < 32) ? (v & ((1U << n) - 1)) : v;
+		}
+	}
+
+	/**
+	 * Add a bit to the value x, making it an n+1-bit value.
+	 *
+	 * See BitStreamImpl::addBit().
+	 */
+	inline void addBit(uint32 &x, uint32 n) {
+		if (n >= 32)
+			error("BitStreamMemoryImpl::addBit(): Too many bits requested to be read");
+
+		if (isMSB2LSB)
+			x = (x << 1) | getBit();
+		else
+			x = (x & ~(1 << n)) | (getBit() << n);
+	}
+
+	bool isMSBFirst() const {
+		return isMSB2LSB;
+	}
+
+	/** Rewind the bit stream back to the start. */
+	void rewind() {
+		_pos = 0;
+	}
+
+	/** Skip the specified amount of bits. */
+	inline void skip(uint32 n) {
+		if (n > (_size << 3) - _pos)
+			error("BitStreamMemoryImpl::skip(): End of bit stream reached");
+
+		_pos += n;
+	}
+
+	/** Return the stream position in bits. */
+	uint32 pos() const {
+		return _pos;
+	}
+
+	/** Return the stream size in bits. */
+	uint32 size() const {
+		return _size << 3;
+	}
+
+	bool eos() const {
+		return _pos >= (_size << 3);
+	}
+};
+
+// typedefs for various memory layouts.
+
+/** 8-bit data, MSB to LSB. */
+typedef BitStreamMemoryImpl<8, false, true > BitStreamMemory8MSB;
+/** 8-bit data, LSB to MSB. */
+typedef BitStreamMemoryImpl<8, false, false> BitStreamMemory8LSB;
+
+/** 16-bit little-endian data, MSB to LSB. */
+typedef BitStreamMemoryImpl<16, true , true > BitStreamMemory16LEMSB;
+/** 16-bit little-endian data, LSB to MSB. */
+typedef BitStreamMemoryImpl<16, true , false> BitStreamMemory16LELSB;
+/** 16-bit big-endian data, MSB to LSB. */
+typedef BitStreamMemoryImpl<16, false, true > BitStreamMemory16BEMSB;
+/** 16-bit big-endian data, LSB to MSB. */
+typedef BitStreamMemoryImpl<16, false, false> BitStreamMemory16BELSB;
+
+/** 32-bit little-endian data, MSB to LSB. */
+typedef BitStreamMemoryImpl<32, true , true > BitStreamMemory32LEMSB;
+/** 32-bit little-endian data, LSB to MSB. */
+typedef BitStreamMemoryImpl<32, true , false> BitStreamMemory32LELSB;
+/** 32-bit big-endian data, MSB to LSB. */
+typedef BitStreamMemoryImpl<32, false, true > BitStreamMemory32BEMSB;
+/** 32-bit big-endian data, LSB to MSB. */
+typedef BitStreamMemoryImpl<32, false, false> BitStreamMemory32BELSB;
+
 } // End of namespace Common
 
 #endif // COMMON_BITSTREAM_H
@@ -233,9 +233,12 @@ void ConfigManager::loadFromStream(SeekableReadStream &stream) {
 			// Finally, store the key/value pair in the active domain
 			domain[key] = value;
 
-			// Store comment
-			domain.setKVComment(key, comment);
-			comment.clear();
+			// Store comment, if any. Most keys have none, so don't add empty
+			// ones, which would double the work for loading large files.
+			if (!comment.empty()) {
+				domain.setKVComment(key, comment);
+				comment.clear();
+			}
 		}
 	}
 
@@ -0,0 +1,556 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// The hash map in this file uses open addressing with linear probing and
+// Robin Hood insertion. Erased entries are removed by shifting the following
+// entries back, so no tombstones are needed.
+
+#ifndef COMMON_FLATHASHMAP_H
+#define COMMON_FLATHASHMAP_H
+
+#include "common/func.h"
+
+namespace Common {
+
+#if (defined(__sgi) && !defined(__GNUC__)) || defined(__INTEL_COMPILER)
+template<class T> class IteratorImpl;
+#endif
+
+/**
+ * FlatHashMap<Key,Val> is a drop-in alternative to HashMap<Key,Val> with the
+ * same interface and the same requirements on Key, Val, HashFunc and
+ * EqualFunc.
+ *
+ * Unlike HashMap, the nodes are stored directly in the hash table instead of
+ * being allocated separately, and the hash of every key is kept next to it.
+ * Lookups thus usually touch only one or two cache lines, and comparing the
+ * cached hashes avoids most calls to EqualFunc. In return, nodes are copied
+ * around when the table is modified, which makes the map less suited for
+ * large values.
+ *
+ * @note Inserting into the map or erasing from it invalidates all iterators
+ *       and references to values, as nodes move within the table.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+private:
+
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> FHM_t;
+
+	struct Node {
+		const Key _key;
+		Val _value;
+		explicit Node(const Key &key) : _key(key), _value() {}
+	};
+
+	enum {
+		FLATHASHMAP_MIN_CAPACITY = 16,
+
+		// The quotient of the next two constants controls how much the
+		// internal storage of the hashmap may fill up before being
+		// increased automatically.
+		// Note: the quotient of these two must be between and different
+		// from 0 and 1.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 3,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 4
+	};
+
+	/** Returned by lookup() for keys not in the map */
+	static size_type noSlot() { return (size_type)-1; }
+
+	/**
+	 * The hash of a key as stored in _hashes, which is never 0.
+	 *
+	 * Slots are picked by the low bits of the hash, but hash functions like
+	 * Hash<int> return the key itself, so keys differing only in their high
+	 * bits (i << 16, aligned pointers) would all start probing at the same
+	 * slot. The bits are mixed first, using the MurmurHash3 finalizer.
+	 */
+	size_type hashKey(const Key &key) const {
+		uint32 hash = _hash(key);
+		hash ^= hash >> 16;
+		hash *= 0x85ebca6b;
+		hash ^= hash >> 13;
+		hash *= 0xc2b2ae35;
+		hash ^= hash >> 16;
+		return hash | 0x80000000;
+	}
+
+	size_type *_hashes;	///< Cached hash of the node in each slot, or 0 for free slots
+	Node *_nodes;		///< Nodes; only slots with a non-zero hash are constructed
+	size_type _mask;	///< Capacity of the map minus one; the capacity is a power of two
+	size_type _size;
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	/** Default value, returned by the const getVal. */
+	const Val _defaultVal;
+
+	/** Distance of the node in slot idx from the slot its hash points to */
+	size_type probeDistance(size_type idx) const {
+		return (idx - _hashes[idx]) & _mask;
+	}
+
+	void allocStorage(size_type capacity);
+	void freeStorage();
+	void assign(const FHM_t &map);
+	void moveNode(size_type dst, size_type src);
+	size_type lookup(const Key &key, size_type hash) const {
+		size_type ctr = hash & _mask;
+
+		// Nodes are ordered by the slot their hash points to, so the search
+		// can stop as soon as it reaches a node which is closer to its slot
+		// than the key would be.
+		for (size_type dist = 0; ; ++dist) {
+			const size_type slotHash = _hashes[ctr];
+			if (slotHash == hash && _equal(_nodes[ctr]._key, key))
+				return ctr;
+			if (slotHash == 0 || ((ctr - slotHash) & _mask) < dist)
+				return noSlot();
+			ctr = (ctr + 1) & _mask;
+		}
+	}
+
+	size_type lookup(const Key &key) const { return lookup(key, hashKey(key)); }
+	size_type lookupAndCreateIfMissing(const Key &key);
+	size_type allocSlot(size_type hash);
+	void eraseSlot(size_type idx);
+	void expandStorage(size_type newCapacity);
+
+#if !defined(__sgi) || defined(__GNUC__)
+	template<class T> friend class IteratorImpl;
+#endif
+
+	/**
+	 * Simple FlatHashMap iterator implementation.
+	 */
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+#if (defined(__sgi) && !defined(__GNUC__)) || defined(__INTEL_COMPILER)
+		template<class T> friend class Common::IteratorImpl;
+#else
+		template<class T> friend class IteratorImpl;
+#endif
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != 0);
+			assert(_idx <= _hashmap->_mask);
+			assert(_hashmap->_hashes[_idx] != 0);
+			return &_hashmap->_nodes[_idx];
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(0) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			do {
+				_idx++;
+			} while (_idx <= _hashmap->_mask && _hashmap->_hashes[_idx] == 0);
+			if (_idx > _hashmap->_mask)
+				_idx = (size_type)-1;
+
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const FHM_t &map);
+	~FlatHashMap();
+
+	FHM_t &operator=(const FHM_t &map) {
+		if (this == &map)
+			return *this;
+
+		// Remove the previous content and ...
+		freeStorage();
+		// ... copy the new stuff.
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getVal(const Key &key, const Val &defaultVal) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	iterator	begin() {
+		// Find and return the first non-empty entry
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (_hashes[ctr])
+				return iterator(ctr, this);
+		}
+		return end();
+	}
+	iterator	end() {
+		return iterator((size_type)-1, this);
+	}
+
+	const_iterator	begin() const {
+		// Find and return the first non-empty entry
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (_hashes[ctr])
+				return const_iterator(ctr, this);
+		}
+		return end();
+	}
+	const_iterator	end() const {
+		return const_iterator((size_type)-1, this);
+	}
+
+	iterator	find(const Key &key) {
+		return iterator(lookup(key), this);
+	}
+
+	const_iterator	find(const Key &key) const {
+		return const_iterator(lookup(key), this);
+	}
+
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Base constructor, creates an empty hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal() {
+	allocStorage(FLATHASHMAP_MIN_CAPACITY);
+}
+
+/**
+ * Copy constructor, creates a full copy of the given hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const FHM_t &map) : _defaultVal() {
+	assign(map);
+}
+
+/**
+ * Destructor, frees all used memory.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	freeStorage();
+}
+
+/**
+ * Internal method for allocating empty storage with the given capacity,
+ * which must be a power of two.
+ *
+ * @note We do *not* deallocate the previous storage here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::allocStorage(size_type capacity) {
+	_mask = capacity - 1;
+	_size = 0;
+
+	_hashes = new size_type[capacity];
+	assert(_hashes != NULL);
+	memset(_hashes, 0, capacity * sizeof(size_type));
+
+	_nodes = (Node *)malloc(capacity * sizeof(Node));
+	assert(_nodes != NULL);
+}
+
+/**
+ * Internal method for destroying all nodes and freeing the storage.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::freeStorage() {
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (_hashes[ctr])
+			_nodes[ctr].~Node();
+	}
+
+	delete[] _hashes;
+	free(_nodes);
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one.
+ *
+ * @note We do *not* deallocate the previous storage here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const FHM_t &map) {
+	allocStorage(map._mask + 1);
+
+	// The slots only depend on the hashes, so the nodes can be copied to the
+	// same slots.
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (map._hashes[ctr]) {
+			new ((void *)&_nodes[ctr]) Node(map._nodes[ctr]);
+			_hashes[ctr] = map._hashes[ctr];
+			_size++;
+		}
+	}
+	assert(_size == map._size);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	if (shrinkArray && _mask >= FLATHASHMAP_MIN_CAPACITY) {
+		freeStorage();
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+		return;
+	}
+
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (_hashes[ctr]) {
+			_nodes[ctr].~Node();
+			_hashes[ctr] = 0;
+		}
+	}
+
+	_size = 0;
+}
+
+/**
+ * Internal method for moving the node in slot src to the free slot dst.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::moveNode(size_type dst, size_type src) {
+	assert(_hashes[dst] == 0 && _hashes[src] != 0);
+
+	new ((void *)&_nodes[dst]) Node(_nodes[src]);
+	_nodes[src].~Node();
+
+	_hashes[dst] = _hashes[src];
+	_hashes[src] = 0;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::expandStorage(size_type newCapacity) {
+	assert(newCapacity > _mask+1);
+
+	const size_type old_size = _size;
+	const size_type old_mask = _mask;
+	size_type *old_hashes = _hashes;
+	Node *old_nodes = _nodes;
+
+	allocStorage(newCapacity);
+
+	// Rehash all the old elements. Since we know that no key exists twice in
+	// the old table, we don't have to call _equal().
+	for (size_type ctr = 0; ctr <= old_mask; ++ctr) {
+		if (old_hashes[ctr] == 0)
+			continue;
+
+		const size_type idx = allocSlot(old_hashes[ctr]);
+		new ((void *)&_nodes[idx]) Node(old_nodes[ctr]);
+		old_nodes[ctr].~Node();
+		_size++;
+	}
+
+	// Perform a sanity check: Old number of elements should match the new one!
+	// This check will fail if some previous operation corrupted this hashmap.
+	assert(_size == old_size);
+
+	delete[] old_hashes;
+	free(old_nodes);
+}
+
+/**
+ * Internal method for allocating a slot for a node with the given hash, which
+ * must not be in the map yet. The hash is stored in the returned slot, but
+ * the node has to be constructed by the caller.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::allocSlot(size_type hash) {
+	size_type ctr = hash & _mask;
+
+	// Skip all nodes which are at least as far from their slot as the new
+	// one is; it takes the place of the first node which is closer.
+	for (size_type dist = 0; _hashes[ctr] != 0 && probeDistance(ctr) >= dist; ++dist)
+		ctr = (ctr + 1) & _mask;
+
+	// Make room by moving the following nodes up to the next free slot
+	// forward by one.
+	if (_hashes[ctr] != 0) {
+		size_type last = ctr;
+		while (_hashes[last] != 0)
+			last = (last + 1) & _mask;
+
+		while (last != ctr) {
+			const size_type prev = (last - 1) & _mask;
+			moveNode(last, prev);
+			last = prev;
+		}
+	}
+
+	_hashes[ctr] = hash;
+	return ctr;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	const size_type hash = hashKey(key);
+	size_type ctr = lookup(key, hash);
+	if (ctr != noSlot())
+		return ctr;
+
+	// Keep the load factor below a certain threshold.
+	size_type capacity = _mask + 1;
+	if ((_size + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR >
+	        capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+		capacity = capacity < 500 ? (capacity * 4) : (capacity * 2);
+		expandStorage(capacity);
+	}
+
+	ctr = allocSlot(hash);
+	new ((void *)&_nodes[ctr]) Node(key);
+	_size++;
+
+	return ctr;
+}
+
+/**
+ * Internal method for removing the node in slot idx. The nodes following it
+ * are moved back by one, until one is found which is already in its slot.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::eraseSlot(size_type idx) {
+	assert(idx <= _mask && _hashes[idx] != 0);
+
+	_nodes[idx].~Node();
+	_hashes[idx] = 0;
+	_size--;
+
+	size_type next = (idx + 1) & _mask;
+	while (_hashes[next] != 0 && probeDistance(next) != 0) {
+		moveNode(idx, next);
+		idx = next;
+		next = (next + 1) & _mask;
+	}
+}
+
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	return lookup(key) != noSlot();
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getVal(key);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	// The lookup may reallocate _nodes, so it has to happen first.
+	const size_type ctr = lookupAndCreateIfMissing(key);
+	return _nodes[ctr]._value;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	return getVal(key, _defaultVal);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (ctr != noSlot())
+		return _nodes[ctr]._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	const size_type ctr = lookupAndCreateIfMissing(key);
+	_nodes[ctr]._value = val;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	eraseSlot(entry._idx);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != noSlot())
+		eraseSlot(ctr);
+}
+
+}	// End of namespace Common
+
+#endif
@@ -24,15 +24,9 @@
 
 #include "common/huffman.h"
 #include "common/util.h"
-#include "common/textconsole.h"
-#include "common/bitstream.h"
 
 namespace Common {
 
-Huffman::Symbol::Symbol(uint32 c, uint32 s) : code(c), symbol(s) {
-}
-
-
 Huffman::Huffman(uint8 maxLength, uint32 codeCount, const uint32 *codes, const uint8 *lengths, const uint32 *symbols) {
 	assert(codeCount > 0);
 
@@ -45,42 +39,98 @@ Huffman::Huffman(uint8 maxLength, uint32 codeCount, const uint32 *codes, const u
 
 	assert(maxLength <= 32);
 
-	_codes.resize(maxLength);
 	_symbols.resize(codeCount);
+	setSymbols(symbols);
 
-	for (uint32 i = 0; i < codeCount; i++) {
-		// The symbol. If none were specified, just assume it's identical to the code index
-		uint32 symbol = symbols ? symbols[i] : i;
+	// Sort the codes by length. When codes collide, the shorter one and then
+	// the first one given wins, as they are filled into the tables in order.
+	Array<uint32> indices;
+	for (uint8 length = 1; length <= maxLength; length++)
+		for (uint32 i = 0; i < codeCount; i++)
+			if (lengths[i] == length)
+				indices.push_back(i);
 
-		// Put the code and symbol into the correct list
-		_codes[lengths[i] - 1].push_back(Symbol(codes[i], symbol));
+	_lookupBits = MIN<uint8>(maxLength, kLookupBits);
 
-		// And put the pointer to the symbol/code struct into the symbol list.
-		_symbols[i] = &_codes[lengths[i] - 1].back();
+	for (int order = 0; order < 2; order++) {
+		_tables[order].resize(1 << _lookupBits);
+		buildTable(_tables[order], order == 0, 0, 0, _lookupBits, indices, codes, lengths);
 	}
 }
 
 Huffman::~Huffman() {
 }
 
-void Huffman::setSymbols(const uint32 *symbols) {
-	for (uint32 i = 0; i < _symbols.size(); i++)
-		_symbols[i]->symbol = symbols ? *symbols++ : i;
-}
+void Huffman::buildTable(Table &table, bool msbFirst, uint32 offset, uint8 usedBits, uint8 tableBits,
+                         const Array<uint32> &indices, const uint32 *codes, const uint8 *lengths) {
+	const uint32 entries = 1 << tableBits;
 
-uint32 Huffman::getSymbol(BitStream &bits) const {
-	uint32 code = 0;
+	for (uint32 i = 0; i < entries; i++) {
+		table[offset + i].value = 0;
+		table[offset + i].length = 0;
+		table[offset + i].subBits = 0;
+	}
 
-	for (uint32 i = 0; i < _codes.size(); i++) {
-		bits.addBit(code, i);
+	// The codes continuing in a secondary table, by table entry
+	Array<Array<uint32> > subIndices;
+	Array<uint8> subLengths;
+
+	for (uint32 i = 0; i < indices.size(); i++) {
+		const uint32 index = indices[i];
+		const uint8 length = lengths[index];
+
+		// The bits of the code that haven't been used by the previous tables,
+		// in the order they come from the bit stream
+		const uint8 restLength = length - usedBits;
+		const uint32 rest = msbFirst ? (codes[index] & lowBitMask(restLength)) : (codes[index] >> usedBits);
+
+		if (restLength <= tableBits) {
+			// Fill all the entries that start with this code
+			const uint32 fill = 1 << (tableBits - restLength);
+			for (uint32 j = 0; j < fill; j++) {
+				TableEntry &entry = table[offset + (msbFirst ? ((rest << (tableBits - restLength)) | j) : (rest | (j << restLength)))];
+				if (entry.length == 0 && entry.subBits == 0) {
+					entry.value = index;
+					entry.length = length;
+				}
+			}
+		} else {
+			const uint32 slot = msbFirst ? (rest >> (restLength - tableBits)) : (rest & lowBitMask(tableBits));
+
+			// A shorter code is a prefix of this one, so it can't be decoded
+			if (table[offset + slot].length)
+				continue;
+
+			if (subIndices.empty()) {
+				subIndices.resize(entries);
+				subLengths.resize(entries);
+				for (uint32 j = 0; j < entries; j++)
+					subLengths[j] = 0;
+			}
+
+			subIndices[slot].push_back(index);
+			subLengths[slot] = MAX<uint8>(subLengths[slot], restLength - tableBits);
+		}
+	}
+
+	for (uint32 slot = 0; slot < subIndices.size(); slot++) {
+		if (subIndices[slot].empty())
+			continue;
+
+		const uint8 subBits = MIN<uint8>(subLengths[slot], kLookupBits);
+		const uint32 subOffset = table.size();
+		table.resize(subOffset + (1 << subBits));
+
+		table[offset + slot].value = subOffset;
+		table[offset + slot].subBits = subBits;
 
-		for (CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode)
-			if (code == cCode->code)
-				return cCode->symbol;
+		buildTable(table, msbFirst, subOffset, usedBits + tableBits, subBits, subIndices[slot], codes, lengths);
 	}
+}
 
-	error("Unknown Huffman code");
-	return 0;
+void Huffman::setSymbols(const uint32 *symbols) {
+	for (uint32 i = 0; i < _symbols.size(); i++)
+		_symbols[i] = symbols ? *symbols++ : i;
 }
 
 } // End of namespace Common
@@ -26,16 +26,19 @@
 #define COMMON_HUFFMAN_H
 
 #include "common/array.h"
-#include "common/list.h"
 #include "common/types.h"
+#include "common/textconsole.h"
 
 namespace Common {
 
-class BitStream;
-
 /**
  * Huffman bitstream decoding
  *
+ * The codes are decoded with lookup tables, built for both bit orders when
+ * the decoder is constructed. Each table is indexed by up to kLookupBits
+ * bits of the stream, and codes longer than that continue in secondary
+ * tables.
+ *
  * Used in engines:
  *  - scumm
  */
@@ -55,26 +58,73 @@ public:
 	/** Modify the codes' symbols. */
 	void setSymbols(const uint32 *symbols = 0);
 
-	/** Return the next symbol in the bitstream. */
-	uint32 getSymbol(BitStream &bits) const;
+	/**
+	 * Return the next symbol in the bitstream.
+	 *
+	 * This works with any bit stream class, like BitStream and the
+	 * BitStreamMemoryImpl variants, whose calls can then be inlined.
+	 */
+	template<class BITSTREAM>
+	uint32 getSymbol(BITSTREAM &bits) const {
+		const bool msbFirst = bits.isMSBFirst();
+		const Table &table = _tables[msbFirst ? 0 : 1];
+
+		uint32 offset = 0;
+		uint8 usedBits = 0;
+		uint8 tableBits = _lookupBits;
+
+		for (;;) {
+			// Look at the bits of the code indexing the current table
+			const uint32 value = bits.peekBits(usedBits + tableBits);
+			const uint32 slot = msbFirst ? (value & lowBitMask(tableBits)) : ((value >> usedBits) & lowBitMask(tableBits));
+			const TableEntry &entry = table[offset + slot];
+
+			if (entry.length) {
+				bits.skip(entry.length);
+				return _symbols[entry.value];
+			}
+
+			if (!entry.subBits)
+				break;
+
+			offset = entry.value;
+			usedBits += tableBits;
+			tableBits = entry.subBits;
+		}
+
+		error("Unknown Huffman code");
+		return 0;
+	}
 
 private:
-	struct Symbol {
-		uint32 code;
-		uint32 symbol;
+	enum {
+		/** Maximal number of bits used to index a lookup table */
+		kLookupBits = 9
+	};
 
-		Symbol(uint32 c, uint32 s);
+	struct TableEntry {
+		uint32 value;   ///< Index of the symbol, or offset of the secondary table.
+		uint8 length;   ///< Length of the code, or 0 if this isn't a code.
+		uint8 subBits;  ///< Index bits of the secondary table, or 0 if there's none.
 	};
 
-	typedef List<Symbol> CodeList;
-	typedef Array<CodeList> CodeLists;
-	typedef Array<Symbol *> SymbolList;
+	typedef Array<TableEntry> Table;
+
+	static inline uint32 lowBitMask(uint8 n) {
+		return (n < 32) ? ((1U << n) - 1) : 0xFFFFFFFF;
+	}
+
+	void buildTable(Table &table, bool msbFirst, uint32 offset, uint8 usedBits, uint8 tableBits,
+	                const Array<uint32> &indices, const uint32 *codes, const uint8 *lengths);
+
+	/** Lookup tables for MSB first [0] and LSB first [1] bit streams. */
+	Table _tables[2];
 
-	/** Lists of codes and their symbols, sorted by code length. */
-	CodeLists _codes;
+	/** Index bits of the primary lookup table. */
+	uint8 _lookupBits;
 
-	/** Sorted list of pointers to the symbols. */
-	SymbolList _symbols;
+	/** The symbols, by code index. */
+	Array<uint32> _symbols;
 };
 
 } // End of namespace Common
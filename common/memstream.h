@@ -25,6 +25,7 @@
 
 #include "common/stream.h"
 #include "common/types.h"
+#include "common/util.h"
 
 namespace Common {
 
@@ -135,7 +136,9 @@ private:
 
 		byte *old_data = _data;
 
-		_capacity = new_len + 32;
+		// Grow geometrically, so that many small writes don't copy the
+		// data over and over again
+		_capacity = MAX(new_len + 32, _capacity * 2);
 		_data = (byte *)malloc(_capacity);
 		_ptr = _data + _pos;
 
@@ -122,6 +122,23 @@ public:
 	 */
 	virtual OutSaveFile *openForSaving(const String &name, bool compress = true) = 0;
 
+	/**
+	 * Open the savefile with the specified name in the given directory for
+	 * saving, for savefiles which are written again and again with mostly
+	 * the same data, like autosaves.
+	 *
+	 * The savefile manager may then only store the changes against an
+	 * earlier version of the savefile. openForLoading() still returns the
+	 * complete data. Managers without such a format open the savefile with
+	 * openForSaving().
+	 *
+	 * @param name		the name of the savefile
+	 * @param compress	toggles whether to compress the resulting save file
+	 * 					(default) or not.
+	 * @return pointer to an OutSaveFile, or NULL if an error occurred.
+	 */
+	virtual OutSaveFile *openForSavingDelta(const String &name, bool compress = true) { return openForSaving(name, compress); }
+
 	/**
 	 * Open the file with the specified name in the given directory for loading.
 	 * @param name	the name of the savefile
@@ -161,6 +178,26 @@ public:
 	 * @see Common::matchString()
 	 */
 	virtual StringArray listSavefiles(const String &pattern) = 0;
+
+	/**
+	 * Query the size and modification time of the given savefile. Together
+	 * they tell whether a savefile changed since an earlier session.
+	 * @param name				the name of the savefile
+	 * @param size				the size of the stored savefile
+	 * @param modificationTime	the modification time, in seconds
+	 * @return true if the information is available, false otherwise.
+	 */
+	virtual bool getSavefileInfo(const String &name, uint32 &size, uint32 &modificationTime) { return false; }
+
+	/**
+	 * Returns a number which changes whenever a savefile is written or
+	 * removed through this manager. Information read from the savefiles,
+	 * like the savegame descriptions and thumbnails, can be kept for as long
+	 * as it stays the same.
+	 * @return the change count, or 0 if the manager doesn't keep track of
+	 *         changes, in which case nothing should be kept.
+	 */
+	virtual uint32 getChangeCount() const { return 0; }
 };
 
 } // End of namespace Common
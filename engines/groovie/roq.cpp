@@ -40,10 +40,20 @@
 #include "audio/mixer.h"
 #include "audio/decoders/raw.h"
 
+// The YUV to RGB conversion of the show buffer handles eight pixels at once
+// with SSE2 or NEON. The results are bit-exact with the lookup tables.
+#if defined(__SSE2__)
+#define ROQ_SHOWBUF_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define ROQ_SHOWBUF_NEON
+#include <arm_neon.h>
+#endif
+
 namespace Groovie {
 
 ROQPlayer::ROQPlayer(GroovieEngine *vm) :
-	VideoPlayer(vm), _codingTypeCount(0),
+	VideoPlayer(vm), _codingTypeCount(0), _blockData(NULL), _blockDataAlloc(0), _blockSize(0), _blockPos(0),
 	_fg(&_vm->_graphicsMan->_foreground), _bg(&_vm->_graphicsMan->_background) {
 
 	// Create the work surfaces
@@ -62,6 +72,13 @@ ROQPlayer::ROQPlayer(GroovieEngine *vm) :
 
 		_syst->getPaletteManager()->setPalette(pal, 0, 256);
 	}
+#ifdef USE_RGB_COLOR
+	else {
+		initColorTables();
+		_lineBuf = NULL;
+		_lineBufAlloc = 0;
+	}
+#endif
 }
 
 ROQPlayer::~ROQPlayer() {
@@ -70,6 +87,12 @@ ROQPlayer::~ROQPlayer() {
 	delete _currBuf;
 	_prevBuf->free();
 	delete _prevBuf;
+
+	free(_blockData);
+#ifdef USE_RGB_COLOR
+	if (!_vm->_mode8bit)
+		free(_lineBuf);
+#endif
 }
 
 uint16 ROQPlayer::loadInternal() {
@@ -112,28 +135,183 @@ uint16 ROQPlayer::loadInternal() {
 	}
 }
 
+#ifdef USE_RGB_COLOR
+void ROQPlayer::initColorTables() {
+	// Split Graphics::YUV2RGB into its chroma terms, and RGBToColor into
+	// its channels, so that converting a pixel only takes a few lookups
+	for (int i = 0; i < 256; i++) {
+		_vToR[i] = (1357 * (i - 128)) >> 10;
+		_vToG[i] = (691 * (i - 128)) >> 10;
+		_uToG[i] = (333 * (i - 128)) >> 10;
+		_uToB[i] = (1715 * (i - 128)) >> 10;
+
+		_redColor[i] = _vm->_pixelFormat.RGBToColor(i, 0, 0);
+		_greenColor[i] = (i >> _vm->_pixelFormat.gLoss) << _vm->_pixelFormat.gShift;
+		_blueColor[i] = (i >> _vm->_pixelFormat.bLoss) << _vm->_pixelFormat.bShift;
+	}
+}
+
+void ROQPlayer::convertLine(const byte *in, byte *out, int width) {
+	const Graphics::PixelFormat &format = _vm->_pixelFormat;
+	int x = 0;
+
+#if defined(ROQ_SHOWBUF_SSE2)
+	// The chroma terms are (c * (u - 128)) >> 10. With the difference
+	// scaled by 64 the high half of the 16 bit product gives the same value.
+	const __m128i bias = _mm_set1_epi16(128);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i max = _mm_set1_epi16(255);
+	const __m128i vToR = _mm_set1_epi16(1357);
+	const __m128i vToG = _mm_set1_epi16(691);
+	const __m128i uToG = _mm_set1_epi16(333);
+	const __m128i uToB = _mm_set1_epi16(1715);
+	const __m128i rLoss = _mm_cvtsi32_si128(format.rLoss), rShift = _mm_cvtsi32_si128(format.rShift);
+	const __m128i gLoss = _mm_cvtsi32_si128(format.gLoss), gShift = _mm_cvtsi32_si128(format.gShift);
+	const __m128i bLoss = _mm_cvtsi32_si128(format.bLoss), bShift = _mm_cvtsi32_si128(format.bShift);
+	const uint32 alpha = format.RGBToColor(0, 0, 0);
+
+	for (; x + 8 <= width; x += 8, in += 24) {
+		const __m128i y = _mm_setr_epi16(in[0], in[3], in[6], in[9], in[12], in[15], in[18], in[21]);
+		const __m128i u = _mm_slli_epi16(_mm_sub_epi16(_mm_setr_epi16(in[1], in[4], in[7], in[10], in[13], in[16], in[19], in[22]), bias), 6);
+		const __m128i v = _mm_slli_epi16(_mm_sub_epi16(_mm_setr_epi16(in[2], in[5], in[8], in[11], in[14], in[17], in[20], in[23]), bias), 6);
+
+		__m128i r = _mm_add_epi16(y, _mm_mulhi_epi16(v, vToR));
+		__m128i g = _mm_sub_epi16(_mm_sub_epi16(y, _mm_mulhi_epi16(v, vToG)), _mm_mulhi_epi16(u, uToG));
+		__m128i b = _mm_add_epi16(y, _mm_mulhi_epi16(u, uToB));
+		r = _mm_srl_epi16(_mm_min_epi16(_mm_max_epi16(r, zero), max), rLoss);
+		g = _mm_srl_epi16(_mm_min_epi16(_mm_max_epi16(g, zero), max), gLoss);
+		b = _mm_srl_epi16(_mm_min_epi16(_mm_max_epi16(b, zero), max), bLoss);
+
+		if (format.bytesPerPixel == 2) {
+			__m128i color = _mm_or_si128(_mm_or_si128(_mm_sll_epi16(r, rShift), _mm_sll_epi16(g, gShift)), _mm_sll_epi16(b, bShift));
+			color = _mm_or_si128(color, _mm_set1_epi16(alpha));
+			_mm_storeu_si128((__m128i *)out, color);
+			out += 16;
+		} else {
+			const __m128i a = _mm_set1_epi32(alpha);
+			__m128i color = _mm_or_si128(_mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(r, zero), rShift), _mm_sll_epi32(_mm_unpacklo_epi16(g, zero), gShift)), _mm_sll_epi32(_mm_unpacklo_epi16(b, zero), bShift));
+			_mm_storeu_si128((__m128i *)out, _mm_or_si128(color, a));
+			color = _mm_or_si128(_mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(r, zero), rShift), _mm_sll_epi32(_mm_unpackhi_epi16(g, zero), gShift)), _mm_sll_epi32(_mm_unpackhi_epi16(b, zero), bShift));
+			_mm_storeu_si128((__m128i *)(out + 16), _mm_or_si128(color, a));
+			out += 32;
+		}
+	}
+#elif defined(ROQ_SHOWBUF_NEON)
+	// The chroma terms are (c * (u - 128)) >> 10. With the difference
+	// scaled by 32 the doubling high half product gives the same value.
+	const int16x8_t bias = vdupq_n_s16(128);
+	const int16x8_t zero = vdupq_n_s16(0);
+	const int16x8_t max = vdupq_n_s16(255);
+	const int16x8_t rLoss = vdupq_n_s16(-format.rLoss), gLoss = vdupq_n_s16(-format.gLoss), bLoss = vdupq_n_s16(-format.bLoss);
+	const uint32 alpha = format.RGBToColor(0, 0, 0);
+
+	for (; x + 8 <= width; x += 8, in += 24) {
+		const uint8x8x3_t yuv = vld3_u8(in);
+		const int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(yuv.val[0]));
+		const int16x8_t u = vshlq_n_s16(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(yuv.val[1])), bias), 5);
+		const int16x8_t v = vshlq_n_s16(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(yuv.val[2])), bias), 5);
+
+		const int16x8_t r = vaddq_s16(y, vqdmulhq_n_s16(v, 1357));
+		const int16x8_t g = vsubq_s16(vsubq_s16(y, vqdmulhq_n_s16(v, 691)), vqdmulhq_n_s16(u, 333));
+		const int16x8_t b = vaddq_s16(y, vqdmulhq_n_s16(u, 1715));
+		const uint16x8_t r16 = vshlq_u16(vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(r, zero), max)), rLoss);
+		const uint16x8_t g16 = vshlq_u16(vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(g, zero), max)), gLoss);
+		const uint16x8_t b16 = vshlq_u16(vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(b, zero), max)), bLoss);
+
+		if (format.bytesPerPixel == 2) {
+			const uint16x8_t color = vorrq_u16(vorrq_u16(vshlq_u16(r16, vdupq_n_s16(format.rShift)), vshlq_u16(g16, vdupq_n_s16(format.gShift))), vshlq_u16(b16, vdupq_n_s16(format.bShift)));
+			vst1q_u16((uint16 *)out, vorrq_u16(color, vdupq_n_u16(alpha)));
+			out += 16;
+		} else {
+			const int32x4_t rShift = vdupq_n_s32(format.rShift), gShift = vdupq_n_s32(format.gShift), bShift = vdupq_n_s32(format.bShift);
+			const uint32x4_t a = vdupq_n_u32(alpha);
+			uint32x4_t color = vorrq_u32(vorrq_u32(vshlq_u32(vmovl_u16(vget_low_u16(r16)), rShift), vshlq_u32(vmovl_u16(vget_low_u16(g16)), gShift)), vshlq_u32(vmovl_u16(vget_low_u16(b16)), bShift));
+			vst1q_u32((uint32 *)out, vorrq_u32(color, a));
+			color = vorrq_u32(vorrq_u32(vshlq_u32(vmovl_u16(vget_high_u16(r16)), rShift), vshlq_u32(vmovl_u16(vget_high_u16(g16)), gShift)), vshlq_u32(vmovl_u16(vget_high_u16(b16)), bShift));
+			vst1q_u32((uint32 *)(out + 16), vorrq_u32(color, a));
+			out += 32;
+		}
+	}
+#endif
+
+	// The remaining pixels, or all of them without SIMD, use the tables
+	for (; x < width; x++, in += 3) {
+		const int y = in[0];
+		const int r = CLIP<int>(y + _vToR[in[2]], 0, 255);
+		const int g = CLIP<int>(y - _vToG[in[2]] - _uToG[in[1]], 0, 255);
+		const int b = CLIP<int>(y + _uToB[in[1]], 0, 255);
+		const uint32 color = _redColor[r] | _greenColor[g] | _blueColor[b];
+
+		if (format.bytesPerPixel == 2)
+			*(uint16 *)out = color;
+		else
+			*(uint32 *)out = color;
+		out += format.bytesPerPixel;
+	}
+}
+#endif // USE_RGB_COLOR
+
 void ROQPlayer::buildShowBuf() {
+	const int bytesPerPixel = _vm->_pixelFormat.bytesPerPixel;
+	const int lineSize = _bg->w * bytesPerPixel;
+
 	for (int line = 0; line < _bg->h; line++) {
 		byte *out = (byte *)_bg->getBasePtr(0, line);
-		byte *in = (byte *)_currBuf->getBasePtr(0, line / _scaleY);
-		for (int x = 0; x < _bg->w; x++) {
-			if (_vm->_mode8bit) {
-				// Just use the luminancy component
-				*out = *in;
+
+		// The lines repeated by the vertical scaling are just copied
+		if (line % _scaleY) {
+			memcpy(out, out - _bg->pitch, lineSize);
+			continue;
+		}
+
+		const int inLine = MIN<int>(line / _scaleY, _currBuf->h - 1);
+		const byte *in = (const byte *)_currBuf->getBasePtr(0, inLine);
+		const byte *inLast = (const byte *)_currBuf->getBasePtr(_currBuf->w - 1, inLine);
+
+		// Each input pixel is converted once and then repeated for the
+		// horizontal scaling: the first output pixel comes from the first
+		// input pixel, and every following one from the next _scaleX pixels
+		if (_vm->_mode8bit) {
+			// Just use the luminancy component
+			for (int x = 0; x < _bg->w; x++) {
+				*out++ = *in;
+				if (!(x % _scaleX) && in < inLast)
+					in += 3;
+			}
 #ifdef USE_RGB_COLOR
-			} else {
-				// Do the format conversion (YUV -> RGB -> Screen format)
-				byte r, g, b;
-				Graphics::YUV2RGB(*in, *(in + 1), *(in + 2), r, g, b);
-				// FIXME: this is fixed to 16bit
-				*(uint16 *)out = (uint16)_vm->_pixelFormat.RGBToColor(r, g, b);
-#endif // USE_RGB_COLOR
+		} else {
+			// Do the format conversion (YUV -> RGB -> Screen format) of the
+			// whole input line, then repeat the colors
+			const int inWidth = _currBuf->w;
+			if (_scaleX == 1 && _bg->w <= inWidth) {
+				convertLine(in, out, _bg->w);
+				continue;
 			}
 
-			// Skip to the next pixel
-			out += _vm->_pixelFormat.bytesPerPixel;
-			if (!(x % _scaleX))
-				in += _currBuf->format.bytesPerPixel;
+			if ((uint32)(inWidth * bytesPerPixel) > _lineBufAlloc) {
+				free(_lineBuf);
+				_lineBufAlloc = inWidth * bytesPerPixel;
+				_lineBuf = (byte *)malloc(_lineBufAlloc);
+			}
+			convertLine(in, _lineBuf, inWidth);
+
+			int pos = 0;
+			if (bytesPerPixel == 2) {
+				const uint16 *colors = (const uint16 *)_lineBuf;
+				for (int x = 0; x < _bg->w; x++) {
+					((uint16 *)out)[x] = colors[pos];
+					if (!(x % _scaleX) && pos < inWidth - 1)
+						pos++;
+				}
+			} else {
+				const uint32 *colors = (const uint32 *)_lineBuf;
+				for (int x = 0; x < _bg->w; x++) {
+					((uint32 *)out)[x] = colors[pos];
+					if (!(x % _scaleX) && pos < inWidth - 1)
+						pos++;
+				}
+			}
+#endif // USE_RGB_COLOR
 		}
 	}
 
@@ -187,6 +365,25 @@ bool ROQPlayer::readBlockHeader(ROQBlockHeader &blockHeader) {
 	}
 }
 
+void ROQPlayer::readBlockData(uint32 size) {
+	// Read the whole block at once instead of byte by byte while decoding
+	if (size > _blockDataAlloc) {
+		free(_blockData);
+		_blockData = (byte *)malloc(size);
+		_blockDataAlloc = size;
+	}
+
+	_blockSize = _file->read(_blockData, size);
+	_blockPos = 0;
+}
+
+inline byte ROQPlayer::readBlockByte() {
+	// Reading past the end of the block behaves like the end of the file
+	byte value = (_blockPos < _blockSize) ? _blockData[_blockPos] : 0;
+	_blockPos++;
+	return value;
+}
+
 bool ROQPlayer::processBlock() {
 	// Read the header of the block
 	ROQBlockHeader blockHeader;
@@ -323,19 +520,25 @@ bool ROQPlayer::processBlockQuadCodebook(ROQBlockHeader &blockHeader) {
 	}
 
 	// Read the 2x2 codebook
+	readBlockData(blockHeader.size);
 	for (int i = 0; i < newNum2blocks; i++) {
 		// Read the 4 Y components and their alpha channel
 		for (int j = 0; j < 4; j++) {
-			_codebook2[i * 10 + j * 2] = _file->readByte();
-			_codebook2[i * 10 + j * 2 + 1] = _alpha ? _file->readByte() : 255;
+			_codebook2[i * 10 + j * 2] = readBlockByte();
+			_codebook2[i * 10 + j * 2 + 1] = _alpha ? readBlockByte() : 255;
 		}
 
 		// Read the subsampled Cb and Cr
-		_file->read(&_codebook2[i * 10 + 8], 2);
+		_codebook2[i * 10 + 8] = readBlockByte();
+		_codebook2[i * 10 + 9] = readBlockByte();
+
+		expandCodebook2(i);
 	}
 
 	// Read the 4x4 codebook
-	_file->read(_codebook4, _num4blocks * 4);
+	for (int i = 0; i < _num4blocks * 4; i++) {
+		_codebook4[i] = readBlockByte();
+	}
 
 	return true;
 }
@@ -347,8 +550,8 @@ bool ROQPlayer::processBlockQuadVector(ROQBlockHeader &blockHeader) {
 	int8 Mx = blockHeader.param >> 8;
 	int8 My = blockHeader.param & 0xFF;
 
-	// Calculate where the block should end
-	int32 endpos =_file->pos() + blockHeader.size;
+	// Read ahead the whole block
+	readBlockData(blockHeader.size);
 
 	// Reset the coding types
 	_codingTypeCount = 0;
@@ -365,13 +568,11 @@ bool ROQPlayer::processBlockQuadVector(ROQBlockHeader &blockHeader) {
 		}
 	}
 
-	// HACK: Skip the remaining bytes
-	int32 skipBytes = endpos -_file->pos();
-	if (skipBytes > 0) {
-		_file->skip(skipBytes);
-		if (skipBytes != 2) {
-			warning("Groovie::ROQ: Skipped %d bytes", skipBytes);
-		}
+	// HACK: Ignore the remaining bytes
+	if (_blockPos > _blockSize) {
+		warning("Groovie::ROQ: Read %d bytes past the end of the block", _blockPos - _blockSize);
+	} else if (_blockPos < _blockSize && _blockSize - _blockPos != 2) {
+		warning("Groovie::ROQ: Skipped %d bytes", _blockSize - _blockPos);
 	}
 	return true;
 }
@@ -382,7 +583,7 @@ void ROQPlayer::processBlockQuadVectorBlock(int baseX, int baseY, int8 Mx, int8
 	case 0: // MOT: Skip block
 		break;
 	case 1: { // FCC: Copy an existing block
-		byte argument = _file->readByte();
+		byte argument = readBlockByte();
 		int16 DDx = 8 - (argument >> 4);
 		int16 DDy = 8 - (argument & 0x0F);
 		copy(8, baseX, baseY, DDx - Mx, DDy - My);
@@ -390,7 +591,7 @@ void ROQPlayer::processBlockQuadVectorBlock(int baseX, int baseY, int8 Mx, int8
 	}
 	case 2: // SLD: Quad vector quantisation
 		// Upsample the 4x4 pixel block
-		paint8(_file->readByte(), baseX, baseY);
+		paint8(readBlockByte(), baseX, baseY);
 		break;
 	case 3: // CCC:
 		// Traverse the block in 4x4 sub-blocks
@@ -411,20 +612,20 @@ void ROQPlayer::processBlockQuadVectorBlockSub(int baseX, int baseY, int8 Mx, in
 	case 0: // MOT: Skip block
 		break;
 	case 1: { // FCC: Copy an existing block
-		byte argument = _file->readByte();
+		byte argument = readBlockByte();
 		int16 DDx = 8 - (argument >> 4);
 		int16 DDy = 8 - (argument & 0x0F);
 		copy(4, baseX, baseY, DDx - Mx, DDy - My);
 		break;
 	}
 	case 2: // SLD: Quad vector quantisation
-		paint4(_file->readByte(), baseX, baseY);
+		paint4(readBlockByte(), baseX, baseY);
 		break;
 	case 3:
-		paint2(_file->readByte(), baseX    , baseY);
-		paint2(_file->readByte(), baseX + 2, baseY);
-		paint2(_file->readByte(), baseX    , baseY + 2);
-		paint2(_file->readByte(), baseX + 2, baseY + 2);
+		paint2(readBlockByte(), baseX    , baseY);
+		paint2(readBlockByte(), baseX + 2, baseY);
+		paint2(readBlockByte(), baseX    , baseY + 2);
+		paint2(readBlockByte(), baseX + 2, baseY + 2);
 		break;
 	}
 }
@@ -473,8 +674,9 @@ bool ROQPlayer::processBlockSoundMono(ROQBlockHeader &blockHeader) {
 	int16 prediction = blockHeader.param ^ 0x8000;
 
 	// Process the data
+	readBlockData(blockHeader.size);
 	for (uint16 i = 0; i < blockHeader.size; i++) {
-		int16 data = _file->readByte();
+		int16 data = readBlockByte();
 		if (data < 0x80) {
 			prediction += data * data;
 		} else {
@@ -518,8 +720,9 @@ bool ROQPlayer::processBlockSoundStereo(ROQBlockHeader &blockHeader) {
 	bool left = true;
 
 	// Process the data
+	readBlockData(blockHeader.size);
 	for (uint16 i = 0; i < blockHeader.size; i++) {
-		int16 data = _file->readByte();
+		int16 data = readBlockByte();
 		if (left) {
 			if (data < 0x80) {
 				predictionLeft += data * data;
@@ -558,7 +761,8 @@ bool ROQPlayer::processBlockAudioContainer(ROQBlockHeader &blockHeader) {
 byte ROQPlayer::getCodingType() {
 	_codingType <<= 2;
 	if (!_codingTypeCount) {
-		_codingType = _file->readUint16LE();
+		_codingType = readBlockByte();
+		_codingType |= readBlockByte() << 8;
 		_codingTypeCount = 8;
 	}
 
@@ -566,32 +770,67 @@ byte ROQPlayer::getCodingType() {
 	return (_codingType >> 14);
 }
 
-void ROQPlayer::paint2(byte i, int destx, int desty) {
-	if (i > _num2blocks) {
-		error("Groovie::ROQ: Invalid 2x2 block %d (%d available)", i, _num2blocks);
-	}
+void ROQPlayer::expandCodebook2(int i) {
+	const byte *block = &_codebook2[i * 10];
+	byte *expanded = &_expanded2[i * 2 * 2 * 3];
+	byte *expanded2x = &_expanded2x2[i * 4 * 4 * 3];
 
-	byte *block = &_codebook2[i * 10];
-	byte u = block[8];
-	byte v = block[9];
+	// Basic alpha test
+	// TODO: Blending
+	_opaque2[i] = true;
+	for (int p = 0; p < 4; p++) {
+		if (block[p * 2 + 1] <= 128)
+			_opaque2[i] = false;
+	}
 
-	byte *ptr = (byte *)_currBuf->getBasePtr(destx, desty);
 	for (int y = 0; y < 2; y++) {
 		for (int x = 0; x < 2; x++) {
-			// Basic alpha test
-			// TODO: Blending
-			if (*(block + 1) > 128) {
-				*ptr = *block;
-				*(ptr + 1) = u;
-				*(ptr + 2) = v;
+			const byte pixel[3] = { block[(y * 2 + x) * 2], block[8], block[9] };
+			memcpy(&expanded[(y * 2 + x) * 3], pixel, 3);
+
+			for (int repy = 0; repy < 2; repy++) {
+				for (int repx = 0; repx < 2; repx++) {
+					memcpy(&expanded2x[((y * 2 + repy) * 4 + x * 2 + repx) * 3], pixel, 3);
+				}
+			}
+		}
+	}
+}
+
+void ROQPlayer::paintExpanded2(byte i, byte *dst, uint scale) {
+	const uint size = 2 * scale;
+	const uint rowSize = size * 3;
+	const byte *src = (scale == 1) ? &_expanded2[i * 2 * 2 * 3] : &_expanded2x2[i * 4 * 4 * 3];
+
+	if (_opaque2[i]) {
+		// Paint whole rows
+		for (uint y = 0; y < size; y++) {
+			memcpy(dst, src, rowSize);
+			dst += _currBuf->pitch;
+			src += rowSize;
+		}
+	} else {
+		// Only paint the pixels that pass the alpha test
+		const byte *block = &_codebook2[i * 10];
+		for (uint y = 0; y < size; y++) {
+			for (uint x = 0; x < size; x++) {
+				if (block[((y / scale) * 2 + x / scale) * 2 + 1] > 128)
+					memcpy(dst + x * 3, src + x * 3, 3);
 			}
-			ptr += 3;
-			block += 2;
+			dst += _currBuf->pitch;
+			src += rowSize;
 		}
-		ptr += _currBuf->pitch - 6;
 	}
 }
 
+void ROQPlayer::paint2(byte i, int destx, int desty) {
+	if (i > _num2blocks) {
+		error("Groovie::ROQ: Invalid 2x2 block %d (%d available)", i, _num2blocks);
+	}
+
+	paintExpanded2(i, (byte *)_currBuf->getBasePtr(destx, desty), 1);
+}
+
 void ROQPlayer::paint4(byte i, int destx, int desty) {
 	if (i > _num4blocks) {
 		error("Groovie::ROQ: Invalid 4x4 block %d (%d available)", i, _num4blocks);
@@ -611,30 +850,12 @@ void ROQPlayer::paint8(byte i, int destx, int desty) {
 		error("Groovie::ROQ: Invalid 4x4 block %d (%d available)", i, _num4blocks);
 	}
 
+	// Paint each 2x2 block of the 4x4 one upsampled to 4x4 pixels
 	byte *block4 = &_codebook4[i * 4];
 	for (int y4 = 0; y4 < 2; y4++) {
 		for (int x4 = 0; x4 < 2; x4++) {
-			byte *block2 = &_codebook2[(*block4) * 10];
-			byte u = block2[8];
-			byte v = block2[9];
+			paintExpanded2(*block4, (byte *)_currBuf->getBasePtr(destx + x4 * 4, desty + y4 * 4), 2);
 			block4++;
-			for (int y2 = 0; y2 < 2; y2++) {
-				for (int x2 = 0; x2 < 2; x2++) {
-					for (int repy = 0; repy < 2; repy++) {
-						for (int repx = 0; repx < 2; repx++) {
-							// Basic alpha test
-							// TODO: Blending
-							if (*(block2 + 1) > 128) {
-								byte *ptr = (byte *)_currBuf->getBasePtr(destx + x4*4 + x2*2 + repx, desty + y4*4 + y2*2 + repy);
-								*ptr = *block2;
-								*(ptr + 1) = u;
-								*(ptr + 2) = v;
-							}
-						}
-					}
-					block2 += 2;
-				}
-			}
 		}
 	}
 }
@@ -47,6 +47,14 @@ protected:
 private:
 	bool readBlockHeader(ROQBlockHeader &blockHeader);
 
+	// Read-ahead of the block data, decoded from memory
+	void readBlockData(uint32 size);
+	byte readBlockByte();
+	byte *_blockData;
+	uint32 _blockDataAlloc;
+	uint32 _blockSize;
+	uint32 _blockPos;
+
 	bool processBlock();
 	bool processBlockInfo(ROQBlockHeader &blockHeader);
 	bool processBlockQuadCodebook(ROQBlockHeader &blockHeader);
@@ -61,6 +69,7 @@ private:
 	void paint2(byte i, int destx, int desty);
 	void paint4(byte i, int destx, int desty);
 	void paint8(byte i, int destx, int desty);
+	void paintExpanded2(byte i, byte *dst, uint scale);
 	void copy(byte size, int destx, int desty, int offx, int offy);
 
 	// Block coding type
@@ -74,6 +83,13 @@ private:
 	byte _codebook2[256 * 10];
 	byte _codebook4[256 * 4];
 
+	// The 2x2 codebook expanded to YUV pixels, at 1x and 2x size, so that
+	// opaque blocks can be painted with a row copy
+	void expandCodebook2(int i);
+	byte _expanded2[256 * 2 * 2 * 3];
+	byte _expanded2x2[256 * 4 * 4 * 3];
+	bool _opaque2[256];
+
 	// Buffers
 	Graphics::Surface *_fg, *_bg, *_thirdBuf;
 	Graphics::Surface *_currBuf, *_prevBuf;
@@ -83,6 +99,18 @@ private:
 	bool _dirty;
 	byte _alpha;
 
+#ifdef USE_RGB_COLOR
+	// YUV to screen color conversion tables
+	void initColorTables();
+	int16 _vToR[256], _vToG[256], _uToG[256], _uToB[256];
+	uint32 _redColor[256], _greenColor[256], _blueColor[256];
+
+	// Converts a line of YUV pixels to the screen format
+	void convertLine(const byte *in, byte *out, int width);
+	byte *_lineBuf;
+	uint32 _lineBufAlloc;
+#endif
+
 };
 
 } // End of Groovie namespace
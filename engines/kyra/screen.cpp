@@ -1443,68 +1443,75 @@ void Screen::drawShape(uint8 pageNum, const uint8 *shapeData, int x, int y, int
 		&Screen::drawShapeSkipScaleDownwind
 	};
 
-	static const DsLineFunc dsLineFunc[] = {
-		&Screen::drawShapeProcessLineNoScaleUpwind,
-		&Screen::drawShapeProcessLineNoScaleDownwind,
-		&Screen::drawShapeProcessLineNoScaleUpwind,
-		&Screen::drawShapeProcessLineNoScaleDownwind,
-		&Screen::drawShapeProcessLineScaleUpwind,
-		&Screen::drawShapeProcessLineScaleDownwind,
-		&Screen::drawShapeProcessLineScaleUpwind,
-		&Screen::drawShapeProcessLineScaleDownwind
+	// The line functions for each plot type, for drawing without and with
+	// scaling, each from left to right and flipped
+#define DS_LINE_FUNCS(plot) { \
+		&Screen::drawShapeProcessLineNoScaleUpwind<&Screen::plot>, \
+		&Screen::drawShapeProcessLineNoScaleDownwind<&Screen::plot>, \
+		&Screen::drawShapeProcessLineScaleUpwind<&Screen::plot>, \
+		&Screen::drawShapeProcessLineScaleDownwind<&Screen::plot> \
+	}
+#define DS_NO_LINE_FUNCS { 0, 0, 0, 0 }
+
+	static const DsLineFunc dsLineFunc[][4] = {
+		DS_LINE_FUNCS(drawShapePlotType0),	// used by Kyra 1 + 2
+		DS_LINE_FUNCS(drawShapePlotType1),	// used by Kyra 3
+		DS_NO_LINE_FUNCS,
+		DS_LINE_FUNCS(drawShapePlotType3_7),	// used by Kyra 3 (shadow)
+		DS_LINE_FUNCS(drawShapePlotType4),	// used by Kyra 1, 2 + 3
+		DS_LINE_FUNCS(drawShapePlotType5),	// used by Kyra 1
+		DS_LINE_FUNCS(drawShapePlotType6),	// used by Kyra 1 (invisibility)
+		DS_LINE_FUNCS(drawShapePlotType3_7),	// used by Kyra 1 (invisibility)
+		DS_LINE_FUNCS(drawShapePlotType8),	// used by Kyra 2
+		DS_LINE_FUNCS(drawShapePlotType9),	// used by Kyra 1 + 3
+		DS_NO_LINE_FUNCS,
+		DS_LINE_FUNCS(drawShapePlotType11_15),	// used by Kyra 1 (invisibility) + Kyra 3 (shadow)
+		DS_LINE_FUNCS(drawShapePlotType12),	// used by Kyra 2
+		DS_LINE_FUNCS(drawShapePlotType13),	// used by Kyra 1
+		DS_LINE_FUNCS(drawShapePlotType14),	// used by Kyra 1 (invisibility)
+		DS_LINE_FUNCS(drawShapePlotType11_15),	// used by Kyra 1 (invisibility)
+		DS_LINE_FUNCS(drawShapePlotType16),	// used by LoL PC-98/16 Colors (teleporters),
+		DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS,
+		DS_LINE_FUNCS(drawShapePlotType20),	// used by LoL (heal spell effect)
+		DS_LINE_FUNCS(drawShapePlotType21),	// used by LoL (white tower spirits)
+		DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS,
+		DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS,
+		DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS,
+		DS_LINE_FUNCS(drawShapePlotType33),	// used by LoL (blood spots on the floor)
+		DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS,
+		DS_LINE_FUNCS(drawShapePlotType37),	// used by LoL (monsters)
+		DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS,
+		DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS,
+		DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS,
+		DS_LINE_FUNCS(drawShapePlotType48),	// used by LoL (slime spots on the floor)
+		DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS,
+		DS_LINE_FUNCS(drawShapePlotType52),	// used by LoL (projectiles)
+		DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS,
+		DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS,
+		DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS, DS_NO_LINE_FUNCS
 	};
 
-	static const DsPlotFunc dsPlotFunc[] = {
-		&Screen::drawShapePlotType0,		// used by Kyra 1 + 2
-		&Screen::drawShapePlotType1,		// used by Kyra 3
-		0,
-		&Screen::drawShapePlotType3_7,		// used by Kyra 3 (shadow)
-		&Screen::drawShapePlotType4,		// used by Kyra 1, 2 + 3
-		&Screen::drawShapePlotType5,		// used by Kyra 1
-		&Screen::drawShapePlotType6,		// used by Kyra 1 (invisibility)
-		&Screen::drawShapePlotType3_7,		// used by Kyra 1 (invisibility)
-		&Screen::drawShapePlotType8,		// used by Kyra 2
-		&Screen::drawShapePlotType9,		// used by Kyra 1 + 3
-		0,
-		&Screen::drawShapePlotType11_15,	// used by Kyra 1 (invisibility) + Kyra 3 (shadow)
-		&Screen::drawShapePlotType12,		// used by Kyra 2
-		&Screen::drawShapePlotType13,		// used by Kyra 1
-		&Screen::drawShapePlotType14,		// used by Kyra 1 (invisibility)
-		&Screen::drawShapePlotType11_15,	// used by Kyra 1 (invisibility)
-		&Screen::drawShapePlotType16,		// used by LoL PC-98/16 Colors (teleporters),
-		0, 0, 0,
-		&Screen::drawShapePlotType20,		// used by LoL (heal spell effect)
-		&Screen::drawShapePlotType21,		// used by LoL (white tower spirits)
-		0, 0, 0, 0,	0, 0, 0, 0, 0, 0,
-		0,
-		&Screen::drawShapePlotType33,		// used by LoL (blood spots on the floor)
-		0, 0, 0,
-		&Screen::drawShapePlotType37,		// used by LoL (monsters)
-		0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-		&Screen::drawShapePlotType48,		// used by LoL (slime spots on the floor)
-		0, 0, 0,
-		&Screen::drawShapePlotType52,		// used by LoL (projectiles)
-		0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-		0
-	};
+#undef DS_LINE_FUNCS
+#undef DS_NO_LINE_FUNCS
 
 	int scaleCounterV = 0;
 
 	const int drawFunc = flags & 0x0f;
 	_dsProcessMargin = dsMarginFunc[drawFunc];
 	_dsScaleSkip = dsSkipFunc[drawFunc];
-	_dsProcessLine = dsLineFunc[drawFunc];
 
+	// Select the line functions once, the mask only switches between the
+	// plot types of the same scaling and direction
+	const int lineFunc = ((flags & DSF_SCALE) ? 2 : 0) | (flags & DSF_X_FLIPPED);
 	const int ppc = (flags >> 8) & 0x3F;
-	_dsPlot = dsPlotFunc[ppc];
-	DsPlotFunc dsPlot2 = dsPlotFunc[ppc], dsPlot3 = dsPlotFunc[ppc];
+	DsLineFunc dsLine2 = dsLineFunc[ppc][lineFunc], dsLine3 = dsLineFunc[ppc][lineFunc];
 	if (flags & 0x800)
-		dsPlot3 = dsPlotFunc[((flags >> 8) & 0xF7) & 0x3F];
+		dsLine3 = dsLineFunc[((flags >> 8) & 0xF7) & 0x3F][lineFunc];
 
-	if (!_dsPlot || !dsPlot2 || !dsPlot3) {
-		if (!dsPlot2)
+	if (!dsLine2 || !dsLine3) {
+		if (!dsLine2)
 			warning("Missing drawShape plotting method type %d", ppc);
-		if (dsPlot3 != dsPlot2 && !dsPlot3)
+		if (dsLine3 != dsLine2 && !dsLine3)
 			warning("Missing drawShape plotting method type %d", (((flags >> 8) & 0xF7) & 0x3F));
 		return;
 	}
@@ -1687,8 +1694,7 @@ void Screen::drawShape(uint8 pageNum, const uint8 *shapeData, int x, int y, int
 				if (cnt > 0) {
 					if (flags & 0x800)
 						normalPlot = (curY > _maskMinY && curY < _maskMaxY);
-					_dsPlot = normalPlot ? dsPlot2 : dsPlot3;
-					(this->*_dsProcessLine)(d, src, cnt, scaleState);
+					(this->*(normalPlot ? dsLine2 : dsLine3))(d, src, cnt, scaleState);
 				}
 				cnt += _dsOffscreenRight;
 				if (cnt)
@@ -1816,12 +1822,13 @@ int Screen::drawShapeSkipScaleDownwind(uint8 *&dst, const uint8 *&src, int &cnt)
 	return found ? 0 : _dsOffscreenScaleVal1;
 }
 
+template<Screen::DsPlotFunc plot>
 void Screen::drawShapeProcessLineNoScaleUpwind(uint8 *&dst, const uint8 *&src, int &cnt, int16) {
 	do {
 		uint8 c = *src++;
 		if (c) {
 			uint8 *d = dst++;
-			(this->*_dsPlot)(d, c);
+			(this->*plot)(d, c);
 			cnt--;
 		} else {
 			c = *src++;
@@ -1831,12 +1838,13 @@ void Screen::drawShapeProcessLineNoScaleUpwind(uint8 *&dst, const uint8 *&src, i
 	} while (cnt > 0);
 }
 
+template<Screen::DsPlotFunc plot>
 void Screen::drawShapeProcessLineNoScaleDownwind(uint8 *&dst, const uint8 *&src, int &cnt, int16) {
 	do {
 		uint8 c = *src++;
 		if (c) {
 			uint8 *d = dst--;
-			(this->*_dsPlot)(d, c);
+			(this->*plot)(d, c);
 			cnt--;
 		} else {
 			c = *src++;
@@ -1846,6 +1854,7 @@ void Screen::drawShapeProcessLineNoScaleDownwind(uint8 *&dst, const uint8 *&src,
 	} while (cnt > 0);
 }
 
+template<Screen::DsPlotFunc plot>
 void Screen::drawShapeProcessLineScaleUpwind(uint8 *&dst, const uint8 *&src, int &cnt, int16 scaleState) {
 	int c = 0;
 
@@ -1865,7 +1874,7 @@ void Screen::drawShapeProcessLineScaleUpwind(uint8 *&dst, const uint8 *&src, int
 				scaleState = r & 0xff;
 			}
 		} else if (scaleState) {
-			(this->*_dsPlot)(dst++, c);
+			(this->*plot)(dst++, c);
 			scaleState -= 0x100;
 			cnt--;
 		}
@@ -1874,6 +1883,7 @@ void Screen::drawShapeProcessLineScaleUpwind(uint8 *&dst, const uint8 *&src, int
 	cnt = -1;
 }
 
+template<Screen::DsPlotFunc plot>
 void Screen::drawShapeProcessLineScaleDownwind(uint8 *&dst, const uint8 *&src, int &cnt, int16 scaleState) {
 	int c = 0;
 
@@ -1893,7 +1903,7 @@ void Screen::drawShapeProcessLineScaleDownwind(uint8 *&dst, const uint8 *&src, i
 				scaleState = r & 0xff;
 			}
 		} else {
-			(this->*_dsPlot)(dst--, c);
+			(this->*plot)(dst--, c);
 			scaleState -= 0x100;
 			cnt--;
 		}
@@ -68,11 +68,21 @@ void MohawkSurface::convertToTrueColor() {
 	_surface = surface;
 }
 
-GraphicsManager::GraphicsManager() {
+// Prefetched images stay within this many bytes, about sixteen Riven
+// cards in 32bpp
+static const uint32 kPrefetchBudget = 16 * 1024 * 1024;
+
+static uint32 getImageSize(const MohawkSurface *image) {
+	const Graphics::Surface *surface = image->getSurface();
+	return surface->pitch * surface->h + (image->getPalette() ? 256 * 3 : 0);
+}
+
+GraphicsManager::GraphicsManager() : _prefetchSize(0) {
 }
 
 GraphicsManager::~GraphicsManager() {
 	clearCache();
+	clearPrefetchCache();
 }
 
 void GraphicsManager::clearCache() {
@@ -89,8 +99,18 @@ void GraphicsManager::clearCache() {
 }
 
 MohawkSurface *GraphicsManager::findImage(uint16 id) {
-	if (!_cache.contains(id))
-		_cache[id] = decodeImage(id);
+	if (!_cache.contains(id)) {
+		Common::HashMap<uint16, MohawkSurface *>::iterator it = _prefetchCache.find(id);
+
+		if (it != _prefetchCache.end()) {
+			// The image is now owned by the regular cache
+			_cache[id] = it->_value;
+			_prefetchSize -= getImageSize(it->_value);
+			_prefetchCache.erase(it);
+			_prefetchOrder.remove(id);
+		} else
+			_cache[id] = decodeImage(id);
+	}
 
 	// TODO: Probably would be nice to limit the size of the cache
 	// Currently, this can't get large because it is freed on every
@@ -108,6 +128,63 @@ void GraphicsManager::preloadImage(uint16 image) {
 	findImage(image);
 }
 
+void GraphicsManager::prefetchImages(const Common::Array<uint16> &images) {
+	_prefetchQueue.clear();
+
+	for (uint i = 0; i < images.size(); i++)
+		_prefetchQueue.push_back(images[i]);
+}
+
+bool GraphicsManager::runPrefetch(uint32 timeLimit) {
+	if (_prefetchQueue.empty())
+		return false;
+
+	uint32 startTime = getVM()->_system->getMillis();
+
+	do {
+		uint16 id = _prefetchQueue.front();
+		_prefetchQueue.pop_front();
+
+		if (_cache.contains(id) || _prefetchCache.contains(id))
+			continue;
+
+		// The ids come from cards which may never be visited, so don't let
+		// a missing image become an error here
+		if (!hasImage(id))
+			continue;
+
+		MohawkSurface *image = decodeImage(id);
+		_prefetchCache[id] = image;
+		_prefetchOrder.push_back(id);
+		_prefetchSize += getImageSize(image);
+		evictPrefetchedImages();
+	} while (!_prefetchQueue.empty() && getVM()->_system->getMillis() - startTime < timeLimit);
+
+	return true;
+}
+
+void GraphicsManager::evictPrefetchedImages() {
+	while (_prefetchSize > kPrefetchBudget && !_prefetchOrder.empty()) {
+		uint16 id = _prefetchOrder.front();
+		_prefetchOrder.pop_front();
+
+		MohawkSurface *image = _prefetchCache[id];
+		_prefetchSize -= getImageSize(image);
+		_prefetchCache.erase(id);
+		delete image;
+	}
+}
+
+void GraphicsManager::clearPrefetchCache() {
+	for (Common::HashMap<uint16, MohawkSurface *>::iterator it = _prefetchCache.begin(); it != _prefetchCache.end(); it++)
+		delete it->_value;
+
+	_prefetchCache.clear();
+	_prefetchOrder.clear();
+	_prefetchQueue.clear();
+	_prefetchSize = 0;
+}
+
 void GraphicsManager::setPalette(uint16 id) {
 	Common::SeekableReadStream *tpalStream = getVM()->getResource(ID_TPAL, id);
 
@@ -227,6 +304,14 @@ void GraphicsManager::addImageToCache(uint16 id, MohawkSurface *surface) {
 	if (_cache.contains(id))
 		error("Image %d already in cache", id);
 
+	if (_prefetchCache.contains(id)) {
+		MohawkSurface *image = _prefetchCache[id];
+		_prefetchSize -= getImageSize(image);
+		_prefetchCache.erase(id);
+		_prefetchOrder.remove(id);
+		delete image;
+	}
+
 	_cache[id] = surface;
 }
 
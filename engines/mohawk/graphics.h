@@ -26,6 +26,7 @@
 #include "mohawk/bitmap.h"
 
 #include "common/hashmap.h"
+#include "common/list.h"
 #include "common/rect.h"
 
 namespace Graphics {
@@ -72,9 +73,25 @@ public:
 	virtual ~GraphicsManager();
 
 	// Free all surfaces in the cache
+	// Prefetched images are kept, see clearPrefetchCache()
 	void clearCache();
 
 	void preloadImage(uint16 image);
+
+	// Replace the list of images to decode ahead of time, typically the
+	// backgrounds of the cards reachable from the current one. The images are
+	// decoded by runPrefetch() and handed over to the cache by findImage().
+	void prefetchImages(const Common::Array<uint16> &images);
+
+	// Decode queued images until timeLimit milliseconds have passed. Meant to
+	// be called from the idle part of the event loop. Returns false if there
+	// was nothing to decode.
+	bool runPrefetch(uint32 timeLimit);
+
+	// Free all prefetched images and forget the queued ones
+	// This has to be called when the image ids change meaning (new archives).
+	void clearPrefetchCache();
+
 	virtual void setPalette(uint16 id);
 	void copyAnimImageToScreen(uint16 image, int left = 0, int top = 0);
 	void copyAnimImageSectionToScreen(uint16 image, Common::Rect src, Common::Rect dest);
@@ -86,11 +103,16 @@ protected:
 	void copyAnimImageSectionToScreen(MohawkSurface *image, Common::Rect src, Common::Rect dest);
 
 	// findImage will search the cache to find the image.
-	// If not found, it will call decodeImage to get a new one.
+	// If not found, it will take it from the prefetched images or
+	// call decodeImage to get a new one.
 	MohawkSurface *findImage(uint16 id);
 
 	// decodeImage will always return a new image.
 	virtual MohawkSurface *decodeImage(uint16 id) = 0;
+
+	// hasImage tells whether decodeImage can decode the image. Only images
+	// for which it returns true are prefetched.
+	virtual bool hasImage(uint16 id) { return false; }
 	virtual Common::Array<MohawkSurface *> decodeImages(uint16 id);
 
 	virtual MohawkEngine *getVM() = 0;
@@ -100,6 +122,15 @@ private:
 	// An image cache that stores images until clearCache() is called
 	Common::HashMap<uint16, MohawkSurface *> _cache;
 	Common::HashMap<uint16, Common::Array<MohawkSurface *> > _subImageCache;
+
+	// Images decoded ahead of time, and the order they were decoded in so
+	// that the oldest ones are freed first when over budget
+	Common::HashMap<uint16, MohawkSurface *> _prefetchCache;
+	Common::List<uint16> _prefetchOrder;
+	Common::List<uint16> _prefetchQueue;
+	uint32 _prefetchSize;
+
+	void evictPrefetchedImages();
 };
 
 } // End of namespace Mohawk
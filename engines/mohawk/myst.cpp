@@ -20,6 +20,7 @@
  *
  */
 
+#include "common/algorithm.h"
 #include "common/config-manager.h"
 #include "common/debug-channels.h"
 #include "common/system.h"
@@ -365,8 +366,10 @@ Common::Error MohawkEngine_Myst::run() {
 			_needsUpdate = false;
 		}
 
-		// Cut down on CPU usage
-		_system->delayMillis(10);
+		// Use the idle time to decode the images of the next cards, or
+		// cut down on CPU usage if there is nothing left to decode
+		if (!_gfx->runPrefetch(10))
+			_system->delayMillis(10);
 	}
 
 	return Common::kNoError;
@@ -490,9 +493,10 @@ void MohawkEngine_Myst::changeToStack(uint16 stack, uint16 card, uint16 linkSrcS
 
 	_runExitScript = false;
 
-	// Clear the resource cache and the image cache
+	// Clear the resource cache and the image caches
 	_cache.clear();
 	_gfx->clearCache();
+	_gfx->clearPrefetchCache();
 
 	// Play Flyby Entry Movie on Masterpiece Edition.
 	const char *flyby = 0;
@@ -643,6 +647,57 @@ void MohawkEngine_Myst::changeToCard(uint16 card, bool updateScreen) {
 	// Debug: Show resource rects
 	if (_showResourceRects)
 		drawResourceRects();
+
+	prefetchNeighbourCards();
+}
+
+void MohawkEngine_Myst::prefetchNeighbourCards() {
+	// Have the backgrounds of the cards the resources of this card lead to
+	// decoded while the player looks around, as it is what makes changing
+	// cards slow. Conditional backgrounds are chosen with the current state.
+	Common::Array<uint16> cards;
+	Common::Array<uint16> images;
+
+	for (uint16 i = 0; i < _resources.size(); i++) {
+		uint16 dest = _resources[i]->getDest();
+
+		if (dest == 0 || dest == _curCard || Common::find(cards.begin(), cards.end(), dest) != cards.end())
+			continue;
+
+		cards.push_back(dest);
+
+		if (!hasResource(ID_VIEW, dest))
+			continue;
+
+		Common::SeekableReadStream *viewStream = getResource(ID_VIEW, dest);
+		viewStream->readUint16LE(); // flags
+
+		uint16 image = 0;
+		uint16 conditionalImageCount = viewStream->readUint16LE();
+
+		if (conditionalImageCount == 0)
+			image = viewStream->readUint16LE();
+		else {
+			for (uint16 j = 0; j < conditionalImageCount; j++) {
+				uint16 var = viewStream->readUint16LE();
+				uint16 numStates = viewStream->readUint16LE();
+				uint16 varValue = _scriptParser->getVar(var);
+
+				for (uint16 k = 0; k < numStates; k++) {
+					uint16 value = viewStream->readUint16LE();
+					if (k == varValue)
+						image = value;
+				}
+			}
+		}
+
+		delete viewStream;
+
+		if (image != 0)
+			images.push_back(image);
+	}
+
+	_gfx->prefetchImages(images);
 }
 
 void MohawkEngine_Myst::drawResourceRects() {
@@ -214,6 +214,7 @@ private:
 
 	void loadCard();
 	void unloadCard();
+	void prefetchNeighbourCards();
 	void runInitScript();
 	void runExitScript();
 
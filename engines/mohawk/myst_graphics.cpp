@@ -109,6 +109,13 @@ MohawkSurface *MystGraphics::decodeImage(uint16 id) {
 	return mhkSurface;
 }
 
+bool MystGraphics::hasImage(uint16 id) {
+	if (_vm->getFeatures() & GF_ME && _vm->hasResource(ID_PICT, id))
+		return true;
+
+	return _vm->hasResource(ID_WDIB, id);
+}
+
 void MystGraphics::copyImageSectionToScreen(uint16 image, Common::Rect src, Common::Rect dest) {
 	Graphics::Surface *surface = findImage(image)->getSurface();
 
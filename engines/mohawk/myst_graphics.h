@@ -57,6 +57,7 @@ public:
 
 protected:
 	MohawkSurface *decodeImage(uint16 id);
+	bool hasImage(uint16 id);
 	MohawkEngine *getVM() { return (MohawkEngine *)_vm; }
 	void simulatePreviousDrawDelay(const Common::Rect &dest);
 	void copyBackBufferToScreenWithSaturation(int16 saturation);
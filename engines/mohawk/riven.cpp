@@ -284,8 +284,10 @@ void MohawkEngine_Riven::handleEvents() {
 	if (needsUpdate)
 		_system->updateScreen();
 
-	// Cut down on CPU usage
-	_system->delayMillis(10);
+	// Use the idle time to decode the images of the next cards, or
+	// cut down on CPU usage if there is nothing left to decode
+	if (!_gfx->runPrefetch(10))
+		_system->delayMillis(10);
 }
 
 // Stack/Card-Related Functions
@@ -308,6 +310,7 @@ void MohawkEngine_Riven::changeToStack(uint16 n) {
 
 	// Clear the graphics cache; images aren't used across stack boundaries
 	_gfx->clearCache();
+	_gfx->clearPrefetchCache();
 
 	// Clear the old stack files out
 	for (uint32 i = 0; i < _mhk.size(); i++)
@@ -412,6 +415,50 @@ void MohawkEngine_Riven::refreshCard() {
 
 	// Finally, install any hardcoded timer
 	installCardTimer();
+
+	prefetchNeighbourCards();
+}
+
+void MohawkEngine_Riven::prefetchNeighbourCards() {
+	// Find the cards the scripts of this card can switch to
+	Common::Array<uint16> cards;
+
+	for (uint16 i = 0; i < _cardData.scripts.size(); i++)
+		_cardData.scripts[i]->findCardChanges(cards);
+
+	for (uint16 i = 0; i < _hotspotCount; i++)
+		for (uint16 j = 0; j < _hotspots[i].scripts.size(); j++)
+			_hotspots[i].scripts[j]->findCardChanges(cards);
+
+	// Their first picture, drawn when entering the card, is what makes
+	// changing cards slow, so have it decoded while the player looks around
+	Common::Array<uint16> images;
+
+	for (uint16 i = 0; i < cards.size(); i++) {
+		if (cards[i] == _curCard || Common::find(cards.begin(), cards.begin() + i, cards[i]) != cards.begin() + i)
+			continue;
+
+		if (!hasResource(ID_PLST, cards[i]))
+			continue;
+
+		Common::SeekableReadStream *plst = getResource(ID_PLST, cards[i]);
+		uint16 recordCount = plst->readUint16BE();
+
+		for (uint16 j = 0; j < recordCount; j++) {
+			uint16 index = plst->readUint16BE();
+			uint16 id = plst->readUint16BE();
+			plst->skip(8); // left, top, right, bottom
+
+			if (index == 1) {
+				images.push_back(id);
+				break;
+			}
+		}
+
+		delete plst;
+	}
+
+	_gfx->prefetchImages(images);
 }
 
 void MohawkEngine_Riven::loadCard(uint16 id) {
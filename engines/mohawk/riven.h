@@ -151,6 +151,7 @@ private:
 	uint16 _curCard;
 	uint16 _curStack;
 	void loadCard(uint16);
+	void prefetchNeighbourCards();
 	void handleEvents();
 
 	// Hotspot related functions and variables
@@ -65,6 +65,10 @@ MohawkSurface *RivenGraphics::decodeImage(uint16 id) {
 	return surface;
 }
 
+bool RivenGraphics::hasImage(uint16 id) {
+	return _vm->hasResource(ID_TBMP, id);
+}
+
 void RivenGraphics::copyImageToScreen(uint16 image, uint32 left, uint32 top, uint32 right, uint32 bottom) {
 	Graphics::Surface *surface = findImage(image)->getSurface();
 
@@ -65,6 +65,7 @@ public:
 
 protected:
 	MohawkSurface *decodeImage(uint16 id);
+	bool hasImage(uint16 id);
 	MohawkEngine *getVM() { return (MohawkEngine *)_vm; }
 
 private:
@@ -235,6 +235,44 @@ void RivenScript::runScript() {
 	_isRunning = false;
 }
 
+void RivenScript::findCardChanges(Common::Array<uint16> &cards) {
+	// The script may be running, so keep its position
+	uint32 oldPos = _stream->pos();
+	_stream->seek(0);
+
+	uint16 commandCount = _stream->readUint16BE();
+	for (uint16 i = 0; i < commandCount && !_stream->eos(); i++)
+		findCommandCardChanges(cards);
+
+	_stream->seek(oldPos);
+}
+
+void RivenScript::findCommandCardChanges(Common::Array<uint16> &cards) {
+	uint16 command = _stream->readUint16BE();
+
+	if (command == 8) {
+		_stream->readUint16BE();							// unknown value, always 2
+		_stream->readUint16BE();							// variable to check against
+		uint16 logicBlockCount = _stream->readUint16BE();	// number of logic blocks
+
+		for (uint16 i = 0; i < logicBlockCount && !_stream->eos(); i++) {
+			_stream->readUint16BE(); // Block variable
+			uint16 logicBlockLength = _stream->readUint16BE();
+			for (uint16 j = 0; j < logicBlockLength && !_stream->eos(); j++)
+				findCommandCardChanges(cards);
+		}
+	} else {
+		uint16 argCount = _stream->readUint16BE();
+		uint32 argPos = _stream->pos();
+
+		// Command 2 is switchCard
+		if (command == 2 && argCount >= 1)
+			cards.push_back(_stream->readUint16BE());
+
+		_stream->seek(argPos + argCount * 2);
+	}
+}
+
 void RivenScript::processCommands(bool runCommands) {
 	bool runBlock = true;
 
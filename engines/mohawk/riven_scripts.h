@@ -64,6 +64,10 @@ public:
 	bool isRunning() { return _isRunning; }
 	void stopRunning() { _continueRunning = false; }
 
+	// Add the destination of every card change in the script, whatever
+	// the branch it is in, to cards
+	void findCardChanges(Common::Array<uint16> &cards);
+
 	static uint32 calculateScriptSize(Common::SeekableReadStream *script);
 
 private:
@@ -82,6 +86,7 @@ private:
 
 	void dumpCommands(const Common::StringArray &varNames, const Common::StringArray &xNames, byte tabs);
 	void processCommands(bool runCommands);
+	void findCommandCardChanges(Common::Array<uint16> &cards);
 
 	static uint32 calculateCommandSize(Common::SeekableReadStream *script);
 
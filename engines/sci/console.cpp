@@ -145,6 +145,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("seginfo",			WRAP_METHOD(Console, cmdSegmentInfo));			// alias
 	DCmd_Register("segment_kill",		WRAP_METHOD(Console, cmdKillSegment));
 	DCmd_Register("segkill",			WRAP_METHOD(Console, cmdKillSegment));			// alias
+	DCmd_Register("selector_cache",		WRAP_METHOD(Console, cmdSelectorCache));
 	// Garbage collection
 	DCmd_Register("gc",					WRAP_METHOD(Console, cmdGCInvoke));
 	DCmd_Register("gc_objects",			WRAP_METHOD(Console, cmdGCObjects));
@@ -379,6 +380,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf(" segment_table / segtable - Lists all segments\n");
 	DebugPrintf(" segment_info / seginfo - Provides information on the specified segment\n");
 	DebugPrintf(" segment_kill / segkill - Deletes the specified segment\n");
+	DebugPrintf(" selector_cache - Shows, records or replays the selector lookups\n");
 	DebugPrintf("\n");
 	DebugPrintf("Garbage collection:\n");
 	DebugPrintf(" gc - Invokes the garbage collector\n");
@@ -2081,6 +2083,95 @@ bool Console::cmdKillSegment(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdSelectorCache(int argc, const char **argv) {
+	SegManager *segMan = _engine->_gamestate->_segMan;
+
+	if (argc == 1) {
+		uint32 hits = segMan->getSelectorCacheHits();
+		uint32 misses = segMan->getSelectorCacheMisses();
+		DebugPrintf("Selector cache: %s\n", segMan->isSelectorCacheEnabled() ? "on" : "off");
+		DebugPrintf("%d hits, %d misses (%d%% hits)\n", hits, misses, (hits + misses) ? (int)(hits * 100.0 / (hits + misses)) : 0);
+		DebugPrintf("%d selector lookups recorded\n", segMan->getSelectorTrace().size());
+		return true;
+	}
+
+	if (argc == 2 && (!scumm_stricmp(argv[1], "on") || !scumm_stricmp(argv[1], "off"))) {
+		segMan->setSelectorCacheEnabled(!scumm_stricmp(argv[1], "on"));
+		segMan->flushSelectorLookups();
+		return true;
+	}
+
+	if (argc == 3 && !scumm_stricmp(argv[1], "record")) {
+		int count;
+		if (!parseInteger(argv[2], count))
+			return true;
+		segMan->recordSelectorLookups(count);
+		DebugPrintf("Recording the next %d selector lookups\n", count);
+		return true;
+	}
+
+	if ((argc == 2 || argc == 3) && !scumm_stricmp(argv[1], "replay")) {
+		int rounds = 10;
+		if (argc == 3 && !parseInteger(argv[2], rounds))
+			return true;
+
+		// Only replay the lookups of objects that still exist
+		segMan->stopRecordingSelectorLookups();
+		const Common::Array<SelectorTraceEntry> &trace = segMan->getSelectorTrace();
+		Common::Array<SelectorTraceEntry> lookups;
+		for (uint i = 0; i < trace.size(); i++) {
+			if (segMan->getObject(trace[i].obj))
+				lookups.push_back(trace[i]);
+		}
+		if (lookups.empty()) {
+			DebugPrintf("No selector lookups to replay, use \"%s record <count>\" first\n", argv[0]);
+			return true;
+		}
+
+		const bool wasEnabled = segMan->isSelectorCacheEnabled();
+
+		// Check that the cache gives the same results as a full lookup
+		int mismatches = 0;
+		for (uint i = 0; i < lookups.size(); i++) {
+			ObjVarRef uncachedVar, cachedVar;
+			reg_t uncachedFunc = NULL_REG, cachedFunc = NULL_REG;
+			segMan->setSelectorCacheEnabled(false);
+			SelectorType uncachedType = lookupSelector(segMan, lookups[i].obj, lookups[i].selector, &uncachedVar, &uncachedFunc);
+			segMan->setSelectorCacheEnabled(true);
+			SelectorType cachedType = lookupSelector(segMan, lookups[i].obj, lookups[i].selector, &cachedVar, &cachedFunc);
+			if (cachedType != uncachedType || cachedFunc != uncachedFunc ||
+				(cachedType == kSelectorVariable && cachedVar.varindex != uncachedVar.varindex)) {
+				DebugPrintf("Mismatch for selector %s of object %04x:%04x\n",
+					_engine->getKernel()->getSelectorName(lookups[i].selector).c_str(), PRINT_REG(lookups[i].obj));
+				mismatches++;
+			}
+		}
+
+		uint32 elapsed[2];
+		for (int cached = 0; cached < 2; cached++) {
+			segMan->setSelectorCacheEnabled(cached);
+			uint32 start = g_system->getMillis();
+			for (int round = 0; round < rounds; round++) {
+				for (uint i = 0; i < lookups.size(); i++)
+					lookupSelector(segMan, lookups[i].obj, lookups[i].selector, NULL, NULL);
+			}
+			elapsed[cached] = g_system->getMillis() - start;
+		}
+
+		segMan->setSelectorCacheEnabled(wasEnabled);
+
+		DebugPrintf("Replayed %d selector lookups %d times, %d mismatches\n", lookups.size(), rounds, mismatches);
+		DebugPrintf("Uncached: %d ms, cached: %d ms\n", elapsed[0], elapsed[1]);
+		return true;
+	}
+
+	DebugPrintf("Shows the statistics of the selector lookup cache, or turns it on or off.\n");
+	DebugPrintf("Selector lookups can be recorded and replayed with and without the cache,\n");
+	DebugPrintf("which also checks that the cache gives the same results.\n");
+	DebugPrintf("Usage: %s [on | off | record <count> | replay [<rounds>]]\n", argv[0]);
+	return true;
+}
+
 bool Console::cmdShowMap(int argc, const char **argv) {
 	if (argc != 2) {
 		DebugPrintf("Switches to one of the following screen maps\n");
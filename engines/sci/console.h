@@ -102,6 +102,7 @@ private:
 	bool cmdPrintSegmentTable(int argc, const char **argv);
 	bool cmdSegmentInfo(int argc, const char **argv);
 	bool cmdKillSegment(int argc, const char **argv);
+	bool cmdSelectorCache(int argc, const char **argv);
 	// Garbage collection
 	bool cmdGCInvoke(int argc, const char **argv);
 	bool cmdGCObjects(int argc, const char **argv);
@@ -30,12 +30,6 @@
 
 namespace Sci {
 
-struct reg_t_Hash {
-	uint operator()(const reg_t& x) const {
-		return (x.getSegment() << 3) ^ x.getOffset() ^ (x.getOffset() << 16);
-	}
-};
-
 /*
  * The AddrSet is a "set" of reg_t values.
  * We don't have a HashSet type, so we abuse a HashMap for this.
@@ -48,6 +48,7 @@
 #include "sci/graphics/text16.h"
 #include "sci/graphics/view.h"
 #ifdef ENABLE_SCI32
+#include "sci/graphics/frameout.h"
 #include "sci/graphics/text32.h"
 #endif
 
@@ -1247,6 +1248,12 @@ reg_t kRemapColors(EngineState *s, int argc, reg_t *argv) {
 		break;
 	}
 
+#ifdef ENABLE_SCI32
+	// Remapped colors are applied when views are drawn
+	if (g_sci->_gfxFrameout)
+		g_sci->_gfxFrameout->forceRedraw();
+#endif
+
 	return s->r_acc;
 }
 
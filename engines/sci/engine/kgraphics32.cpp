@@ -416,6 +416,8 @@ reg_t kSetFontRes(EngineState *s, int argc, reg_t *argv) {
 
 	g_sci->_gfxScreen->setFontIsUpscaled(xResolution == 640 &&
 			g_sci->_gfxScreen->getUpscaledHires() != GFX_SCREEN_UPSCALED_DISABLED);
+	// The font resolution is applied when text is drawn
+	g_sci->_gfxFrameout->forceRedraw();
 
 	return s->r_acc;
 }
@@ -804,6 +806,9 @@ reg_t kRemapColors32(EngineState *s, int argc, reg_t *argv) {
 		break;
 	}
 
+	// Remapped colors are applied when views are drawn
+	g_sci->_gfxFrameout->forceRedraw();
+
 	return s->r_acc;
 }
 
@@ -24,6 +24,7 @@
 #include "sci/engine/state.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/kernel.h"
+#include "sci/engine/kpathing.h"
 #include "sci/graphics/paint16.h"
 #include "sci/graphics/palette.h"
 #include "sci/graphics/screen.h"
@@ -111,10 +112,14 @@ struct Vertex {
 	// Previous vertex in shortest path
 	Vertex *path_prev;
 
+	// Index in the visibility graph, -1 for merged start and end points
+	int index;
+
 public:
 	Vertex(const Common::Point &p) : v(p) {
 		costG = HUGE_DISTANCE;
 		path_prev = NULL;
+		index = -1;
 	}
 };
 
@@ -236,6 +241,28 @@ public:
 
 typedef Common::List<Polygon *> PolygonList;
 
+// Visibility between the vertices of a polygon set
+struct VisibilityGraph {
+	// Polygon set the graph belongs to
+	uint32 hash;
+	Common::Array<uint> polygonSizes;
+	Common::Array<Common::Point> points;
+
+	// Visibility bit matrix, one row of rowSize words per vertex. Rows are
+	// filled in on demand, as the search only needs a part of them.
+	uint rowSize;
+	Common::Array<uint32> visible;
+	Common::Array<bool> rowDone;
+
+	bool isVisible(int from, int to) const {
+		return (visible[from * rowSize + to / 32] >> (to % 32)) & 1;
+	}
+
+	void setVisible(int from, int to) {
+		visible[from * rowSize + to / 32] |= 1U << (to % 32);
+	}
+};
+
 // Pathfinding state
 struct PathfindingState {
 	// List of all polygons
@@ -257,7 +284,15 @@ struct PathfindingState {
 	// Screen size
 	int _width, _height;
 
+	// Cached visibility between the polygon vertices, indexed by Vertex::index
+	VisibilityGraph *_visibility;
+	Common::Array<Vertex *> _graphVertices;
+
+	// Start and end points that were merged into the middle of an edge
+	Common::Array<Vertex *> _splitVertices;
+
 	PathfindingState(int width, int height) : _width(width), _height(height) {
+		_visibility = NULL;
 		vertex_start = NULL;
 		vertex_end = NULL;
 		vertex_index = NULL;
@@ -659,6 +694,96 @@ static int inside(const Common::Point &p, Vertex *vertex) {
 	return 0;
 }
 
+/**
+ * Determines whether or not two vertices can see each other
+ * @param vertices		the vertices whose edges may block the line
+ * @param count			the number of vertices
+ * @param from			the first vertex
+ * @param to			the second vertex
+ * @param graphEdges	true to check the polygon edges as they were before the
+ *						start and end points were merged into the polygon set
+ * @return true if the line (from, to) doesn't intersect any polygon
+ */
+static bool vertex_visible(Vertex *const *vertices, int count, Vertex *from, Vertex *to, bool graphEdges) {
+	// Make sure we don't intersect a polygon locally at the vertices
+	if (inside(to->v, from) || inside(from->v, to))
+		return false;
+
+	// Check for intersecting edges
+	for (int j = 0; j < count; j++) {
+		Vertex *edge = vertices[j];
+		if (VERTEX_HAS_EDGES(edge)) {
+			if (between(from->v, to->v, edge->v)) {
+				// If we hit a vertex, make sure we can pass through it without intersecting its polygon
+				if ((inside(from->v, edge)) || (inside(to->v, edge)))
+					return false;
+
+				// This edge won't properly intersect, so we continue
+				continue;
+			}
+
+			// Split edges lie on the original edge, so that one can be
+			// checked instead. The local checks at the vertices give the
+			// same results for either.
+			Vertex *next = CLIST_NEXT(edge);
+			if (graphEdges) {
+				while (next->index < 0)
+					next = CLIST_NEXT(next);
+			}
+
+			if (intersect_proper(from->v, to->v, edge->v, next->v))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Determines whether or not two vertices can see each other, using the
+ * visibility graph where possible
+ * @param s				the pathfinding state
+ * @param from			the first vertex
+ * @param to			the second vertex
+ * @return true if the line (from, to) doesn't intersect any polygon
+ */
+static bool vertex_visible(PathfindingState *s, Vertex *from, Vertex *to) {
+	VisibilityGraph *graph = s->_visibility;
+	bool useGraph = graph && (from->index >= 0) && (to->index >= 0);
+
+	// A start or end point splitting an edge is a vertex now, which the
+	// line between two polygon vertices may pass through.
+	for (uint i = 0; useGraph && i < s->_splitVertices.size(); i++) {
+		if (between(from->v, to->v, s->_splitVertices[i]->v))
+			useGraph = false;
+	}
+
+	if (!useGraph)
+		return vertex_visible(s->vertex_index, s->vertices, from, to, false);
+
+	if (!graph->rowDone[from->index]) {
+		const Common::Array<Vertex *> &vertices = s->_graphVertices;
+
+		for (uint i = 0; i < vertices.size(); i++) {
+			// Visibility is symmetric, so reuse the rows we already have
+			bool visible;
+			if (vertices[i] == from)
+				visible = false;
+			else if (graph->rowDone[i])
+				visible = graph->isVisible(i, from->index);
+			else
+				visible = vertex_visible(vertices.begin(), vertices.size(), from, vertices[i], true);
+
+			if (visible)
+				graph->setVisible(from->index, i);
+		}
+
+		graph->rowDone[from->index] = true;
+	}
+
+	return graph->isVisible(from->index, to->index);
+}
+
 /**
  * Returns a list of all vertices that are visible from a particular vertex.
  * @param s				the pathfinding state
@@ -671,30 +796,7 @@ static VertexList *visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
 	for (int i = 0; i < s->vertices; i++) {
 		Vertex *vertex = s->vertex_index[i];
 
-		// Make sure we don't intersect a polygon locally at the vertices
-		if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
-			continue;
-
-		// Check for intersecting edges
-		int j;
-		for (j = 0; j < s->vertices; j++) {
-			Vertex *edge = s->vertex_index[j];
-			if (VERTEX_HAS_EDGES(edge)) {
-				if (between(vertex_cur->v, vertex->v, edge->v)) {
-					// If we hit a vertex, make sure we can pass through it without intersecting its polygon
-					if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
-						break;
-
-					// This edge won't properly intersect, so we continue
-					continue;
-				}
-
-				if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
-					break;
-			}
-		}
-
-		if (j == s->vertices)
+		if ((vertex != vertex_cur) && vertex_visible(s, vertex_cur, vertex))
 			visVerts->push_front(vertex);
 	}
 
@@ -1185,6 +1287,85 @@ static void change_polygons_opt_0(PathfindingState *s) {
 	}
 }
 
+AvoidPathCache::AvoidPathCache() : _hits(0), _misses(0) {
+}
+
+AvoidPathCache::~AvoidPathCache() {
+	clear();
+}
+
+void AvoidPathCache::clear() {
+	for (Common::List<VisibilityGraph *>::iterator it = _graphs.begin(); it != _graphs.end(); ++it)
+		delete *it;
+	_graphs.clear();
+}
+
+VisibilityGraph *AvoidPathCache::getGraph(const Common::Array<uint> &polygonSizes, const Common::Array<Common::Point> &points) {
+	uint32 hash = polygonSizes.size();
+	for (uint i = 0; i < polygonSizes.size(); i++)
+		hash = hash * 31 + polygonSizes[i];
+	for (uint i = 0; i < points.size(); i++)
+		hash = (hash * 31 + (uint16)points[i].x) * 31 + (uint16)points[i].y;
+
+	for (Common::List<VisibilityGraph *>::iterator it = _graphs.begin(); it != _graphs.end(); ++it) {
+		VisibilityGraph *graph = *it;
+		if (graph->hash == hash && graph->polygonSizes == polygonSizes && graph->points == points) {
+			// Move to the front, so that the least recently used graph is dropped first
+			_graphs.erase(it);
+			_graphs.push_front(graph);
+			_hits++;
+			debugC(kDebugLevelAvoidPath, "AvoidPath: polygon set found in cache (%d hits, %d misses)", _hits, _misses);
+			return graph;
+		}
+	}
+
+	if (_graphs.size() >= kMaxGraphs) {
+		delete _graphs.back();
+		_graphs.pop_back();
+	}
+
+	VisibilityGraph *graph = new VisibilityGraph();
+	graph->hash = hash;
+	graph->polygonSizes = polygonSizes;
+	graph->points = points;
+	graph->rowSize = (points.size() + 31) / 32;
+	graph->visible.resize(points.size() * graph->rowSize);
+	graph->rowDone.resize(points.size());
+
+	_graphs.push_front(graph);
+	_misses++;
+	debugC(kDebugLevelAvoidPath, "AvoidPath: new polygon set with %d vertices (%d hits, %d misses)", points.size(), _hits, _misses);
+	return graph;
+}
+
+/**
+ * Looks up the visibility graph of the polygon set in the cache, and numbers
+ * the polygon vertices according to it. Must be called before the start and
+ * end points are merged into the polygon set.
+ * Parameters: (PathfindingState *) s: The pathfinding state
+ *             (AvoidPathCache *) cache: The cache
+ */
+static void attach_visibility_graph(PathfindingState *s, AvoidPathCache *cache) {
+	Common::Array<uint> polygonSizes;
+	Common::Array<Common::Point> points;
+
+	for (PolygonList::iterator it = s->polygons.begin(); it != s->polygons.end(); ++it) {
+		Vertex *vertex;
+		uint size = 0;
+
+		CLIST_FOREACH(vertex, &(*it)->vertices) {
+			vertex->index = points.size();
+			points.push_back(vertex->v);
+			s->_graphVertices.push_back(vertex);
+			size++;
+		}
+
+		polygonSizes.push_back(size);
+	}
+
+	s->_visibility = cache->getGraph(polygonSizes, points);
+}
+
 /**
  * Converts the SCI input data for pathfinding
  * Parameters: (EngineState *) s: The game state
@@ -1276,10 +1457,17 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 		}
 	}
 
+	attach_visibility_graph(pf_s, s->_avoidPathCache);
+
 	// Merge start and end points into polygon set
 	pf_s->vertex_start = merge_point(pf_s, *new_start);
 	pf_s->vertex_end = merge_point(pf_s, *new_end);
 
+	if (pf_s->vertex_start->index < 0 && VERTEX_HAS_EDGES(pf_s->vertex_start))
+		pf_s->_splitVertices.push_back(pf_s->vertex_start);
+	if (pf_s->vertex_end->index < 0 && VERTEX_HAS_EDGES(pf_s->vertex_end) && pf_s->vertex_end != pf_s->vertex_start)
+		pf_s->_splitVertices.push_back(pf_s->vertex_end);
+
 	delete new_start;
 	delete new_end;
 
@@ -0,0 +1,75 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCI_ENGINE_KPATHING_H
+#define SCI_ENGINE_KPATHING_H
+
+#include "common/array.h"
+#include "common/list.h"
+#include "common/rect.h"
+
+namespace Sci {
+
+struct VisibilityGraph;
+
+/**
+ * Cache for the visibility graphs of the polygon sets passed to kAvoidPath.
+ *
+ * Scripts call AvoidPath over and over with the same room polygons, only
+ * changing the start and end points. The visibility between the polygon
+ * vertices is kept here per polygon set, so that only the lines to the start
+ * and end points have to be checked again. Polygon sets are looked up by
+ * their contents, so the cache never has to be invalidated.
+ */
+class AvoidPathCache {
+public:
+	AvoidPathCache();
+	~AvoidPathCache();
+
+	/**
+	 * Returns the visibility graph for a polygon set, creating an empty one
+	 * if the set isn't in the cache yet.
+	 * @param polygonSizes	the number of vertices of each polygon
+	 * @param points		the vertices of all polygons, in order
+	 * @return the visibility graph, owned by the cache
+	 */
+	VisibilityGraph *getGraph(const Common::Array<uint> &polygonSizes, const Common::Array<Common::Point> &points);
+
+	/** Removes all graphs from the cache. */
+	void clear();
+
+private:
+	enum {
+		/** Maximum number of polygon sets kept, rooms use a few at most */
+		kMaxGraphs = 8
+	};
+
+	/** The cached graphs, most recently used first */
+	Common::List<VisibilityGraph *> _graphs;
+
+	uint _hits;
+	uint _misses;
+};
+
+} // End of namespace Sci
+
+#endif // SCI_ENGINE_KPATHING_H
@@ -127,6 +127,9 @@ void playVideo(Video::VideoDecoder *videoDecoder, VideoState videoState) {
 		g_system->delayMillis(10);
 	}
 
+	// The video frames replaced what was on the screen
+	g_sci->_gfxScreen->invalidateShownScreen();
+
 	delete[] scaleBuffer;
 	delete videoDecoder;
 }
@@ -43,6 +43,12 @@ SegManager::SegManager(ResourceManager *resMan) {
 
 	_resMan = resMan;
 
+	_selectorCacheEnabled = true;
+	_selectorCacheHits = 0;
+	_selectorCacheMisses = 0;
+	_selectorTraceLimit = 0;
+	flushSelectorLookups();
+
 	createClassTable();
 }
 
@@ -75,6 +81,8 @@ void SegManager::resetSegMan() {
 	// Reinitialize class table
 	_classTable.clear();
 	createClassTable();
+
+	flushSelectorLookups();
 }
 
 void SegManager::initSysStrings() {
@@ -153,6 +161,10 @@ void SegManager::deallocate(SegmentId seg) {
 	if (mobj->getType() == SEG_TYPE_SCRIPT) {
 		Script *scr = (Script *)mobj;
 		_scriptSegMap.erase(scr->getScriptNumber());
+
+		// The segment may be reused for another script
+		flushSelectorLookups();
+
 		if (scr->getLocalsSegment()) {
 			// Check if the locals segment has already been deallocated.
 			// If the locals block has been stored in a segment with an ID
@@ -224,6 +236,18 @@ SegmentObj *SegManager::getSegment(SegmentId seg, SegmentType type) const {
 	return getSegmentType(seg) == type ? _heap[seg] : NULL;
 }
 
+void SegManager::flushSelectorLookups() {
+	for (uint i = 0; i < ARRAYSIZE(_selectorLookups); i++) {
+		_selectorLookups[i].pos = NULL_REG;
+		_selectorLookups[i].selector = -1;
+	}
+}
+
+void SegManager::recordSelectorLookups(uint count) {
+	_selectorTrace.clear();
+	_selectorTraceLimit = count;
+}
+
 Object *SegManager::getObject(reg_t pos) const {
 	SegmentObj *mobj = getSegmentObj(pos.getSegment());
 	Object *obj = NULL;
@@ -969,6 +993,7 @@ int SegManager::instantiateScript(int scriptNum) {
 			return segmentId;
 		} else {
 			scr->freeScript();
+			flushSelectorLookups();
 		}
 	} else {
 		scr = allocateScript(scriptNum, &segmentId);
@@ -43,6 +43,25 @@ enum ScriptLoadType {
 
 class Script;
 
+/**
+ * A cached result of lookupSelector(). The lookup only depends on where the
+ * object is defined (Object::getPos()), which an object shares with its
+ * clones, so that is used as the key together with the selector.
+ */
+struct SelectorLookup {
+	reg_t pos; ///< Definition of the object the selector was looked up in
+	Selector selector; ///< The selector, or -1 if the entry is unused
+	SelectorType type;
+	int varIndex; ///< Index of the variable, for kSelectorVariable
+	reg_t func; ///< Address of the method, for kSelectorMethod
+};
+
+/** A recorded call to lookupSelector(), see SegManager::recordSelectorLookups() */
+struct SelectorTraceEntry {
+	reg_t obj;
+	Selector selector;
+};
+
 class SegManager : public Common::Serializable {
 	friend class Console;
 public:
@@ -441,6 +460,43 @@ public:
 
 	const Common::Array<SegmentObj *> &getSegments() const { return _heap; }
 
+	// Selector lookup cache
+
+	/**
+	 * Returns the selector cache entry for the given object definition and
+	 * selector. The entry belongs to another lookup, or is unused, if its
+	 * position and selector don't match.
+	 */
+	SelectorLookup &getSelectorLookup(reg_t pos, Selector selectorId) {
+		uint32 hash = ((pos.getSegment() << 16) ^ pos.getOffset() ^ (selectorId << 5)) * 2654435761U;
+		return _selectorLookups[hash >> (32 - kSelectorLookupBits)];
+	}
+
+	/** Forgets all cached selector lookups */
+	void flushSelectorLookups();
+
+	bool isSelectorCacheEnabled() const { return _selectorCacheEnabled; }
+	void setSelectorCacheEnabled(bool enabled) { _selectorCacheEnabled = enabled; }
+
+	void countSelectorLookup(bool hit) { hit ? _selectorCacheHits++ : _selectorCacheMisses++; }
+	uint32 getSelectorCacheHits() const { return _selectorCacheHits; }
+	uint32 getSelectorCacheMisses() const { return _selectorCacheMisses; }
+
+	/**
+	 * Records the next selector lookups, to replay them with and without the
+	 * cache in the debugger.
+	 * @param count		the number of lookups to record, 0 to stop recording
+	 */
+	void recordSelectorLookups(uint count);
+	void stopRecordingSelectorLookups() { _selectorTraceLimit = _selectorTrace.size(); }
+	void traceSelectorLookup(reg_t obj, Selector selectorId) {
+		if (_selectorTrace.size() < _selectorTraceLimit) {
+			SelectorTraceEntry entry = { obj, selectorId };
+			_selectorTrace.push_back(entry);
+		}
+	}
+	const Common::Array<SelectorTraceEntry> &getSelectorTrace() const { return _selectorTrace; }
+
 private:
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
@@ -463,6 +519,17 @@ private:
 	SegmentId _stringSegId;
 #endif
 
+	enum {
+		kSelectorLookupBits = 11
+	};
+
+	SelectorLookup _selectorLookups[1 << kSelectorLookupBits];
+	bool _selectorCacheEnabled;
+	uint32 _selectorCacheHits;
+	uint32 _selectorCacheMisses;
+	Common::Array<SelectorTraceEntry> _selectorTrace;
+	uint _selectorTraceLimit;
+
 public:
 	SegmentObj *allocSegment(SegmentObj *mem, SegmentId *segid);
 
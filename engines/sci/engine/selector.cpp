@@ -250,9 +250,34 @@ void invokeSelector(EngineState *s, reg_t object, int selectorId,
 	run_vm(s); // Start a new vm
 }
 
+static void lookupSelectorUncached(SegManager *segMan, const Object *obj, Selector selectorId, SelectorLookup &result) {
+	result.pos = obj->getPos();
+	result.selector = selectorId;
+	result.type = kSelectorNone;
+
+	int index = obj->locateVarSelector(segMan, selectorId);
+
+	if (index >= 0) {
+		// Found it as a variable
+		result.type = kSelectorVariable;
+		result.varIndex = index;
+	} else {
+		// Check if it's a method, with recursive lookup in superclasses
+		while (obj) {
+			index = obj->funcSelectorPosition(selectorId);
+			if (index >= 0) {
+				result.type = kSelectorMethod;
+				result.func = obj->getFunction(index);
+				return;
+			} else {
+				obj = segMan->getObject(obj->getSuperClassSelector());
+			}
+		}
+	}
+}
+
 SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector selectorId, ObjVarRef *varp, reg_t *fptr) {
 	const Object *obj = segMan->getObject(obj_location);
-	int index;
 	bool oldScriptHeader = (getSciVersion() == SCI_VERSION_0_EARLY);
 
 	// Early SCI versions used the LSB in the selector ID as a read/write
@@ -265,34 +290,33 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 				PRINT_REG(obj_location));
 	}
 
-	index = obj->locateVarSelector(segMan, selectorId);
+	segMan->traceSelectorLookup(obj_location, selectorId);
+
+	// Objects defined at the same place (i.e. an object and its clones)
+	// always resolve a selector the same way, so look there first
+	SelectorLookup uncached;
+	SelectorLookup *lookup = &uncached;
+	if (segMan->isSelectorCacheEnabled()) {
+		lookup = &segMan->getSelectorLookup(obj->getPos(), selectorId);
+		bool hit = (lookup->selector == selectorId && lookup->pos == obj->getPos());
+		segMan->countSelectorLookup(hit);
+		if (!hit)
+			lookupSelectorUncached(segMan, obj, selectorId, *lookup);
+	} else {
+		lookupSelectorUncached(segMan, obj, selectorId, *lookup);
+	}
 
-	if (index >= 0) {
-		// Found it as a variable
+	if (lookup->type == kSelectorVariable) {
 		if (varp) {
 			varp->obj = obj_location;
-			varp->varindex = index;
-		}
-		return kSelectorVariable;
-	} else {
-		// Check if it's a method, with recursive lookup in superclasses
-		while (obj) {
-			index = obj->funcSelectorPosition(selectorId);
-			if (index >= 0) {
-				if (fptr)
-					*fptr = obj->getFunction(index);
-
-				return kSelectorMethod;
-			} else {
-				obj = segMan->getObject(obj->getSuperClassSelector());
-			}
+			varp->varindex = lookup->varIndex;
 		}
-
-		return kSelectorNone;
+	} else if (lookup->type == kSelectorMethod) {
+		if (fptr)
+			*fptr = lookup->func;
 	}
 
-
-//	return _lookupSelector_function(segMan, obj, selectorId, fptr);
+	return lookup->type;
 }
 
 } // End of namespace Sci
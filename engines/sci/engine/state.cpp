@@ -28,6 +28,7 @@
 
 #include "sci/engine/file.h"
 #include "sci/engine/kernel.h"
+#include "sci/engine/kpathing.h"
 #include "sci/engine/state.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/vm.h"
@@ -73,13 +74,15 @@ EngineState::EngineState(SegManager *segMan)
 #ifdef ENABLE_SCI32
 	_virtualIndexFile(0),
 #endif
-	_dirseeker() {
+	_dirseeker(),
+	_avoidPathCache(new AvoidPathCache()) {
 
 	reset(false);
 }
 
 EngineState::~EngineState() {
 	delete _msgState;
+	delete _avoidPathCache;
 #ifdef ENABLE_SCI32
 	delete _virtualIndexFile;
 #endif
@@ -43,6 +43,7 @@ class WriteStream;
 
 namespace Sci {
 
+class AvoidPathCache;
 class FileHandle;
 class DirSeeker;
 class EventManager;
@@ -201,6 +202,8 @@ public:
 
 	uint16 _palCycleToColor;
 
+	AvoidPathCache *_avoidPathCache; /**< Visibility graphs of the polygon sets passed to kAvoidPath */
+
 	/**
 	 * Resets the engine state.
 	 */
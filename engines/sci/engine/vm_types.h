@@ -169,6 +169,13 @@ static inline reg_t make_reg(SegmentId segment, uint16 offset) {
 
 #define PRINT_REG(r) (0xffff) & (unsigned) (r).getSegment(), (unsigned) (r).getOffset()
 
+/** Hash function for using reg_t as a key of a Common::HashMap */
+struct reg_t_Hash {
+	uint operator()(const reg_t& x) const {
+		return (x.getSegment() << 3) ^ x.getOffset() ^ (x.getOffset() << 16);
+	}
+};
+
 // A true 32-bit reg_t
 struct reg32_t {
 	// Segment and offset. These should never be accessed directly
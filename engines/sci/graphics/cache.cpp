@@ -30,17 +30,26 @@
 #include "sci/graphics/cache.h"
 #include "sci/graphics/font.h"
 #include "sci/graphics/fontsjis.h"
+#include "sci/graphics/screen.h"
 #include "sci/graphics/view.h"
 
 namespace Sci {
 
+struct CachedPicture {
+	PictureCacheKey key;
+	byte *screenBits; // bitsSave() data of the picture port after drawing
+	uint screenBitsSize;
+	int16 ditheredPicColors[DITHERED_BG_COLORS_SIZE];
+};
+
 GfxCache::GfxCache(ResourceManager *resMan, GfxScreen *screen, GfxPalette *palette)
-	: _resMan(resMan), _screen(screen), _palette(palette) {
+	: _resMan(resMan), _screen(screen), _palette(palette), _cachedPicturesSize(0) {
 }
 
 GfxCache::~GfxCache() {
 	purgeFontCache();
 	purgeViewCache();
+	purgePictureCache();
 }
 
 void GfxCache::purgeFontCache() {
@@ -61,6 +70,16 @@ void GfxCache::purgeViewCache() {
 	_cachedViews.clear();
 }
 
+void GfxCache::purgePictureCache() {
+	for (PictureCache::iterator iter = _cachedPictures.begin(); iter != _cachedPictures.end(); ++iter) {
+		delete[] (*iter)->screenBits;
+		delete *iter;
+	}
+
+	_cachedPictures.clear();
+	_cachedPicturesSize = 0;
+}
+
 GfxFont *GfxCache::getFont(GuiResourceId fontId) {
 	if (_cachedFonts.size() >= MAX_CACHED_FONTS)
 		purgeFontCache();
@@ -106,4 +125,53 @@ byte GfxCache::kernelViewGetColorAtCoordinate(GuiResourceId viewId, int16 loopNo
 	return getView(viewId)->getColorAtCoordinate(loopNo, celNo, x, y);
 }
 
+bool GfxCache::restorePicture(const PictureCacheKey &key) {
+	for (PictureCache::iterator iter = _cachedPictures.begin(); iter != _cachedPictures.end(); ++iter) {
+		CachedPicture *picture = *iter;
+		if (picture->key == key) {
+			_screen->bitsRestore(picture->screenBits);
+
+			// Dithering EGA pictures counts the dithered colors
+			int16 *ditheredPicColors = _screen->unditherGetDitheredBgColors();
+			if (ditheredPicColors)
+				memcpy(ditheredPicColors, picture->ditheredPicColors, sizeof(picture->ditheredPicColors));
+
+			_cachedPictures.erase(iter);
+			_cachedPictures.push_front(picture);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void GfxCache::storePicture(const PictureCacheKey &key, const Common::Rect &rect) {
+	uint size = _screen->bitsGetDataSize(rect, GFX_SCREEN_MASK_ALL);
+
+	if (size > MAX_CACHED_PICTURES_SIZE)
+		return;
+
+	// Drop the least recently used pictures to stay within the budget
+	while (_cachedPicturesSize + size > MAX_CACHED_PICTURES_SIZE) {
+		CachedPicture *oldest = _cachedPictures.back();
+		_cachedPictures.pop_back();
+		_cachedPicturesSize -= oldest->screenBitsSize;
+		delete[] oldest->screenBits;
+		delete oldest;
+	}
+
+	CachedPicture *picture = new CachedPicture();
+	picture->key = key;
+	picture->screenBits = new byte[size];
+	picture->screenBitsSize = size;
+	_screen->bitsSave(rect, GFX_SCREEN_MASK_ALL, picture->screenBits);
+
+	int16 *ditheredPicColors = _screen->unditherGetDitheredBgColors();
+	if (ditheredPicColors)
+		memcpy(picture->ditheredPicColors, ditheredPicColors, sizeof(picture->ditheredPicColors));
+
+	_cachedPictures.push_front(picture);
+	_cachedPicturesSize += size;
+}
+
 } // End of namespace Sci
@@ -24,17 +24,43 @@
 #define SCI_GRAPHICS_CACHE_H
 
 #include "common/hashmap.h"
+#include "common/list.h"
+#include "common/rect.h"
 
 namespace Sci {
 
 class GfxFont;
 class GfxView;
+struct CachedPicture;
 
 typedef Common::HashMap<int, GfxFont *> FontCache;
 typedef Common::HashMap<int, GfxView *> ViewCache;
+typedef Common::List<CachedPicture *> PictureCache;
 
 /**
- * Cache class, handles caching of views/fonts
+ * Identifies a drawing of a picture. Only pictures drawn onto a cleared
+ * port are cached: drawing onto other pictures (especially flood filling)
+ * depends on what's already on screen.
+ */
+struct PictureCacheKey {
+	GuiResourceId pictureId;
+	bool mirroredFlag;
+	int16 EGApaletteNo;
+	bool undithering;
+	int16 portLeft, portTop;
+	Common::Rect portRect;
+
+	bool operator==(const PictureCacheKey &other) const {
+		return pictureId == other.pictureId && mirroredFlag == other.mirroredFlag
+			&& EGApaletteNo == other.EGApaletteNo && undithering == other.undithering
+			&& portLeft == other.portLeft && portTop == other.portTop
+			&& portRect == other.portRect;
+	}
+};
+
+/**
+ * Cache class, handles caching of views/fonts and of the screen contents
+ * resulting from drawing pictures
  */
 class GfxCache {
 public:
@@ -51,9 +77,22 @@ public:
 
 	byte kernelViewGetColorAtCoordinate(GuiResourceId viewId, int16 loopNo, int16 celNo, int16 x, int16 y);
 
+	/**
+	 * Looks up the result of an earlier drawing of a picture, and copies it
+	 * to the screen.
+	 * @return true if the picture was found, false if it has to be drawn
+	 */
+	bool restorePicture(const PictureCacheKey &key);
+
+	/**
+	 * Remembers the screen contents within rect after drawing a picture.
+	 */
+	void storePicture(const PictureCacheKey &key, const Common::Rect &rect);
+
 private:
 	void purgeFontCache();
 	void purgeViewCache();
+	void purgePictureCache();
 
 	ResourceManager *_resMan;
 	GfxScreen *_screen;
@@ -61,6 +100,9 @@ private:
 
 	FontCache _cachedFonts;
 	ViewCache _cachedViews;
+
+	PictureCache _cachedPictures; ///< Most recently used first
+	uint _cachedPicturesSize;
 };
 
 } // End of namespace Sci
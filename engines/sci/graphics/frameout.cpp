@@ -66,6 +66,8 @@ GfxFrameout::GfxFrameout(SegManager *segMan, ResourceManager *resMan, GfxCoordAd
 	_curScrollText = -1;
 	_showScrollText = false;
 	_maxScrollTexts = 0;
+	_redrawNeeded = true;
+	_drawnRemappingChecksum = 0;
 }
 
 GfxFrameout::~GfxFrameout() {
@@ -77,6 +79,7 @@ void GfxFrameout::clear() {
 	_planes.clear();
 	deletePlanePictures(NULL_REG);
 	clearScrollTexts();
+	_redrawNeeded = true;
 }
 
 void GfxFrameout::clearScrollTexts() {
@@ -225,13 +228,14 @@ void GfxFrameout::kernelUpdatePlane(reg_t object) {
 			it->planeBack = readSelectorValue(_segMan, object, SELECTOR(back));
 
 			sortPlanes();
-
-			// Update the items in the plane
-			for (FrameoutList::iterator listIterator = _screenItems.begin(); listIterator != _screenItems.end(); listIterator++) {
-				reg_t itemPlane = readSelector(_segMan, (*listIterator)->object, SELECTOR(plane));
-				if (object == itemPlane) {
-					kernelUpdateScreenItem((*listIterator)->object);
-				}
+			_redrawNeeded = true;
+
+			// Update the items in the plane. Work on a copy of the list, as
+			// updating an item may move it to another plane.
+			FrameoutList planeItems = _planeItems.getVal(object, FrameoutList());
+			for (FrameoutList::iterator listIterator = planeItems.begin(); listIterator != planeItems.end(); listIterator++) {
+				if (_segMan->isObject((*listIterator)->object))
+					updateScreenItem(*listIterator);
 			}
 
 			return;
@@ -247,6 +251,7 @@ void GfxFrameout::kernelDeletePlane(reg_t object) {
 	for (PlaneList::iterator it = _planes.begin(); it != _planes.end(); ++it) {
 		if (it->object == object) {
 			_planes.erase(it);
+			_redrawNeeded = true;
 			Common::Rect planeRect;
 			planeRect.top = readSelectorValue(_segMan, object, SELECTOR(top));
 			planeRect.left = readSelectorValue(_segMan, object, SELECTOR(left));
@@ -273,8 +278,10 @@ void GfxFrameout::addPlanePicture(reg_t object, GuiResourceId pictureId, uint16
 	newPicture.picture = new GfxPicture(_resMan, _coordAdjuster, 0, _screen, _palette, pictureId, false);
 	newPicture.startX = startX;
 	newPicture.startY = startY;
-	newPicture.pictureCels = 0;
+	// The cels are refilled and added to the item list of the plane in each frame
+	newPicture.pictureCels = new FrameoutEntry[newPicture.picture->getSci32celCount()]();
 	_planePictures.push_back(newPicture);
+	_redrawNeeded = true;
 }
 
 void GfxFrameout::deletePlanePictures(reg_t object) {
@@ -282,9 +289,10 @@ void GfxFrameout::deletePlanePictures(reg_t object) {
 
 	while (it != _planePictures.end()) {
 		if (it->object == object || object.isNull()) {
-			delete it->pictureCels;
+			delete[] it->pictureCels;
 			delete it->picture;
 			it = _planePictures.erase(it);
+			_redrawNeeded = true;
 		} else {
 			++it;
 		}
@@ -303,6 +311,7 @@ reg_t GfxFrameout::addPlaneLine(reg_t object, Common::Point startPoint, Common::
 			line.priority = priority;
 			line.control = control;
 			it->lines.push_back(line);
+			_redrawNeeded = true;
 			return line.hunkId;
 		}
 	}
@@ -324,6 +333,7 @@ void GfxFrameout::updatePlaneLine(reg_t object, reg_t hunkId, Common::Point star
 					it2->color = color;
 					it2->priority = priority;
 					it2->control = control;
+					_redrawNeeded = true;
 					return;
 				}
 			}
@@ -342,6 +352,7 @@ void GfxFrameout::deletePlaneLine(reg_t object, reg_t hunkId) {
 				if (it2->hunkId == hunkId) {
 					_segMan->freeHunkEntry(hunkId);
 					it2 = it->lines.erase(it2);
+					_redrawNeeded = true;
 					return;
 				}
 			}
@@ -359,11 +370,15 @@ void GfxFrameout::kernelAddScreenItem(reg_t object) {
 	FrameoutEntry *itemEntry = new FrameoutEntry();
 	memset(itemEntry, 0, sizeof(FrameoutEntry));
 	itemEntry->object = object;
+	itemEntry->plane = NULL_REG;
 	itemEntry->givenOrderNr = _screenItems.size();
 	itemEntry->visible = true;
+	itemEntry->hasText = (lookupSelector(_segMan, object, SELECTOR(text), NULL, NULL) == kSelectorVariable);
+	itemEntry->dirty = true;
 	_screenItems.push_back(itemEntry);
+	_planeItems[itemEntry->plane].push_back(itemEntry);
 
-	kernelUpdateScreenItem(object);
+	updateScreenItem(itemEntry);
 }
 
 void GfxFrameout::kernelUpdateScreenItem(reg_t object) {
@@ -379,6 +394,18 @@ void GfxFrameout::kernelUpdateScreenItem(reg_t object) {
 		return;
 	}
 
+	updateScreenItem(itemEntry);
+}
+
+/**
+ * Reads the properties of a screen item from its object. The item gets marked
+ * dirty if any of them changed, and moved to the item list of its new plane,
+ * if that changed.
+ */
+void GfxFrameout::updateScreenItem(FrameoutEntry *itemEntry) {
+	reg_t object = itemEntry->object;
+	const FrameoutEntry oldEntry = *itemEntry;
+
 	itemEntry->viewId = readSelectorValue(_segMan, object, SELECTOR(view));
 	itemEntry->loopNo = readSelectorValue(_segMan, object, SELECTOR(loop));
 	itemEntry->celNo = readSelectorValue(_segMan, object, SELECTOR(cel));
@@ -397,6 +424,37 @@ void GfxFrameout::kernelUpdateScreenItem(reg_t object) {
 	// Check if the entry can be hidden
 	if (lookupSelector(_segMan, object, SELECTOR(visible), NULL, NULL) != kSelectorNone)
 		itemEntry->visible = readSelectorValue(_segMan, object, SELECTOR(visible));
+
+	itemEntry->useInsetRect = readSelectorValue(_segMan, object, SELECTOR(useInsetRect));
+	if (itemEntry->useInsetRect) {
+		itemEntry->insetRect.top = readSelectorValue(_segMan, object, SELECTOR(inTop));
+		itemEntry->insetRect.left = readSelectorValue(_segMan, object, SELECTOR(inLeft));
+		itemEntry->insetRect.bottom = readSelectorValue(_segMan, object, SELECTOR(inBottom));
+		itemEntry->insetRect.right = readSelectorValue(_segMan, object, SELECTOR(inRight));
+	}
+
+	// Text bitmaps may get rewritten without any property changing
+	if (itemEntry->hasText)
+		itemEntry->textChecksum = g_sci->_gfxText32->getTextBitmapChecksum(object);
+
+	if (itemEntry->viewId != oldEntry.viewId || itemEntry->loopNo != oldEntry.loopNo ||
+		itemEntry->celNo != oldEntry.celNo || itemEntry->x != oldEntry.x ||
+		itemEntry->y != oldEntry.y || itemEntry->z != oldEntry.z ||
+		itemEntry->priority != oldEntry.priority || itemEntry->signal != oldEntry.signal ||
+		itemEntry->scaleX != oldEntry.scaleX || itemEntry->scaleY != oldEntry.scaleY ||
+		itemEntry->visible != oldEntry.visible || itemEntry->useInsetRect != oldEntry.useInsetRect ||
+		itemEntry->insetRect != oldEntry.insetRect || itemEntry->textChecksum != oldEntry.textChecksum)
+		itemEntry->dirty = true;
+
+	reg_t plane = readSelector(_segMan, object, SELECTOR(plane));
+	if (plane != itemEntry->plane) {
+		_planeItems[itemEntry->plane].remove(itemEntry);
+		_planeItems[plane].push_back(itemEntry);
+		itemEntry->plane = plane;
+		itemEntry->dirty = true;
+		// The item vanished from its previous plane
+		_redrawNeeded = true;
+	}
 }
 
 void GfxFrameout::kernelDeleteScreenItem(reg_t object) {
@@ -405,30 +463,33 @@ void GfxFrameout::kernelDeleteScreenItem(reg_t object) {
 	if (!itemEntry)
 		return;
 
+	_planeItems[itemEntry->plane].remove(itemEntry);
+	deleteScreenItem(itemEntry);
+}
+
+void GfxFrameout::deleteScreenItem(FrameoutEntry *itemEntry) {
 	_screenItems.remove(itemEntry);
 	delete itemEntry;
+	_redrawNeeded = true;
 }
 
 void GfxFrameout::deletePlaneItems(reg_t planeObject) {
-	FrameoutList::iterator listIterator = _screenItems.begin();
+	if (planeObject.isNull()) {
+		for (FrameoutList::iterator listIterator = _screenItems.begin(); listIterator != _screenItems.end(); ++listIterator)
+			delete *listIterator;
+		_screenItems.clear();
+		_planeItems.clear();
+		_redrawNeeded = true;
+		return;
+	}
 
-	while (listIterator != _screenItems.end()) {
-		bool objectMatches = false;
-		if (!planeObject.isNull()) {
-			reg_t itemPlane = readSelector(_segMan, (*listIterator)->object, SELECTOR(plane));
-			objectMatches = (planeObject == itemPlane);
-		} else {
-			objectMatches = true;
-		}
+	PlaneItemMap::iterator planeItems = _planeItems.find(planeObject);
+	if (planeItems == _planeItems.end())
+		return;
 
-		if (objectMatches) {
-			FrameoutEntry *itemEntry = *listIterator;
-			listIterator = _screenItems.erase(listIterator);
-			delete itemEntry;
-		} else {
-			++listIterator;
-		}
-	}
+	for (FrameoutList::iterator listIterator = planeItems->_value.begin(); listIterator != planeItems->_value.end(); ++listIterator)
+		deleteScreenItem(*listIterator);
+	_planeItems.erase(planeItems);
 }
 
 FrameoutEntry *GfxFrameout::findScreenItem(reg_t object) {
@@ -516,19 +577,13 @@ void GfxFrameout::showVideo() {
 
 void GfxFrameout::createPlaneItemList(reg_t planeObject, FrameoutList &itemList) {
 	// Copy screen items of the current frame to the list of items to be drawn
-	for (FrameoutList::iterator listIterator = _screenItems.begin(); listIterator != _screenItems.end(); listIterator++) {
-		reg_t itemPlane = readSelector(_segMan, (*listIterator)->object, SELECTOR(plane));
-		if (planeObject == itemPlane) {
-			kernelUpdateScreenItem((*listIterator)->object);	// TODO: Why is this necessary?
-			itemList.push_back(*listIterator);
-		}
-	}
+	PlaneItemMap::const_iterator planeItems = _planeItems.find(planeObject);
+	if (planeItems != _planeItems.end())
+		itemList = planeItems->_value;
 
 	for (PlanePictureList::iterator pictureIt = _planePictures.begin(); pictureIt != _planePictures.end(); pictureIt++) {
 		if (pictureIt->object == planeObject) {
 			GfxPicture *planePicture = pictureIt->picture;
-			// Allocate memory for picture cels
-			pictureIt->pictureCels = new FrameoutEntry[planePicture->getSci32celCount()];
 
 			// Add following cels to the itemlist
 			FrameoutEntry *picEntry = pictureIt->pictureCels;
@@ -609,11 +664,53 @@ void GfxFrameout::drawPicture(FrameoutEntry *itemEntry, int16 planeOffsetX, int1
 void GfxFrameout::kernelFrameout() {
 	if (g_sci->_robotDecoder->isVideoLoaded()) {
 		showVideo();
+		_screen->invalidateShownScreen();
 		return;
 	}
 
 	_palette->palVaryUpdate();
 
+	// Scripts change screen items without calling kUpdateScreenItem, so the
+	// items of all shown planes are refreshed here. If none of them changed,
+	// neither did anything else and nothing drew over the screen since the
+	// last frame, the frame would look exactly the same, so we don't draw it.
+	bool redraw = _redrawNeeded || _showScrollText;
+
+	for (PlaneList::iterator it = _planes.begin(); it != _planes.end(); it++) {
+		// Update priority here, sq6 sets it w/o UpdatePlane
+		it->priority = readSelectorValue(_segMan, it->object, SELECTOR(priority));
+		if (it->priority != it->lastPriority)
+			redraw = true;
+		if (it->priority < 0)
+			continue;
+
+		_palette->drewPicture(it->pictureId);
+
+		FrameoutList &planeItems = _planeItems[it->object];
+		FrameoutList::iterator listIterator = planeItems.begin();
+		while (listIterator != planeItems.end()) {
+			// Updating the item may move it to the list of another plane
+			FrameoutEntry *itemEntry = *listIterator++;
+			if (_segMan->isObject(itemEntry->object))
+				updateScreenItem(itemEntry);
+			if (itemEntry->dirty)
+				redraw = true;
+		}
+	}
+
+	const uint32 remappingChecksum = _palette->getRemappingChecksum();
+	if (!redraw && remappingChecksum != _drawnRemappingChecksum) {
+		warning("kFrameout: The color remapping changed without a redraw");
+		redraw = true;
+	}
+
+	if (!redraw && _screen->isShownScreenCurrent()) {
+		g_sci->getEngineState()->_throttleTrigger = true;
+		return;
+	}
+
+	_drawnRemappingChecksum = remappingChecksum;
+
 	for (PlaneList::iterator it = _planes.begin(); it != _planes.end(); it++) {
 		reg_t planeObject = it->object;
 
@@ -630,9 +727,7 @@ void GfxFrameout::kernelFrameout() {
 		}
 
 		int16 planeLastPriority = it->lastPriority;
-
-		// Update priority here, sq6 sets it w/o UpdatePlane
-		int16 planePriority = it->priority = readSelectorValue(_segMan, planeObject, SELECTOR(priority));
+		int16 planePriority = it->priority;
 
 		it->lastPriority = planePriority;
 		if (planePriority < 0) { // Plane currently not meant to be shown
@@ -650,7 +745,6 @@ void GfxFrameout::kernelFrameout() {
 			_paint32->fillRect(it->planeRect, it->planeBack);
 
 		_coordAdjuster->pictureSetDisplayArea(it->planeRect);
-		_palette->drewPicture(it->pictureId);
 
 		FrameoutList itemList;
 
@@ -659,54 +753,56 @@ void GfxFrameout::kernelFrameout() {
 		for (FrameoutList::iterator listIterator = itemList.begin(); listIterator != itemList.end(); listIterator++) {
 			FrameoutEntry *itemEntry = *listIterator;
 
+			itemEntry->dirty = false;
+
 			if (!itemEntry->visible)
 				continue;
 
 			if (itemEntry->object.isNull()) {
-				// Picture cel data
-				_coordAdjuster->fromScriptToDisplay(itemEntry->y, itemEntry->x);
-				_coordAdjuster->fromScriptToDisplay(itemEntry->picStartY, itemEntry->picStartX);
+				// Picture cel data, the cels keep the script coordinates
+				FrameoutEntry picEntry = *itemEntry;
+				_coordAdjuster->fromScriptToDisplay(picEntry.y, picEntry.x);
+				_coordAdjuster->fromScriptToDisplay(picEntry.picStartY, picEntry.picStartX);
 
-				if (!isPictureOutOfView(itemEntry, it->planeRect, it->planeOffsetX, it->planeOffsetY))
-					drawPicture(itemEntry, it->planeOffsetX, it->planeOffsetY, it->planePictureMirrored);
+				if (!isPictureOutOfView(&picEntry, it->planeRect, it->planeOffsetX, it->planeOffsetY))
+					drawPicture(&picEntry, it->planeOffsetX, it->planeOffsetY, it->planePictureMirrored);
 			} else {
 				GfxView *view = (itemEntry->viewId != 0xFFFF) ? _cache->getView(itemEntry->viewId) : NULL;
+				// The entry keeps the script coordinates, as read by updateScreenItem()
+				int16 x = itemEntry->x;
+				int16 y = itemEntry->y;
+				int16 z = itemEntry->z;
 				int16 dummyX = 0;
 
 				if (view && view->isSci2Hires()) {
-					view->adjustToUpscaledCoordinates(itemEntry->y, itemEntry->x);
-					view->adjustToUpscaledCoordinates(itemEntry->z, dummyX);
+					view->adjustToUpscaledCoordinates(y, x);
+					view->adjustToUpscaledCoordinates(z, dummyX);
 				} else if (getSciVersion() >= SCI_VERSION_2_1) {
-					_coordAdjuster->fromScriptToDisplay(itemEntry->y, itemEntry->x);
-					_coordAdjuster->fromScriptToDisplay(itemEntry->z, dummyX);
+					_coordAdjuster->fromScriptToDisplay(y, x);
+					_coordAdjuster->fromScriptToDisplay(z, dummyX);
 				}
 
 				// Adjust according to current scroll position
-				itemEntry->x -= it->planeOffsetX;
-				itemEntry->y -= it->planeOffsetY;
-
-				uint16 useInsetRect = readSelectorValue(_segMan, itemEntry->object, SELECTOR(useInsetRect));
-				if (useInsetRect) {
-					itemEntry->celRect.top = readSelectorValue(_segMan, itemEntry->object, SELECTOR(inTop));
-					itemEntry->celRect.left = readSelectorValue(_segMan, itemEntry->object, SELECTOR(inLeft));
-					itemEntry->celRect.bottom = readSelectorValue(_segMan, itemEntry->object, SELECTOR(inBottom));
-					itemEntry->celRect.right = readSelectorValue(_segMan, itemEntry->object, SELECTOR(inRight));
+				x -= it->planeOffsetX;
+				y -= it->planeOffsetY;
+
+				if (itemEntry->useInsetRect) {
+					itemEntry->celRect = itemEntry->insetRect;
 					if (view && view->isSci2Hires()) {
 						view->adjustToUpscaledCoordinates(itemEntry->celRect.top, itemEntry->celRect.left);
 						view->adjustToUpscaledCoordinates(itemEntry->celRect.bottom, itemEntry->celRect.right);
 					}
-					itemEntry->celRect.translate(itemEntry->x, itemEntry->y);
+					itemEntry->celRect.translate(x, y);
 					// TODO: maybe we should clip the cels rect with this, i'm not sure
 					//  the only currently known usage is game menu of gk1
 				} else if (view) {
 					if ((itemEntry->scaleX == 128) && (itemEntry->scaleY == 128))
 						view->getCelRect(itemEntry->loopNo, itemEntry->celNo,
-							itemEntry->x, itemEntry->y, itemEntry->z, itemEntry->celRect);
+							x, y, z, itemEntry->celRect);
 					else
 						view->getCelScaledRect(itemEntry->loopNo, itemEntry->celNo,
-							itemEntry->x, itemEntry->y, itemEntry->z, itemEntry->scaleX,
+							x, y, z, itemEntry->scaleX,
 							itemEntry->scaleY, itemEntry->celRect);
-
 					Common::Rect nsRect = itemEntry->celRect;
 					// Translate back to actual coordinate within scrollable plane
 					nsRect.translate(it->planeOffsetX, it->planeOffsetY);
@@ -764,23 +860,17 @@ void GfxFrameout::kernelFrameout() {
 				}
 
 				// Draw text, if it exists
-				if (lookupSelector(_segMan, itemEntry->object, SELECTOR(text), NULL, NULL) == kSelectorVariable) {
-					g_sci->_gfxText32->drawTextBitmap(itemEntry->x, itemEntry->y, it->planeRect, itemEntry->object);
+				if (itemEntry->hasText) {
+					g_sci->_gfxText32->drawTextBitmap(x, y, it->planeRect, itemEntry->object);
 				}
 			}
 		}
-
-		for (PlanePictureList::iterator pictureIt = _planePictures.begin(); pictureIt != _planePictures.end(); pictureIt++) {
-			if (pictureIt->object == planeObject) {
-				delete[] pictureIt->pictureCels;
-				pictureIt->pictureCels = 0;
-			}
-		}
 	}
 
 	showCurrentScrollText();
 
-	_screen->copyToScreen();
+	_redrawNeeded = false;
+	_screen->copyChangedToScreen();
 
 	g_sci->getEngineState()->_throttleTrigger = true;
 }
@@ -23,6 +23,8 @@
 #ifndef SCI_GRAPHICS_FRAMEOUT_H
 #define SCI_GRAPHICS_FRAMEOUT_H
 
+#include "common/hashmap.h"
+
 namespace Sci {
 
 class GfxPicture;
@@ -59,6 +61,7 @@ typedef Common::List<PlaneEntry> PlaneList;
 struct FrameoutEntry {
 	uint16 givenOrderNr;
 	reg_t object;
+	reg_t plane;
 	GuiResourceId viewId;
 	int16 loopNo;
 	int16 celNo;
@@ -73,9 +76,15 @@ struct FrameoutEntry {
 	int16 picStartX;
 	int16 picStartY;
 	bool visible;
+	bool useInsetRect;
+	Common::Rect insetRect;
+	bool hasText;
+	uint32 textChecksum;
+	bool dirty;	// changed since it was last drawn
 };
 
 typedef Common::List<FrameoutEntry *> FrameoutList;
+typedef Common::HashMap<reg_t, FrameoutList, reg_t_Hash> PlaneItemMap;
 
 struct PlanePictureEntry {
 	reg_t object;
@@ -83,7 +92,7 @@ struct PlanePictureEntry {
 	int16 startY;
 	GuiResourceId pictureId;
 	GfxPicture *picture;
-	FrameoutEntry *pictureCels; // temporary
+	FrameoutEntry *pictureCels;
 };
 
 typedef Common::List<PlanePictureEntry> PlanePictureList;
@@ -138,13 +147,22 @@ public:
 	void lastScrollText() { if (_scrollTexts.size() > 0) _curScrollText = _scrollTexts.size() - 1; }
 	void prevScrollText() { if (_curScrollText > 0) _curScrollText--; }
 	void nextScrollText() { if (_curScrollText + 1 < (uint16)_scrollTexts.size()) _curScrollText++; }
-	void toggleScrollText(bool show) { _showScrollText = show; }
+	void toggleScrollText(bool show) { _showScrollText = show; _redrawNeeded = true; }
+
+	/**
+	 * Draw the next frame even if no screen item changed. Has to be called
+	 * whenever something which is only applied while drawing changes, like
+	 * the color remapping.
+	 */
+	void forceRedraw() { _redrawNeeded = true; }
 
 	void printPlaneList(Console *con);
 	void printPlaneItemList(Console *con, reg_t planeObject);
 
 private:
 	void showVideo();
+	void updateScreenItem(FrameoutEntry *itemEntry);
+	void deleteScreenItem(FrameoutEntry *itemEntry);
 	void createPlaneItemList(reg_t planeObject, FrameoutList &itemList);
 	bool isPictureOutOfView(FrameoutEntry *itemEntry, Common::Rect planeRect, int16 planeOffsetX, int16 planeOffsetY);
 	void drawPicture(FrameoutEntry *itemEntry, int16 planeOffsetX, int16 planeOffsetY, bool planePictureMirrored);
@@ -158,6 +176,8 @@ private:
 	GfxPaint32 *_paint32;
 
 	FrameoutList _screenItems;
+	/** The screen items of each plane, by plane object */
+	PlaneItemMap _planeItems;
 	PlaneList _planes;
 	PlanePictureList _planePictures;
 	ScrollTextList _scrollTexts;
@@ -165,6 +185,19 @@ private:
 	bool _showScrollText;
 	uint16 _maxScrollTexts;
 
+	/**
+	 * Set when planes, plane lines or plane pictures changed, or screen items
+	 * got deleted, so that the next frame has to be drawn. Changed screen items
+	 * are marked dirty instead.
+	 */
+	bool _redrawNeeded;
+
+	/**
+	 * The remapping checksum of the palette when the last frame was drawn.
+	 * Used to catch remapping changes which did not call forceRedraw().
+	 */
+	uint32 _drawnRemappingChecksum;
+
 	void sortPlanes();
 };
 
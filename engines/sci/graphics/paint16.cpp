@@ -66,7 +66,32 @@ void GfxPaint16::drawPicture(GuiResourceId pictureId, int16 animationNr, bool mi
 	if (!addToFlag)
 		clearScreen(_screen->getColorWhite());
 
-	picture->draw(animationNr, mirroredFlag, addToFlag, paletteId);
+	if (_EGAdrawingVisualize || addToFlag) {
+		picture->draw(animationNr, mirroredFlag, addToFlag, paletteId);
+	} else {
+		// Rooms get drawn again and again, so reuse the port contents of
+		// earlier drawings. The picture still sets up the palette and the
+		// priority bands then.
+		Port *port = _ports->getPort();
+		PictureCacheKey key;
+		key.pictureId = pictureId;
+		key.mirroredFlag = mirroredFlag;
+		key.EGApaletteNo = paletteId;
+		key.undithering = _screen->isUnditheringEnabled();
+		key.portLeft = port->left;
+		key.portTop = port->top;
+		key.portRect = port->rect;
+
+		bool cached = _cache->restorePicture(key);
+		picture->draw(animationNr, mirroredFlag, addToFlag, paletteId, !cached);
+		if (!cached) {
+			Common::Rect rect = port->rect;
+			_ports->offsetRect(rect);
+			rect.clip(_screen->getWidth(), _screen->getHeight());
+			if (!rect.isEmpty())
+				_cache->storePicture(key, rect);
+		}
+	}
 	delete picture;
 
 	// We make a call to SciPalette here, for increasing sys timestamp and also loading targetpalette, if palvary active
@@ -34,6 +34,9 @@
 #include "sci/graphics/palette.h"
 #include "sci/graphics/screen.h"
 #include "sci/graphics/view.h"
+#ifdef ENABLE_SCI32
+#include "sci/graphics/frameout.h"
+#endif
 
 namespace Sci {
 
@@ -406,6 +409,13 @@ void GfxPalette::setRemappingRange(byte color, byte from, byte to, byte base) {
 	_remappingType[color] = kRemappingByRange;
 }
 
+uint32 GfxPalette::getRemappingChecksum() const {
+	uint32 checksum = _remapOn ? 1 : 0;
+	for (int i = 0; i < 256; i++)
+		checksum = checksum * 33 + ((_remappingType[i] << 16) | (_remappingByPercent[i] << 8) | _remappingByRange[i]);
+	return checksum;
+}
+
 bool GfxPalette::insert(Palette *newPalette, Palette *destPalette) {
 	bool paletteChanged = false;
 
@@ -576,6 +586,12 @@ void GfxPalette::copySysPaletteToScreen() {
 			byte b = _sysPalette.colors[i].b * _remappingPercentToSet / 100;
 			_remappingByPercent[i] = kernelFindColor(r, g, b);
 		}
+
+#ifdef ENABLE_SCI32
+		// Remapped colors are applied when views are drawn
+		if (g_sci->_gfxFrameout)
+			g_sci->_gfxFrameout->forceRedraw();
+#endif
 	}
 
 	g_system->getPaletteManager()->setPalette(bpal, 0, 256);
@@ -67,6 +67,7 @@ public:
 		return _remapOn && (_remappingType[color] != kRemappingNone);
 	}
 	byte remapColor(byte remappedColor, byte screenColor);
+	uint32 getRemappingChecksum() const;
 
 	void setOnScreen();
 	void copySysPaletteToScreen();
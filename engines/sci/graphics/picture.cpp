@@ -36,7 +36,7 @@ namespace Sci {
 //#define DEBUG_PICTURE_DRAW
 
 GfxPicture::GfxPicture(ResourceManager *resMan, GfxCoordAdjuster *coordAdjuster, GfxPorts *ports, GfxScreen *screen, GfxPalette *palette, GuiResourceId resourceId, bool EGAdrawingVisualize)
-	: _resMan(resMan), _coordAdjuster(coordAdjuster), _ports(ports), _screen(screen), _palette(palette), _resourceId(resourceId), _EGAdrawingVisualize(EGAdrawingVisualize) {
+	: _resMan(resMan), _coordAdjuster(coordAdjuster), _ports(ports), _screen(screen), _palette(palette), _resourceId(resourceId), _rasterize(true), _EGAdrawingVisualize(EGAdrawingVisualize) {
 	assert(resourceId != -1);
 	initData(resourceId);
 }
@@ -59,7 +59,7 @@ GuiResourceId GfxPicture::getResourceId() {
 // differentiation between various picture formats can NOT get done using sci-version checks.
 //  Games like PQ1 use the "old" vector data picture format, but are actually SCI1.1
 //  We should leave this that way to decide the format on-the-fly instead of hardcoding it in any way
-void GfxPicture::draw(int16 animationNr, bool mirroredFlag, bool addToFlag, int16 EGApaletteNo) {
+void GfxPicture::draw(int16 animationNr, bool mirroredFlag, bool addToFlag, int16 EGApaletteNo, bool rasterize) {
 	uint16 headerSize;
 
 	_animationNr = animationNr;
@@ -67,6 +67,7 @@ void GfxPicture::draw(int16 animationNr, bool mirroredFlag, bool addToFlag, int1
 	_addToFlag = addToFlag;
 	_EGApaletteNo = EGApaletteNo;
 	_priority = 0;
+	_rasterize = rasterize;
 
 	headerSize = READ_LE_UINT16(_resource->data);
 	switch (headerSize) {
@@ -245,6 +246,9 @@ void GfxPicture::drawCelData(byte *inbuffer, int size, int headerPos, int rlePos
 	int pixelCount;
 	uint16 width, height;
 
+	if (!_rasterize)
+		return;
+
 #ifdef ENABLE_SCI32
 	if (_resourceType != SCI_PICTURE_TYPE_SCI32) {
 #endif
@@ -599,7 +603,8 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 				Common::Point startPoint(oldx, oldy);
 				Common::Point endPoint(x, y);
 				_ports->offsetLine(startPoint, endPoint);
-				_screen->drawLine(startPoint, endPoint, pic_color, pic_priority, pic_control);
+				if (_rasterize)
+					_screen->drawLine(startPoint, endPoint, pic_color, pic_priority, pic_control);
 			}
 			break;
 		case PIC_OP_MEDIUM_LINES: // medium line
@@ -619,7 +624,8 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 				Common::Point startPoint(oldx, oldy);
 				Common::Point endPoint(x, y);
 				_ports->offsetLine(startPoint, endPoint);
-				_screen->drawLine(startPoint, endPoint, pic_color, pic_priority, pic_control);
+				if (_rasterize)
+					_screen->drawLine(startPoint, endPoint, pic_color, pic_priority, pic_control);
 			}
 			break;
 		case PIC_OP_LONG_LINES: // long line
@@ -630,7 +636,8 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 				Common::Point startPoint(oldx, oldy);
 				Common::Point endPoint(x, y);
 				_ports->offsetLine(startPoint, endPoint);
-				_screen->drawLine(startPoint, endPoint, pic_color, pic_priority, pic_control);
+				if (_rasterize)
+					_screen->drawLine(startPoint, endPoint, pic_color, pic_priority, pic_control);
 			}
 			break;
 
@@ -800,7 +807,7 @@ void GfxPicture::drawVectorData(byte *data, int dataSize) {
 		case PIC_OP_TERMINATE:
 			_priority = pic_priority;
 			// Dithering EGA pictures
-			if (isEGA) {
+			if (isEGA && _rasterize) {
 				_screen->dither(_addToFlag);
 				switch (g_sci->getGameId()) {
 				case GID_SQ3:
@@ -893,6 +900,9 @@ void GfxPicture::vectorFloodFill(int16 x, int16 y, byte color, byte priority, by
 	byte matchedMask, matchMask;
 	int16 w, e, a_set, b_set;
 
+	if (!_rasterize)
+		return;
+
 	bool isEGA = (_resMan->getViewType() == kViewEga);
 
 	p.x = x + curPort->left;
@@ -1196,6 +1206,9 @@ void GfxPicture::vectorPattern(int16 x, int16 y, byte color, byte priority, byte
 	byte size = code & SCI_PATTERN_CODE_PENSIZE;
 	Common::Rect rect;
 
+	if (!_rasterize)
+		return;
+
 	// We need to adjust the given coordinates, because the ones given us do not define upper left but somewhat middle
 	y -= size; if (y < 0) y = 0;
 	x -= size; if (x < 0) x = 0;
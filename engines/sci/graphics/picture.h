@@ -49,7 +49,14 @@ public:
 	~GfxPicture();
 
 	GuiResourceId getResourceId();
-	void draw(int16 animationNr, bool mirroredFlag, bool addToFlag, int16 EGApaletteNo);
+
+	/**
+	 * Draws the picture.
+	 * @param rasterize	if false, only the palette and priority bands are set
+	 *					up, as the screen contents have been restored from the
+	 *					picture cache
+	 */
+	void draw(int16 animationNr, bool mirroredFlag, bool addToFlag, int16 EGApaletteNo, bool rasterize = true);
 
 #ifdef ENABLE_SCI32
 	int16 getSci32celCount();
@@ -95,6 +102,7 @@ private:
 	bool _addToFlag;
 	int16 _EGApaletteNo;
 	byte _priority;
+	bool _rasterize;
 
 	// If true, we will show the whole EGA drawing process...
 	bool _EGAdrawingVisualize;
@@ -117,6 +117,8 @@ GfxScreen::GfxScreen(ResourceManager *resMan) : _resMan(resMan) {
 
 	// Sets display screen to be actually displayed
 	_activeScreen = _displayScreen;
+	_shownScreen = NULL;
+	_shownScreenValid = false;
 
 	_picNotValid = 0;
 	_picNotValidSci11 = 0;
@@ -159,10 +161,74 @@ GfxScreen::~GfxScreen() {
 	free(_priorityScreen);
 	free(_controlScreen);
 	free(_displayScreen);
+	free(_shownScreen);
 }
 
 void GfxScreen::copyToScreen() {
 	g_system->copyRectToScreen(_activeScreen, _displayWidth, 0, 0, _displayWidth, _displayHeight);
+	_shownScreenValid = false;
+}
+
+/**
+ * Copies only the parts of the active screen that changed since the last call
+ * to the actual screen, one rectangle per run of changed lines. SCI32 redraws
+ * the whole screen every frame, even if only a few screen items moved.
+ */
+void GfxScreen::copyChangedToScreen() {
+	if (!_shownScreen)
+		_shownScreen = (byte *)malloc(_displayPixels);
+
+	if (!_shownScreenValid) {
+		g_system->copyRectToScreen(_activeScreen, _displayWidth, 0, 0, _displayWidth, _displayHeight);
+		memcpy(_shownScreen, _activeScreen, _displayPixels);
+		_shownScreenValid = true;
+		return;
+	}
+
+	int changedTop = -1;
+	int changedLeft = _displayWidth;
+	int changedRight = 0;
+
+	for (int y = 0; y <= _displayHeight; y++) {
+		int left = _displayWidth;
+		int right = 0;
+
+		if (y < _displayHeight) {
+			const byte *line = _activeScreen + y * _displayWidth;
+			byte *shownLine = _shownScreen + y * _displayWidth;
+
+			if (memcmp(line, shownLine, _displayWidth)) {
+				left = 0;
+				while (line[left] == shownLine[left])
+					left++;
+				right = _displayWidth;
+				while (line[right - 1] == shownLine[right - 1])
+					right--;
+				memcpy(shownLine + left, line + left, right - left);
+			}
+		}
+
+		if (left < right) {
+			if (changedTop < 0)
+				changedTop = y;
+			changedLeft = MIN(changedLeft, left);
+			changedRight = MAX(changedRight, right);
+		} else if (changedTop >= 0) {
+			g_system->copyRectToScreen(_activeScreen + changedTop * _displayWidth + changedLeft, _displayWidth,
+					changedLeft, changedTop, changedRight - changedLeft, y - changedTop);
+			changedTop = -1;
+			changedLeft = _displayWidth;
+			changedRight = 0;
+		}
+	}
+}
+
+/**
+ * Returns true, if the actual screen still shows what's in the active screen,
+ * i.e. if neither got changed since the last copyChangedToScreen().
+ */
+bool GfxScreen::isShownScreenCurrent() {
+	return _shownScreenValid && !memcmp(_shownScreen, _activeScreen, _displayPixels);
 }
 
 void GfxScreen::copyFromScreen(byte *buffer) {
@@ -177,6 +243,7 @@ void GfxScreen::kernelSyncWithFramebuffer() {
 	Graphics::Surface *screen = g_system->lockScreen();
 	memcpy(_displayScreen, screen->pixels, _displayPixels);
 	g_system->unlockScreen();
+	_shownScreenValid = false;
 }
 
 void GfxScreen::copyRectToScreen(const Common::Rect &rect) {
@@ -186,6 +253,7 @@ void GfxScreen::copyRectToScreen(const Common::Rect &rect) {
 		int rectHeight = _upscaledMapping[rect.bottom] - _upscaledMapping[rect.top];
 		g_system->copyRectToScreen(_activeScreen + _upscaledMapping[rect.top] * _displayWidth + rect.left * 2, _displayWidth, rect.left * 2, _upscaledMapping[rect.top], rect.width() * 2, rectHeight);
 	}
+	_shownScreenValid = false;
 }
 
 /**
@@ -196,6 +264,7 @@ void GfxScreen::copyDisplayRectToScreen(const Common::Rect &rect) {
 	if (!_upscaledHires)
 		error("copyDisplayRectToScreen: not in upscaled hires mode");
 	g_system->copyRectToScreen(_activeScreen + rect.top * _displayWidth + rect.left, _displayWidth, rect.left, rect.top, rect.width(), rect.height());
+	_shownScreenValid = false;
 }
 
 void GfxScreen::copyRectToScreen(const Common::Rect &rect, int16 x, int16 y) {
@@ -205,6 +274,7 @@ void GfxScreen::copyRectToScreen(const Common::Rect &rect, int16 x, int16 y) {
 		int rectHeight = _upscaledMapping[rect.bottom] - _upscaledMapping[rect.top];
 		g_system->copyRectToScreen(_activeScreen + _upscaledMapping[rect.top] * _displayWidth + rect.left * 2, _displayWidth, x * 2, _upscaledMapping[y], rect.width() * 2, rectHeight);
 	}
+	_shownScreenValid = false;
 }
 
 byte GfxScreen::getDrawingMask(byte color, byte prio, byte control) {
@@ -73,6 +73,9 @@ public:
 	byte getColorDefaultVectorData() { return _colorDefaultVectorData; }
 
 	void copyToScreen();
+	void copyChangedToScreen();
+	bool isShownScreenCurrent();
+	void invalidateShownScreen() { _shownScreenValid = false; }
 	void copyFromScreen(byte *buffer);
 	void kernelSyncWithFramebuffer();
 	void copyRectToScreen(const Common::Rect &rect);
@@ -169,6 +172,14 @@ private:
 	 */
 	byte *_displayScreen;
 
+	/**
+	 * Copy of what copyChangedToScreen() last copied to the actual screen,
+	 * allocated on first use. It's only valid while _shownScreenValid is set,
+	 * i.e. as long as nothing else copied to the actual screen.
+	 */
+	byte *_shownScreen;
+	bool _shownScreenValid;
+
 	ResourceManager *_resMan;
 
 	/**
@@ -204,6 +204,28 @@ void GfxText32::drawTextBitmap(int16 x, int16 y, Common::Rect planeRect, reg_t t
 	drawTextBitmapInternal(x, y, planeRect, textObject, hunkId);
 }
 
+/**
+ * Returns a checksum of everything drawTextBitmap() uses for drawing the
+ * bitmap of the given text object. The bitmap may get rewritten in place by
+ * createTextBitmap(), so GfxFrameout uses this to notice changed texts.
+ */
+uint32 GfxText32::getTextBitmapChecksum(reg_t textObject) {
+	reg_t hunkId = readSelector(_segMan, textObject, SELECTOR(bitmap));
+	uint32 checksum = (hunkId.getSegment() << 16) ^ hunkId.getOffset();
+	checksum = checksum * 33 + readSelectorValue(_segMan, textObject, SELECTOR(back));
+	checksum = checksum * 33 + readSelectorValue(_segMan, textObject, SELECTOR(skip));
+	checksum = checksum * 33 + (_screen->fontIsUpscaled() ? 1 : 0);
+
+	byte *memoryPtr = hunkId.isNull() ? NULL : _segMan->getHunkPointer(hunkId);
+	if (memoryPtr) {
+		uint size = BITMAP_HEADER_SIZE + READ_LE_UINT16(memoryPtr) * READ_LE_UINT16(memoryPtr + 2);
+		for (uint i = 0; i < size; i++)
+			checksum = checksum * 33 + memoryPtr[i];
+	}
+
+	return checksum;
+}
+
 void GfxText32::drawScrollTextBitmap(reg_t textObject, reg_t hunkId, uint16 x, uint16 y) {
 	/*reg_t plane = readSelector(_segMan, textObject, SELECTOR(plane));
 	Common::Rect planeRect;
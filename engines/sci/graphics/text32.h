@@ -35,6 +35,7 @@ public:
 	reg_t createTextBitmap(reg_t textObject, uint16 maxWidth = 0, uint16 maxHeight = 0, reg_t prevHunk = NULL_REG);
 	reg_t createScrollTextBitmap(Common::String text, reg_t textObject, uint16 maxWidth = 0, uint16 maxHeight = 0, reg_t prevHunk = NULL_REG);
 	void drawTextBitmap(int16 x, int16 y, Common::Rect planeRect, reg_t textObject);
+	uint32 getTextBitmapChecksum(reg_t textObject);
 	void drawScrollTextBitmap(reg_t textObject, reg_t hunkId, uint16 x, uint16 y);
 	void disposeTextBitmap(reg_t hunkId);
 	int16 GetLongest(const char *text, int16 maxWidth, GfxFont *font);
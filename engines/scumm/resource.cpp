@@ -47,10 +47,14 @@ enum {
 	RF_USAGE = 0x7F,
 	RF_USAGE_MAX = RF_USAGE,
 
+	RS_EXPIRE_LIST = 0x01,
+	RS_EXPIRED = 0x02,
 	RS_MODIFIED = 0x10,
 	RF_OFFHEAP = 0x40
 };
 
+static const uint32 kNoExpireKey = 0xFFFFFFFF;
+
 
 
 extern const char *nameOfResType(ResType type);
@@ -535,12 +539,15 @@ void ResourceManager::allocResTypeData(ResType type, uint32 tag, int num, ResTyp
 	if (num >= 8000)
 		error("Too many %s resources (%d) in directory", nameOfResType(type), num);
 
-	_types[type]._mode = mode;
-	_types[type]._tag = tag;
-
 	// If there was data in there, let's clear it out completely. This is important
 	// in case we are restarting the game.
+	for (ResId idx = 0; idx < _types[type].size(); idx++)
+		nukeResource(type, idx);
 	_types[type].clear();
+
+	_types[type]._mode = mode;
+	_types[type]._tag = tag;
+
 	_types[type].resize(num);
 
 /*
@@ -777,19 +784,84 @@ void ResourceManager::increaseExpireCounter() {
 }
 
 void ResourceManager::increaseResourceCounters() {
-	for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
-		ResId idx = _types[type].size();
-		while (idx-- > 0) {
-			byte counter = _types[type][idx].getResourceCounter();
-			if (counter && counter < RF_USAGE_MAX) {
-				setResourceCounter(type, idx, counter + 1);
-			}
-		}
-	}
+	// The counters of the resources in the expire list are relative to the
+	// expire clock, so this ages all of them at once.
+	++_expireClock;
 }
 
 void ResourceManager::setResourceCounter(ResType type, ResId idx, byte counter) {
-	_types[type][idx].setResourceCounter(counter);
+	Resource &res = _types[type][idx];
+
+	removeFromExpireList(type, idx);
+	res.setResourceCounter(counter);
+
+	if (counter && res._address && _types[type]._mode != kDynamicResTypeMode)
+		addToExpireList(type, idx, counter);
+}
+
+byte ResourceManager::getResourceCounter(ResType type, ResId idx) const {
+	const Resource &res = _types[type][idx];
+	if (res._status & RS_EXPIRE_LIST)
+		return getExpireCounter(res);
+	return res.getResourceCounter();
+}
+
+byte ResourceManager::getExpireCounter(const Resource &res) const {
+	const uint32 age = _expireClock - res._expireBase;
+	return (age < RF_USAGE_MAX) ? age : (uint32)RF_USAGE_MAX;
+}
+
+void ResourceManager::addToExpireList(ResType type, ResId idx, byte counter) {
+	Resource &res = _types[type][idx];
+	const uint32 key = makeExpireKey(type, idx);
+
+	if (counter > RF_USAGE_MAX)
+		counter = RF_USAGE_MAX;
+	res._expireBase = _expireClock - counter;
+	res._status |= RS_EXPIRE_LIST;
+
+	// Insert the resource behind the last one with at least the same counter.
+	// Resources are either marked as just used, which puts them at the tail,
+	// or as ready to be expired, which puts them at the head.
+	uint32 prev = kNoExpireKey;
+	if (counter < RF_USAGE_MAX) {
+		prev = _expireTail;
+		while (prev != kNoExpireKey && getExpireCounter(getExpireResource(prev)) < counter)
+			prev = getExpireResource(prev)._expirePrev;
+	}
+
+	res._expirePrev = prev;
+	if (prev == kNoExpireKey) {
+		res._expireNext = _expireHead;
+		_expireHead = key;
+	} else {
+		res._expireNext = getExpireResource(prev)._expireNext;
+		getExpireResource(prev)._expireNext = key;
+	}
+
+	if (res._expireNext == kNoExpireKey)
+		_expireTail = key;
+	else
+		getExpireResource(res._expireNext)._expirePrev = key;
+}
+
+void ResourceManager::removeFromExpireList(ResType type, ResId idx) {
+	Resource &res = _types[type][idx];
+	if (!(res._status & RS_EXPIRE_LIST))
+		return;
+
+	if (res._expirePrev == kNoExpireKey)
+		_expireHead = res._expireNext;
+	else
+		getExpireResource(res._expirePrev)._expireNext = res._expireNext;
+
+	if (res._expireNext == kNoExpireKey)
+		_expireTail = res._expirePrev;
+	else
+		getExpireResource(res._expireNext)._expirePrev = res._expirePrev;
+
+	res._expirePrev = res._expireNext = kNoExpireKey;
+	res._status &= ~RS_EXPIRE_LIST;
 }
 
 void ResourceManager::Resource::setResourceCounter(byte counter) {
@@ -831,6 +903,11 @@ byte *ResourceManager::createResource(ResType type, ResId idx, uint32 size) {
 	memset(ptr, 0, size + SAFETY_AREA);
 	_allocatedSize += size;
 
+	if (_types[type][idx]._status & RS_EXPIRED) {
+		_types[type][idx]._status &= ~RS_EXPIRED;
+		_numReloaded++;
+	}
+
 	_types[type][idx]._address = ptr;
 	_types[type][idx]._size = size;
 	setResourceCounter(type, idx, 1);
@@ -844,6 +921,9 @@ ResourceManager::Resource::Resource() {
 	_status = 0;
 	_roomno = 0;
 	_roomoffs = 0;
+	_expireBase = 0;
+	_expirePrev = kNoExpireKey;
+	_expireNext = kNoExpireKey;
 }
 
 ResourceManager::Resource::~Resource() {
@@ -872,6 +952,11 @@ ResourceManager::ResourceManager(ScummEngine *vm) : _vm(vm) {
 	_maxHeapThreshold = 0;
 	_minHeapThreshold = 0;
 	_expireCounter = 0;
+	_expireHead = kNoExpireKey;
+	_expireTail = kNoExpireKey;
+	_expireClock = 0;
+	_numExpired = 0;
+	_numReloaded = 0;
 }
 
 ResourceManager::~ResourceManager() {
@@ -898,6 +983,7 @@ void ResourceManager::nukeResource(ResType type, ResId idx) {
 	if (ptr != NULL) {
 		debugC(DEBUG_RESOURCE, "nukeResource(%s,%d)", nameOfResType(type), idx);
 		_allocatedSize -= _types[type][idx]._size;
+		removeFromExpireList(type, idx);
 		_types[type][idx].nuke();
 	}
 }
@@ -1033,10 +1119,8 @@ void ResourceManager::Resource::setOnHeap() {
 }
 
 void ResourceManager::expireResources(uint32 size) {
-	byte best_counter;
-	ResType best_type;
-	int best_res = 0;
 	uint32 oldAllocatedSize;
+	uint32 key;
 
 	if (_expireCounter != 0xFF) {
 		_expireCounter = 0xFF;
@@ -1048,35 +1132,34 @@ void ResourceManager::expireResources(uint32 size) {
 
 	oldAllocatedSize = _allocatedSize;
 
+	// The expire list only contains resources which can be reloaded from the
+	// data files, oldest first. Walk it until enough memory has been freed or
+	// only recently used resources are left, skipping those which are locked
+	// or still in use.
+	key = _expireHead;
 	do {
-		best_type = rtInvalid;
-		best_counter = 2;
-
-		for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
-			if (_types[type]._mode != kDynamicResTypeMode) {
-				// Resources of this type can be reloaded from the data files,
-				// so we can potentially unload them to free memory.
-				ResId idx = _types[type].size();
-				while (idx-- > 0) {
-					Resource &tmp = _types[type][idx];
-					byte counter = tmp.getResourceCounter();
-					if (!tmp.isLocked() && counter >= best_counter && tmp._address && !_vm->isResourceInUse(type, idx) && !tmp.isOffHeap()) {
-						best_counter = counter;
-						best_type = type;
-						best_res = idx;
-					}
-				}
-			}
-		}
+		if (key == kNoExpireKey)
+			break;
 
-		if (!best_type)
+		Resource &tmp = getExpireResource(key);
+		if (getExpireCounter(tmp) < 2)
 			break;
-		nukeResource(best_type, best_res);
+
+		const ResType type = ResType(key >> 16);
+		const ResId idx = key & 0xFFFF;
+		key = tmp._expireNext;
+
+		if (!tmp.isLocked() && !tmp.isOffHeap() && !_vm->isResourceInUse(type, idx)) {
+			nukeResource(type, idx);
+			tmp._status |= RS_EXPIRED;
+			_numExpired++;
+		}
 	} while (size + _allocatedSize > _minHeapThreshold);
 
 	increaseResourceCounters();
 
-	debugC(DEBUG_RESOURCE, "Expired resources, mem %d -> %d", oldAllocatedSize, _allocatedSize);
+	debugC(DEBUG_RESOURCE, "Expired resources, mem %d -> %d (%d expired, %d reloaded so far)",
+	       oldAllocatedSize, _allocatedSize, _numExpired, _numReloaded);
 }
 
 void ResourceManager::freeResources() {
@@ -1134,6 +1217,7 @@ void ResourceManager::resourceStats() {
 	}
 
 	debug(1, "Total allocated size=%d, locked=%d(%d)", _allocatedSize, lockedSize, lockedNum);
+	debug(1, "Expired resources=%d, reloaded after expiring=%d", _numExpired, _numReloaded);
 }
 
 void ScummEngine_v5::readMAXS(int blockSize) {
@@ -80,6 +80,7 @@ protected:
 
 public:
 	class Resource {
+	friend class ResourceManager;
 	public:
 		/**
 		 * Pointer to the data contained in this resource
@@ -100,15 +101,30 @@ public:
 		 * that it should throw out some unused stuff, then it begins by
 		 * removing the resources with the highest counter (excluding locked
 		 * resources and resources that are known to be in use).
+		 *
+		 * For resources in the expire list of the ResourceManager, the counter
+		 * is not stored here but derived from _expireBase instead.
 		 */
 		byte _flags;
 
 		/**
-		 * The status of the resource. Currently only one bit is used, which
-		 * indicates whether the resource is modified.
+		 * The status of the resource: whether it is modified, whether it is
+		 * in the expire list and whether it has been expired before.
 		 */
 		byte _status;
 
+		/**
+		 * For resources in the expire list: the value of the expire clock of
+		 * the ResourceManager at which the usage counter was zero.
+		 */
+		uint32 _expireBase;
+
+		/**
+		 * Keys (see ResourceManager::makeExpireKey) of the previous and the
+		 * next resource in the expire list.
+		 */
+		uint32 _expirePrev, _expireNext;
+
 	public:
 		/**
 		 * The id of the room (resp. the disk) the resource is contained in.
@@ -175,6 +191,26 @@ protected:
 	uint32 _maxHeapThreshold, _minHeapThreshold;
 	byte _expireCounter;
 
+	/**
+	 * All loaded resources which could be expired, i.e. which can be reloaded
+	 * from the game data files and have a non-zero usage counter. The list is
+	 * sorted by decreasing usage counter, so expireResources() only has to
+	 * look at its head instead of scanning all resources.
+	 */
+	uint32 _expireHead, _expireTail;
+
+	/**
+	 * Incremented instead of the counter of every resource in the expire
+	 * list by increaseResourceCounters().
+	 */
+	uint32 _expireClock;
+
+	/** Number of resources expired, for resourceStats() */
+	uint32 _numExpired;
+
+	/** Number of expired resources which had to be loaded again */
+	uint32 _numReloaded;
+
 public:
 	ResourceManager(ScummEngine *vm);
 	~ResourceManager();
@@ -215,8 +251,13 @@ public:
 	void setResourceCounter(ResType type, ResId idx, byte counter);
 
 	/**
-	 * Increment the counter of all unlocked loaded resources.
-	 * The maximal count is 255.
+	 * Get the specified resource's counter.
+	 */
+	byte getResourceCounter(ResType type, ResId idx) const;
+
+	/**
+	 * Increment the counter of all loaded resources which can be expired.
+	 * The maximal count is 127.
 	 * This is called by increaseExpireCounter and expireResources,
 	 * but also by ScummEngine::startScene.
 	 */
@@ -228,6 +269,12 @@ public:
 	bool validateResource(const char *str, ResType type, ResId idx) const;
 protected:
 	void expireResources(uint32 size);
+
+	static uint32 makeExpireKey(ResType type, ResId idx) { return (type << 16) | idx; }
+	Resource &getExpireResource(uint32 key) { return _types[key >> 16][key & 0xFFFF]; }
+	byte getExpireCounter(const Resource &res) const;
+	void addToExpireList(ResType type, ResId idx, byte counter);
+	void removeFromExpireList(ResType type, ResId idx);
 };
 
 } // End of namespace Scumm
@@ -190,7 +190,14 @@ bool ScummEngine::saveState(int slot, bool compat) {
 	} else {
 		filename = makeSavegameName(slot, compat);
 	}
-	if (!(out = _saveFileMan->openForSaving(filename)))
+
+	// The autosave slot is written again and again with mostly the same
+	// state, so only the changes need to be stored
+	if (slot == 0 && !compat)
+		out = _saveFileMan->openForSavingDelta(filename);
+	else
+		out = _saveFileMan->openForSaving(filename);
+	if (!out)
 		return false;
 
 	saveFailed = false;
@@ -21,14 +21,35 @@
  */
 
 #include "toon/console.h"
+#include "toon/resource.h"
 #include "toon/toon.h"
 
 namespace Toon {
 
 ToonConsole::ToonConsole(ToonEngine *vm) : GUI::Debugger(), _vm(vm) {
+	DCmd_Register("cache", WRAP_METHOD(ToonConsole, Cmd_Cache));
 }
 
 ToonConsole::~ToonConsole() {
 }
 
+bool ToonConsole::Cmd_Cache(int argc, const char **argv) {
+	Resources *resources = _vm->resources();
+
+	if (argc > 2) {
+		DebugPrintf("Usage: %s [<budget in KB>]\n", argv[0]);
+		DebugPrintf("Shows the resource cache statistics, or changes the size of the cache\n");
+		return true;
+	}
+
+	if (argc == 2)
+		resources->setCacheBudget(atoi(argv[1]) * 1024);
+
+	DebugPrintf("Resource cache: %d entries, %d of %d KB used\n",
+		resources->getCacheEntryCount(), resources->getCacheSize() / 1024, resources->getCacheBudget() / 1024);
+	DebugPrintf("%d hits, %d misses, %d evictions\n",
+		resources->getCacheHits(), resources->getCacheMisses(), resources->getCacheEvictions());
+	return true;
+}
+
 } // End of namespace Toon
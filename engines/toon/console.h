@@ -36,6 +36,8 @@ public:
 
 private:
 	ToonEngine *_vm;
+
+	bool Cmd_Cache(int argc, const char **argv);
 };
 
 } // End of namespace Toon
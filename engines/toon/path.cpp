@@ -26,151 +26,142 @@
 
 namespace Toon {
 
-PathFindingHeap::PathFindingHeap() {
-	_count = 0;
-	_size = 0;
-	_data = NULL;
+PathFinding::PathFinding() {
+	_width = 0;
+	_height = 0;
+	_sq = NULL;
+	_sqTop = 0;
+	_sqBottom = -1;
+	_walkCosts = NULL;
+	_areas = NULL;
+	_numBlockingRects = 0;
 }
 
-PathFindingHeap::~PathFindingHeap() {
-	free(_data);
+PathFinding::~PathFinding(void) {
+	delete[] _sq;
+	delete[] _walkCosts;
+	delete[] _areas;
 }
 
-void PathFindingHeap::init(int32 size) {
-	debugC(1, kDebugPath, "init(%d)", size);
-	_size = size;
-
-	free(_data);
-	_data = (HeapDataGrid *)malloc(sizeof(HeapDataGrid) * _size);
-	memset(_data, 0, sizeof(HeapDataGrid) * _size);
-	_count = 0;
-}
+void PathFinding::init(Picture *mask) {
+	debugC(1, kDebugPath, "init(mask)");
 
-void PathFindingHeap::unload() {
-	_count = 0;
-	_size = 0;
-	free(_data);
-	_data = NULL;
-}
+	_width = mask->getWidth();
+	_height = mask->getHeight();
+	_currentMask = mask;
+	delete[] _sq;
+	_sq = new uint16[_width * _height];
+	memset(_sq, 0, _width * _height * sizeof(uint16));
+	_sqTop = 0;
+	_sqBottom = -1;
 
-void PathFindingHeap::clear() {
-	debugC(1, kDebugPath, "clear()");
+	delete[] _walkCosts;
+	_walkCosts = new uint8[_width * _height];
+	updateWalkCosts(0, 0, _width, _height);
 
-	_count = 0;
-	memset(_data, 0, sizeof(HeapDataGrid) * _size);
+	delete[] _areas;
+	_areas = new uint16[_width * _height];
+	updateAreas();
 }
 
-void PathFindingHeap::push(int16 x, int16 y, uint16 weight) {
-	debugC(2, kDebugPath, "push(%d, %d, %d)", x, y, weight);
-
-	if (_count == _size) {
-		// Increase size by 50%
-		uint32 newSize = _size + (_size / 2) + 1;
-		HeapDataGrid *newData;
+/**
+ * Has to be called whenever the walkable areas of the mask got changed.
+ */
+void PathFinding::maskChanged() {
+	debugC(1, kDebugPath, "maskChanged()");
 
-		newData = (HeapDataGrid *)realloc(_data, sizeof(HeapDataGrid) * newSize);
-		if (newData == NULL) {
-			warning("Aborting attempt to push onto PathFindingHeap at maximum size: %d", _count);
-			return;
-		}
-
-		memset(newData + _size, 0, sizeof(HeapDataGrid) * (newSize - _size));
-		_data = newData;
-		_size = newSize;
+	if (_walkCosts) {
+		updateWalkCosts(0, 0, _width, _height);
+		updateAreas();
 	}
+}
 
-	_data[_count]._x = x;
-	_data[_count]._y = y;
-	_data[_count]._weight = weight;
-	_count++;
-
-	uint32 lMax = _count - 1;
-	uint32 lT = 0;
-
-	while (true) {
-		if (lMax <= 0)
-			break;
-		lT = (lMax - 1) / 2;
-
-		if (_data[lT]._weight > _data[lMax]._weight) {
-			HeapDataGrid temp;
-			temp = _data[lT];
-			_data[lT] = _data[lMax];
-			_data[lMax] = temp;
-			lMax = lT;
-		} else {
-			break;
+/**
+ * Recomputes the walk costs of the pixels in the given area, from the mask and
+ * the blocking rects and ellipses.
+ */
+void PathFinding::updateWalkCosts(int16 x1, int16 y1, int16 x2, int16 y2) {
+	x1 = MAX<int16>(x1, 0);
+	y1 = MAX<int16>(y1, 0);
+	x2 = MIN<int16>(x2, _width);
+	y2 = MIN<int16>(y2, _height);
+
+	const uint8 *maskData = _currentMask->getDataPtr();
+
+	for (int16 y = y1; y < y2; y++) {
+		uint8 *walkCost = _walkCosts + y * _width + x1;
+		for (int16 x = x1; x < x2; x++) {
+			if (!maskData || !(maskData[y * _width + x] & 0x1f))
+				*walkCost++ = kCostNotWalkable;
+			else if (isLikelyWalkable(x, y))
+				*walkCost++ = kCostFree;
+			else
+				*walkCost++ = kCostBlocked;
 		}
 	}
 }
 
-void PathFindingHeap::pop(int16 *x, int16 *y, uint16 *weight) {
-	debugC(2, kDebugPath, "pop(x, y, weight)");
+/**
+ * Numbers the connected walkable areas of the room, so that findPath() can
+ * tell right away if there is no path at all. Blocking rects and ellipses
+ * only make walking more expensive, so they don't split any areas.
+ */
+void PathFinding::updateAreas() {
+	memset(_areas, 0, _width * _height * sizeof(uint16));
 
-	if (!_count) {
-		warning("Attempt to pop empty PathFindingHeap!");
-		return;
-	}
+	Common::Array<int32> stack;
+	uint16 numAreas = 0;
 
-	*x = _data[0]._x;
-	*y = _data[0]._y;
-	*weight = _data[0]._weight;
+	for (int32 node = 0; node < _width * _height; node++) {
+		if (_walkCosts[node] == kCostNotWalkable || _areas[node])
+			continue;
 
-	_data[0] = _data[--_count];
-	if (!_count)
-		return;
+		// Give up on numbering areas in pathological masks, a zero area
+		// number just means that findPath() has to search
+		if (numAreas == 0xFFFF)
+			break;
+		numAreas++;
 
-	uint32 lMin = 0;
-	uint32 lT = 0;
+		_areas[node] = numAreas;
+		stack.push_back(node);
+		while (!stack.empty()) {
+			int32 curNode = stack.back();
+			stack.pop_back();
 
-	while (true) {
-		lT = (lMin * 2) + 1;
-		if (lT < _count) {
-			if (lT < _count - 1) {
-				if (_data[lT + 1]._weight < _data[lT]._weight)
-					lT++;
-			}
-			if (_data[lT]._weight <= _data[lMin]._weight) {
-				HeapDataGrid temp;
-				temp = _data[lMin];
-				_data[lMin] = _data[lT];
-				_data[lT] = temp;
-
-				lMin = lT;
-			} else {
-				break;
+			int16 curX = curNode % _width;
+			int16 curY = curNode / _width;
+			int16 endX = MIN<int16>(curX + 1, _width - 1);
+			int16 endY = MIN<int16>(curY + 1, _height - 1);
+			int16 startX = MAX<int16>(curX - 1, 0);
+			int16 startY = MAX<int16>(curY - 1, 0);
+
+			for (int16 py = startY; py <= endY; py++) {
+				for (int16 px = startX; px <= endX; px++) {
+					int32 pNode = px + py * _width;
+					if (_walkCosts[pNode] != kCostNotWalkable && !_areas[pNode]) {
+						_areas[pNode] = numAreas;
+						stack.push_back(pNode);
+					}
+				}
 			}
-		} else {
-			break;
 		}
 	}
-}
 
-PathFinding::PathFinding() {
-	_width = 0;
-	_height = 0;
-	_heap = new PathFindingHeap();
-	_sq = NULL;
-	_numBlockingRects = 0;
+	debugC(1, kDebugPath, "updateAreas: %d areas", numAreas);
 }
 
-PathFinding::~PathFinding(void) {
-	if (_heap)
-		_heap->unload();
-	delete _heap;
-	delete[] _sq;
-}
-
-void PathFinding::init(Picture *mask) {
-	debugC(1, kDebugPath, "init(mask)");
+void PathFinding::updateBlockingRectWalkCosts(uint8 index) {
+	if (!_walkCosts)
+		return;
 
-	_width = mask->getWidth();
-	_height = mask->getHeight();
-	_currentMask = mask;
-	_heap->unload();
-	_heap->init(500);
-	delete[] _sq;
-	_sq = new uint16[_width * _height];
+	const int16 *blockingRect = _blockingRects[index];
+	if (blockingRect[4] == 0) {
+		updateWalkCosts(blockingRect[0], blockingRect[1], blockingRect[2] + 1, blockingRect[3]);
+	} else {
+		int16 w = ABS(blockingRect[2]);
+		int16 h = ABS(blockingRect[3]);
+		updateWalkCosts(blockingRect[0] - w, blockingRect[1] - h, blockingRect[0] + w + 1, blockingRect[1] + h + 1);
+	}
 }
 
 bool PathFinding::isLikelyWalkable(int16 x, int16 y) {
@@ -189,6 +180,14 @@ bool PathFinding::isLikelyWalkable(int16 x, int16 y) {
 	return true;
 }
 
+void PathFinding::resetBlockingRects() {
+	uint8 numBlockingRects = _numBlockingRects;
+	_numBlockingRects = 0;
+
+	for (uint8 i = 0; i < numBlockingRects; i++)
+		updateBlockingRectWalkCosts(i);
+}
+
 bool PathFinding::isWalkable(int16 x, int16 y) {
 	debugC(2, kDebugPath, "isWalkable(%d, %d)", x, y);
 
@@ -207,15 +206,33 @@ bool PathFinding::findClosestWalkingPoint(int16 xx, int16 yy, int16 *fxx, int16
 	if (origY == -1)
 		origY = yy;
 
-	for (int16 y = 0; y < _height; y++) {
+	// Search the lines in the order of their distance to yy, skipping those
+	// which can't contain a closer point than the one found so far. Ties are
+	// broken by the position of the points, so that the result is the same as
+	// when scanning the lines from top to bottom.
+	int16 startY = CLIP<int16>(yy, 0, _height - 1);
+	for (int16 i = 0; i < 2 * _height; i++) {
+		int16 y = (i & 1) ? startY + (i + 1) / 2 : startY - i / 2;
+		if (y < 0 || y >= _height)
+			continue;
+
+		int32 dy = y - yy;
+		if (currentFound >= 0 && dy * dy > dist)
+			continue;
+
+		const uint8 *walkCost = _walkCosts + y * _width;
 		for (int16 x = 0; x < _width; x++) {
-			if (isWalkable(x, y) && isLikelyWalkable(x, y)) {
-				int32 ndist = (x - xx) * (x - xx) + (y - yy) * (y - yy);
+			if (walkCost[x] == kCostFree) {
+				int32 ndist = (x - xx) * (x - xx) + dy * dy;
+				if (currentFound >= 0 && ndist > dist)
+					continue;
+
 				int32 ndist2 = (x - origX) * (x - origX) + (y - origY) * (y - origY);
-				if (currentFound < 0 || ndist < dist || (ndist == dist && ndist2 < dist2)) {
+				int32 found = y * _width + x;
+				if (currentFound < 0 || ndist < dist || (ndist == dist && (ndist2 < dist2 || (ndist2 == dist2 && found < currentFound)))) {
 					dist = ndist;
 					dist2 = ndist2;
-					currentFound = y * _width + x;
+					currentFound = found;
 				}
 			}
 		}
@@ -248,14 +265,14 @@ void PathFinding::walkLine(int16 x, int16 y, int16 x2, int16 y2) {
 	int32 cdx = (dx << 16) / t;
 	int32 cdy = (dy << 16) / t;
 
-	_tempPath.clear();
+	// The path is stored backwards, from the destination to the start
+	_tempPath.resize(t + 1);
+	_tempPath[0] = Common::Point(x2, y2);
 	for (int32 i = t; i > 0; i--) {
-		_tempPath.insert_at(0, Common::Point(bx >> 16, by >> 16));
+		_tempPath[i] = Common::Point(bx >> 16, by >> 16);
 		bx += cdx;
 		by += cdy;
 	}
-
-	_tempPath.insert_at(0, Common::Point(x2, y2));
 }
 
 bool PathFinding::lineIsWalkable(int16 x, int16 y, int16 x2, int16 y2) {
@@ -303,53 +320,84 @@ bool PathFinding::findPath(int16 x, int16 y, int16 destx, int16 desty) {
 		return true;
 	}
 
-	// no direct line, we use the standard A* algorithm
-	memset(_sq , 0, _width * _height * sizeof(uint16));
-	_heap->clear();
-	int16 curX = x;
-	int16 curY = y;
-	uint16 curWeight = 0;
-
-	_sq[curX + curY *_width] = 1;
-	_heap->push(curX, curY, abs(destx - x) + abs(desty - y));
+	// the destination can't be reached if it isn't walkable or lies in another
+	// walkable area
+	uint16 startArea = _areas[x + y * _width];
+	uint16 destArea = _areas[destx + desty * _width];
+	if (_walkCosts[destx + desty * _width] == kCostNotWalkable || (startArea && destArea && startArea != destArea)) {
+		_tempPath.clear();
+		return false;
+	}
 
-	while (_heap->getCount()) {
-		_heap->pop(&curX, &curY, &curWeight);
-		int32 curNode = curX + curY * _width;
+	// no direct line, we use Dijkstra's algorithm on the precomputed walk
+	// costs. Once the destination is reached, all nodes closer to the start
+	// have their final weight in _sq, and the path reconstruction below only
+	// looks at those, so there is no need to search any further.
+	if (_sqTop <= _sqBottom)
+		memset(_sq + _sqTop * _width, 0, (_sqBottom - _sqTop + 1) * _width * sizeof(uint16));
+	_sqTop = y;
+	_sqBottom = y;
+
+	for (uint8 i = 0; i < kNumBuckets; i++)
+		_buckets[i].resize(0);
+
+	int32 curNode = x + y * _width;
+	int32 destNode = destx + desty * _width;
+	uint32 queuedNodes = 1;
+
+	_sq[curNode] = 1;
+	_buckets[1].push_back(curNode);
+
+	for (uint32 curWeight = 1; queuedNodes; curWeight++) {
+		Common::Array<int32> &bucket = _buckets[curWeight % kNumBuckets];
+
+		for (uint32 i = 0; i < bucket.size(); i++) {
+			curNode = bucket[i];
+			queuedNodes--;
+
+			// skip nodes which were reached in a cheaper way after being queued
+			if (_sq[curNode] != curWeight)
+				continue;
+			if (curNode == destNode) {
+				queuedNodes = 0;
+				break;
+			}
 
-		int16 endX = MIN<int16>(curX + 1, _width - 1);
-		int16 endY = MIN<int16>(curY + 1, _height - 1);
-		int16 startX = MAX<int16>(curX - 1, 0);
-		int16 startY = MAX<int16>(curY - 1, 0);
-		bool next = false;
+			int16 curX = curNode % _width;
+			int16 curY = curNode / _width;
+			int16 endX = MIN<int16>(curX + 1, _width - 1);
+			int16 endY = MIN<int16>(curY + 1, _height - 1);
+			int16 startX = MAX<int16>(curX - 1, 0);
+			int16 startY = MAX<int16>(curY - 1, 0);
 
-		for (int16 px = startX; px <= endX && !next; px++) {
-			for (int16 py = startY; py <= endY && !next; py++) {
-				if (px != curX || py != curY) {
-					uint16 wei = abs(px - curX) + abs(py - curY);
+			_sqTop = MIN(_sqTop, startY);
+			_sqBottom = MAX(_sqBottom, endY);
 
-					if (isWalkable(px, py)) { // walkable ?
+			for (int16 px = startX; px <= endX; px++) {
+				for (int16 py = startY; py <= endY; py++) {
+					if (px != curX || py != curY) {
 						int32 curPNode = px + py * _width;
-						uint32 sum = _sq[curNode] + wei * (1 + (isLikelyWalkable(px, py) ? 5 : 0));
-						if (sum > (uint32)0xFFFF) {
-							warning("PathFinding::findPath sum exceeds maximum representable!");
-							sum = (uint32)0xFFFF;
-						}
-						if (_sq[curPNode] > sum || !_sq[curPNode]) {
-							_sq[curPNode] = sum;
-							uint32 newWeight = _sq[curPNode] + abs(destx - px) + abs(desty - py);
-							if (newWeight > (uint32)0xFFFF) {
-								warning("PathFinding::findPath newWeight exceeds maximum representable!");
-								newWeight = (uint16)0xFFFF;
+						uint8 walkCost = _walkCosts[curPNode];
+
+						if (walkCost != kCostNotWalkable) { // walkable ?
+							uint16 wei = abs(px - curX) + abs(py - curY);
+							uint32 sum = curWeight + wei * walkCost;
+							if (sum > (uint32)0xFFFF) {
+								warning("PathFinding::findPath sum exceeds maximum representable!");
+								sum = (uint32)0xFFFF;
+							}
+							if (_sq[curPNode] > sum || !_sq[curPNode]) {
+								_sq[curPNode] = sum;
+								_buckets[sum % kNumBuckets].push_back(curPNode);
+								queuedNodes++;
 							}
-							_heap->push(px, py, newWeight);
-							if (!newWeight)
-								next = true; // we found it !
 						}
 					}
 				}
 			}
 		}
+
+		bucket.resize(0);
 	}
 
 	// let's see if we found a result !
@@ -359,8 +407,8 @@ bool PathFinding::findPath(int16 x, int16 y, int16 destx, int16 desty) {
 		return false;
 	}
 
-	curX = destx;
-	curY = desty;
+	int16 curX = destx;
+	int16 curY = desty;
 
 	Common::Array<Common::Point> retPath;
 	retPath.push_back(Common::Point(curX, curY));
@@ -426,6 +474,8 @@ void PathFinding::addBlockingRect(int16 x1, int16 y1, int16 x2, int16 y2) {
 	_blockingRects[_numBlockingRects][3] = y2;
 	_blockingRects[_numBlockingRects][4] = 0;
 	_numBlockingRects++;
+
+	updateBlockingRectWalkCosts(_numBlockingRects - 1);
 }
 
 void PathFinding::addBlockingEllipse(int16 x1, int16 y1, int16 w, int16 h) {
@@ -441,6 +491,8 @@ void PathFinding::addBlockingEllipse(int16 x1, int16 y1, int16 w, int16 h) {
 	_blockingRects[_numBlockingRects][3] = h;
 	_blockingRects[_numBlockingRects][4] = 1;
 	_numBlockingRects++;
+
+	updateBlockingRectWalkCosts(_numBlockingRects - 1);
 }
 
 } // End of namespace Toon
@@ -30,37 +30,13 @@
 
 namespace Toon {
 
-// binary heap system for fast A*
-class PathFindingHeap {
-public:
-	PathFindingHeap();
-	~PathFindingHeap();
-
-	void push(int16 x, int16 y, uint16 weight);
-	void pop(int16 *x, int16 *y, uint16 *weight);
-	void init(int32 size);
-	void clear();
-	void unload();
-	uint32 getCount() { return _count; }
-
-private:
-	struct HeapDataGrid {
-		int16 _x, _y;
-		uint16 _weight;
-	};
-
-	HeapDataGrid *_data;
-
-	uint32 _size;
-	uint32 _count;
-};
-
 class PathFinding {
 public:
 	PathFinding();
 	~PathFinding();
 
 	void init(Picture *mask);
+	void maskChanged();
 
 	bool findPath(int16 x, int16 y, int16 destX, int16 destY);
 	bool findClosestWalkingPoint(int16 xx, int16 yy, int16 *fxx, int16 *fyy, int16 origX = -1, int16 origY = -1);
@@ -69,7 +45,7 @@ public:
 	bool lineIsWalkable(int16 x, int16 y, int16 x2, int16 y2);
 	void walkLine(int16 x, int16 y, int16 x2, int16 y2);
 
-	void resetBlockingRects() { _numBlockingRects = 0; }
+	void resetBlockingRects();
 	void addBlockingRect(int16 x1, int16 y1, int16 x2, int16 y2);
 	void addBlockingEllipse(int16 x1, int16 y1, int16 w, int16 h);
 
@@ -80,14 +56,37 @@ public:
 private:
 	static const uint8 kMaxBlockingRects = 16;
 
+	// Cost factors of a step onto a pixel, as stored in _walkCosts
+	static const uint8 kCostNotWalkable = 0;
+	static const uint8 kCostBlocked = 1;
+	static const uint8 kCostFree = 6;
+
+	void updateWalkCosts(int16 x1, int16 y1, int16 x2, int16 y2);
+	void updateAreas();
+	void updateBlockingRectWalkCosts(uint8 index);
+
 	Picture *_currentMask;
 
-	PathFindingHeap *_heap;
+	// Dijkstra's algorithm only has nodes of up to 2 * kCostFree + 1 different
+	// weights queued at a time, so they are kept in a ring of buckets indexed
+	// by weight modulo kNumBuckets
+	static const uint8 kNumBuckets = 16;
+	Common::Array<int32> _buckets[kNumBuckets];
 
 	uint16 *_sq;
 	int16 _width;
 	int16 _height;
 
+	// Lines of _sq which were written to by the last search
+	int16 _sqTop;
+	int16 _sqBottom;
+
+	// Precomputed walkability and step costs of every pixel of the room
+	uint8 *_walkCosts;
+
+	// Number of the connected walkable area of every pixel, 0 if not walkable
+	uint16 *_areas;
+
 	Common::Array<Common::Point> _tempPath;
 
 	int16 _blockingRects[kMaxBlockingRects][5];
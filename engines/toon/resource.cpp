@@ -21,6 +21,7 @@
 */
 
 #include "toon/resource.h"
+#include "common/config-manager.h"
 #include "common/debug.h"
 #include "common/file.h"
 #include "common/memstream.h"
@@ -29,8 +30,10 @@
 
 namespace Toon {
 
-Resources::Resources(ToonEngine *vm) : _vm(vm), _cacheSize(0) {
-	_resourceCache.clear();
+Resources::Resources(ToonEngine *vm) : _vm(vm), _cacheSize(0), _cacheHits(0), _cacheMisses(0), _cacheEvictions(0) {
+	_cacheBudget = DEFAULT_CACHE_SIZE;
+	if (ConfMan.hasKey("resource_cache_size"))
+		_cacheBudget = ConfMan.getInt("resource_cache_size") * 1024;
 }
 
 Resources::~Resources() {
@@ -57,55 +60,30 @@ void Resources::removePackageFromCache(const Common::String &packName) {
 }
 
 bool Resources::getFromCache(const Common::String &fileName, uint32 *fileSize, uint8 **fileData) {
-	for (Common::Array<CacheEntry *>::iterator entry = _resourceCache.begin(); entry != _resourceCache.end(); ++entry) {
-		if ((*entry)->_data && (*entry)->_fileName.compareToIgnoreCase(fileName) == 0) {
-			debugC(5, kDebugResource, "getFromCache(%s) - Got %d bytes from %s", fileName.c_str(), (*entry)->_size, (*entry)->_packName.c_str());
-			(*entry)->_age = 0;
-			*fileSize = (*entry)->_size;
-			*fileData = (*entry)->_data;
-			return true;
-			}
-		}
-	return false;
+	CacheMap::iterator it = _resourceCacheMap.find(fileName);
+	if (it == _resourceCacheMap.end())
+		return false;
+
+	CacheEntry *entry = it->_value;
+	debugC(5, kDebugResource, "getFromCache(%s) - Got %d bytes from %s", fileName.c_str(), entry->_size, entry->_packName.c_str());
+
+	// Move the entry to the end of the list, as the most recently used one
+	_resourceCache.erase(entry->_lruPosition);
+	_resourceCache.push_back(entry);
+	entry->_lruPosition = _resourceCache.reverse_begin();
+
+	*fileSize = entry->_size;
+	*fileData = entry->_data;
+	_cacheHits++;
+	return true;
 }
 
 void Resources::addToCache(const Common::String &packName, const Common::String &fileName, uint32 fileSize, uint8 *fileData) {
 	debugC(5, kDebugResource, "addToCache(%s, %s, %d) - Total Size: %d", packName.c_str(), fileName.c_str(), fileSize, _cacheSize + fileSize);
-	for (Common::Array<CacheEntry *>::iterator entry = _resourceCache.begin(); entry != _resourceCache.end(); ++entry) {
-		if ((*entry)->_data) {
-			(*entry)->_age++;
-		}
-	}
-	_cacheSize += fileSize;
-
-	while (_cacheSize > MAX_CACHE_SIZE) {
-		CacheEntry *bestEntry = 0;
-		for (Common::Array<CacheEntry *>::iterator entry = _resourceCache.begin(); entry != _resourceCache.end(); ++entry) {
-			if ((*entry)->_data) {
-				if (!bestEntry || ((*entry)->_age >= bestEntry->_age && (*entry)->_size >= bestEntry->_size)) {
-					bestEntry = *entry;
-				}
-			}
-		}
-		if (!bestEntry)
-			break;
-
-		free(bestEntry->_data);
-		bestEntry->_data = 0;
-		_cacheSize -= bestEntry->_size;
-		debugC(5, kDebugResource, "Freed %s (%s) to reclaim %d bytes", bestEntry->_fileName.c_str(), bestEntry->_packName.c_str(), bestEntry->_size);
-	}
 
-	for (Common::Array<CacheEntry *>::iterator entry = _resourceCache.begin(); entry != _resourceCache.end(); ++entry) {
-		if (!(*entry)->_data) {
-			(*entry)->_packName = packName;
-			(*entry)->_fileName = fileName;
-			(*entry)->_age = 0;
-			(*entry)->_size = fileSize;
-			(*entry)->_data = fileData;
-			return;
-		}
-	}
+	// Make room for the new entry. It is always kept, even if it's larger
+	// than the whole budget, as the caller still has to copy the data.
+	shrinkCache(_cacheBudget > fileSize ? _cacheBudget - fileSize : 0);
 
 	CacheEntry *entry = new CacheEntry();
 	entry->_packName = packName;
@@ -113,6 +91,30 @@ void Resources::addToCache(const Common::String &packName, const Common::String
 	entry->_size = fileSize;
 	entry->_data = fileData;
 	_resourceCache.push_back(entry);
+	entry->_lruPosition = _resourceCache.reverse_begin();
+	_resourceCacheMap[fileName] = entry;
+	_cacheSize += fileSize;
+}
+
+/**
+ * Frees the least recently used cache entries until the cache takes up at
+ * most the given number of bytes.
+ */
+void Resources::shrinkCache(uint32 size) {
+	while (_cacheSize > size && !_resourceCache.empty()) {
+		CacheEntry *entry = _resourceCache.front();
+		_resourceCache.pop_front();
+		_resourceCacheMap.erase(entry->_fileName);
+		_cacheSize -= entry->_size;
+		_cacheEvictions++;
+		debugC(5, kDebugResource, "Freed %s (%s) to reclaim %d bytes", entry->_fileName.c_str(), entry->_packName.c_str(), entry->_size);
+		delete entry;
+	}
+}
+
+void Resources::setCacheBudget(uint32 budget) {
+	_cacheBudget = budget;
+	shrinkCache(_cacheBudget);
 }
 
 void Resources::openPackage(const Common::String &fileName) {
@@ -171,6 +173,7 @@ uint8 *Resources::getFileData(const Common::String &fileName, uint32 *fileSize)
 			return locFileData;
 		}
 
+		_cacheMisses++;
 		for (uint32 i = 0; i < _pakFiles.size(); i++) {
 
 			locFileData = _pakFiles[i]->getFileData(fileName, &locFileSize);
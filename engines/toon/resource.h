@@ -24,11 +24,16 @@
 #define TOON_RESOURCE_H
 
 #include "common/array.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/list.h"
 #include "common/str.h"
 #include "common/file.h"
 #include "common/stream.h"
 
-#define MAX_CACHE_SIZE	(4 * 1024 * 1024)
+// Default size of the resource cache, can be changed with the
+// "resource_cache_size" config key (in KB)
+#define DEFAULT_CACHE_SIZE	(4 * 1024 * 1024)
 
 namespace Toon {
 
@@ -60,16 +65,16 @@ class ToonEngine;
 
 class CacheEntry {
 public:
-	CacheEntry() : _age(0), _size(0), _data(0) {}
+	CacheEntry() : _size(0), _data(0) {}
 	~CacheEntry() {
 		free(_data);
 	}
 
 	Common::String _packName;
 	Common::String _fileName;
-	uint32 _age;
 	uint32 _size;
 	uint8 *_data;
+	Common::List<CacheEntry *>::iterator _lruPosition;
 };
 
 class Resources {
@@ -82,14 +87,31 @@ public:
 	uint8 *getFileData(const Common::String &fileName, uint32 *fileSize); // this memory must be copied to your own structures!
 	void purgeFileData();
 
+	void setCacheBudget(uint32 budget);
+	uint32 getCacheBudget() const { return _cacheBudget; }
+	uint32 getCacheSize() const { return _cacheSize; }
+	uint32 getCacheEntryCount() const { return _resourceCacheMap.size(); }
+	uint32 getCacheHits() const { return _cacheHits; }
+	uint32 getCacheMisses() const { return _cacheMisses; }
+	uint32 getCacheEvictions() const { return _cacheEvictions; }
+
 protected:
+	typedef Common::List<CacheEntry *> CacheList;
+	typedef Common::HashMap<Common::String, CacheEntry *, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> CacheMap;
+
 	ToonEngine *_vm;
 	Common::Array<uint8 *> _allocatedFileData;
 	Common::Array<PakFile *> _pakFiles;
 	uint32 _cacheSize;
-	Common::Array<CacheEntry *> _resourceCache;
+	uint32 _cacheBudget;
+	CacheList _resourceCache;	// least recently used entries first
+	CacheMap _resourceCacheMap;	// the same entries, by file name
+	uint32 _cacheHits;
+	uint32 _cacheMisses;
+	uint32 _cacheEvictions;
 
 	void removePackageFromCache(const Common::String &packName);
+	void shrinkCache(uint32 size);
 	bool getFromCache(const Common::String &fileName, uint32 *fileSize, uint8 **fileData);
 	void addToCache(const Common::String &packName, const Common::String &fileName, uint32 fileSize, uint8 *fileData);
 };
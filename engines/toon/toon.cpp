@@ -3183,6 +3183,7 @@ bool ToonEngine::loadGame(int32 slot) {
 				int16 x = rStr.readSint16BE();
 				int16 y = rStr.readSint16BE();
 				getMask()->floodFillNotWalkableOnMask(x, y);
+				_pathFinding->maskChanged();
 				break;
 			}
 			default:
@@ -4624,10 +4625,12 @@ void ToonEngine::unloadTextsVariants(char **texts) {
 
 void ToonEngine::makeLineNonWalkable(int32 x, int32 y, int32 x2, int32 y2) {
 	_currentMask->drawLineOnMask(x, y, x2, y2, false);
+	_pathFinding->maskChanged();
 }
 
 void ToonEngine::makeLineWalkable(int32 x, int32 y, int32 x2, int32 y2) {
 	_currentMask->drawLineOnMask(x, y, x2, y2, true);
+	_pathFinding->maskChanged();
 }
 
 void ToonEngine::playRoomMusic() {
@@ -95,6 +95,22 @@ inline void crossBlitLogic3BppSource(byte *dst, const byte *src, const uint w, c
 	}
 }
 
+template<typename DstColor>
+inline void crossBlitMapLogic(byte *dst, const byte *src, const uint w, const uint h,
+                              const uint srcDelta, const uint dstDelta, const uint32 *map) {
+	for (uint y = 0; y < h; ++y) {
+		for (uint x = 0; x < w; ++x) {
+			*(DstColor *)dst = (DstColor)map[*src];
+
+			++src;
+			dst += sizeof(DstColor);
+		}
+
+		src += srcDelta;
+		dst += dstDelta;
+	}
+}
+
 } // End of anonymous namespace
 
 // Function to blit a rect from one color format to another
@@ -166,4 +182,25 @@ bool crossBlit(byte *dst, const byte *src,
 	return true;
 }
 
+bool crossBlitMap(byte *dst, const byte *src,
+                  const uint dstPitch, const uint srcPitch,
+                  const uint w, const uint h,
+                  const uint bytesPerPixel, const uint32 *map) {
+	// Converting in place is not supported, since the destination pixels
+	// are larger than the source ones.
+	if (dst == src)
+		return false;
+
+	const uint srcDelta = (srcPitch - w);
+	const uint dstDelta = (dstPitch - w * bytesPerPixel);
+
+	if (bytesPerPixel == 2)
+		crossBlitMapLogic<uint16>(dst, src, w, h, srcDelta, dstDelta, map);
+	else if (bytesPerPixel == 4)
+		crossBlitMapLogic<uint32>(dst, src, w, h, srcDelta, dstDelta, map);
+	else
+		return false;
+	return true;
+}
+
 } // End of namespace Graphics
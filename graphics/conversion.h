@@ -72,6 +72,30 @@ bool crossBlit(byte *dst, const byte *src,
                const uint w, const uint h,
                const Graphics::PixelFormat &dstFmt, const Graphics::PixelFormat &srcFmt);
 
+/**
+ * Blits a rectangle of 8 bit paletted graphics data to a 2 or 4 Bpp format,
+ * by looking up every pixel in a table of the palette colors in the
+ * destination format. This is the direct way from a paletted screen to the
+ * input of the scalers.
+ *
+ * @param dstbuf		the buffer which will recieve the converted graphics data
+ * @param srcbuf		the buffer containing the original graphics data
+ * @param dstpitch		width in bytes of one full line of the dest buffer
+ * @param srcpitch		width in bytes of one full line of the source buffer
+ * @param w				the width of the graphics data
+ * @param h				the height of the graphics data
+ * @param bytesPerPixel	the number of bytes per destination pixel
+ * @param map			the 256 palette colors in the destination format
+ * @return				true if conversion completes successfully,
+ *						false if there is an error.
+ *
+ * @note Converting in place is not supported.
+ */
+bool crossBlitMap(byte *dst, const byte *src,
+                  const uint dstPitch, const uint srcPitch,
+                  const uint w, const uint h,
+                  const uint bytesPerPixel, const uint32 *map);
+
 } // End of namespace Graphics
 
 #endif // GRAPHICS_CONVERSION_H
@@ -28,6 +28,17 @@
 #include "common/endian.h"
 #include "common/stream.h"
 #include "common/textconsole.h"
+#include "common/util.h"
+
+// The IDCT transforms four rows or columns at once with SSE2 or NEON. The
+// results are bit-exact with the C version.
+#if defined(__SSE2__)
+#define JPEG_IDCT_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define JPEG_IDCT_NEON
+#include <arm_neon.h>
+#endif
 
 namespace Graphics {
 
@@ -45,7 +56,8 @@ static const uint8 _zigZagOrder[64] = {
 
 JPEGDecoder::JPEGDecoder() : ImageDecoder(),
 	_stream(NULL), _w(0), _h(0), _numComp(0), _components(NULL), _numScanComp(0),
-	_scanComp(NULL), _currentComp(NULL), _rgbSurface(0) {
+	_scanComp(NULL), _currentComp(NULL), _rgbSurface(0), _stripY(0),
+	_bitsData(0), _bitsNumber(0), _bitsEnd(false) {
 
 	// Initialize the quantization tables
 	for (int i = 0; i < JPEG_MAX_QUANT_TABLES; i++)
@@ -57,6 +69,7 @@ JPEGDecoder::JPEGDecoder() : ImageDecoder(),
 		_huff[i].values = NULL;
 		_huff[i].sizes = NULL;
 		_huff[i].codes = NULL;
+		buildHuffLookup(_huff[i]);
 	}
 }
 
@@ -72,9 +85,12 @@ const Surface *JPEGDecoder::getSurface() const {
 	if (_rgbSurface)
 		return _rgbSurface;
 
-	// Create an RGBA8888 surface
+	// Create an RGBA8888 surface, unless another format has been asked for
 	_rgbSurface = new Graphics::Surface();
-	_rgbSurface->create(_w, _h, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+	if (_outputFormat.bytesPerPixel)
+		_rgbSurface->create(_w, _h, _outputFormat);
+	else
+		_rgbSurface->create(_w, _h, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
 
 	// Get our component surfaces
 	const Graphics::Surface *yComponent = getComponent(1);
@@ -115,14 +131,21 @@ void JPEGDecoder::destroy() {
 		delete[] _huff[i].values; _huff[i].values = NULL;
 		delete[] _huff[i].sizes; _huff[i].sizes = NULL;
 		delete[] _huff[i].codes; _huff[i].codes = NULL;
+		buildHuffLookup(_huff[i]);
 	}
 
 	if (_rgbSurface) {
 		_rgbSurface->free();
 		delete _rgbSurface;
+		_rgbSurface = 0;
 	}
 }
 
+void JPEGDecoder::setOutputPixelFormat(const PixelFormat &format) {
+	assert(format.bytesPerPixel == 2 || format.bytesPerPixel == 4);
+	_outputFormat = format;
+}
+
 bool JPEGDecoder::loadStream(Common::SeekableReadStream &stream) {
 	// Reset member variables and tables from previous reads
 	destroy();
@@ -336,11 +359,40 @@ bool JPEGDecoder::readDHT() {
 			curCode++;
 			cur++;
 		}
+
+		buildHuffLookup(_huff[tableNum]);
 	}
 
 	return true;
 }
 
+void JPEGDecoder::buildHuffLookup(HuffmanTable &table) {
+	memset(table.lookup, 0, sizeof(table.lookup));
+
+	for (int len = 0; len <= 16; len++) {
+		table.maxCode[len] = -1;
+		table.valueOffset[len] = 0;
+	}
+
+	for (int i = 0; i < table.count; i++) {
+		uint8 size = table.sizes[i];
+
+		// The codes are sorted by size, so the first code of each size
+		// gives the offset and the last one the maximum
+		if (table.maxCode[size] < 0)
+			table.valueOffset[size] = i - table.codes[i];
+		table.maxCode[size] = table.codes[i];
+
+		// Fill all lookup entries starting with a short enough code
+		if (size <= kHuffLookupBits) {
+			uint16 first = table.codes[i] << (kHuffLookupBits - size);
+			uint16 count = 1 << (kHuffLookupBits - size);
+			for (uint16 j = 0; j < count; j++)
+				table.lookup[first + j] = (size << 8) | table.values[i];
+		}
+	}
+}
+
 // Marker 0xDA (Start Of Scan)
 bool JPEGDecoder::readSOS() {
 	debug(5, "JPEG: readSOS");
@@ -418,7 +470,9 @@ bool JPEGDecoder::readSOS() {
 	}
 
 	// Entropy coded sequence starts, initialize Huffman decoder
+	_bitsData = 0;
 	_bitsNumber = 0;
+	_bitsEnd = false;
 
 	// Read all the scan MCUs
 	uint16 xMCU = _w / (_maxFactorH * 8);
@@ -430,15 +484,34 @@ bool JPEGDecoder::readSOS() {
 	if (_h % (_maxFactorV * 8) != 0)
 		yMCU++;
 
+	// A YCbCr image can be converted to the output format one row of
+	// MCUs at a time, so that the components only need that many lines
+	bool convertStrips = _outputFormat.bytesPerPixel && _numScanComp == 3 && _numComp == 3;
+	for (uint16 c = 0; c < _numScanComp; c++)
+		if (_scanComp[c]->id < 1 || _scanComp[c]->id > 3)
+			convertStrips = false;
+
 	// Initialize the scan surfaces
+	const uint16 stripHeight = _maxFactorV * 8;
 	for (uint16 c = 0; c < _numScanComp; c++) {
-		_scanComp[c]->surface.create(xMCU * _maxFactorH * 8, yMCU * _maxFactorV * 8, PixelFormat::createFormatCLUT8());
+		_scanComp[c]->surface.create(xMCU * _maxFactorH * 8, convertStrips ? stripHeight : yMCU * stripHeight, PixelFormat::createFormatCLUT8());
+	}
+
+	if (convertStrips) {
+		if (!_rgbSurface)
+			_rgbSurface = new Graphics::Surface();
+		_rgbSurface->create(_w, _h, _outputFormat);
 	}
 
+	_stripY = 0;
+
 	bool ok = true;
 	uint16 interval = _restartInterval;
 
 	for (int y = 0; ok && (y < yMCU); y++) {
+		if (convertStrips)
+			_stripY = y * stripHeight;
+
 		for (int x = 0; ok && (x < xMCU); x++) {
 			ok = readMCU(x, y);
 
@@ -449,25 +522,45 @@ bool JPEGDecoder::readSOS() {
 
 				if (interval == 0) {
 					interval = _restartInterval;
-					_bitsNumber = 0;
+					alignBits();
 
 					for (byte i = 0; i < _numScanComp; i++)
 						_scanComp[i]->DCpredictor = 0;
 				}
 			}
 		}
+
+		if (ok && convertStrips)
+			outputStrip(_stripY, MIN<int>(stripHeight, _h - _stripY));
 	}
 
 	// Trim Component surfaces back to image height and width
 	// Note: Code using jpeg must use surface.pitch correctly...
 	for (uint16 c = 0; c < _numScanComp; c++) {
 		_scanComp[c]->surface.w = _w;
-		_scanComp[c]->surface.h = _h;
+		if (!convertStrips)
+			_scanComp[c]->surface.h = _h;
 	}
 
 	return ok;
 }
 
+void JPEGDecoder::outputStrip(uint16 y, uint16 h) {
+	const Graphics::Surface *yComponent = getComponent(1);
+	const Graphics::Surface *uComponent = getComponent(2);
+	const Graphics::Surface *vComponent = getComponent(3);
+
+	// Convert into the lines of the output surface
+	Graphics::Surface dst;
+	dst.w = _w;
+	dst.h = h;
+	dst.pitch = _rgbSurface->pitch;
+	dst.format = _rgbSurface->format;
+	dst.pixels = _rgbSurface->getBasePtr(0, y);
+
+	YUVToRGBMan.convert444(&dst, Graphics::YUVToRGBManager::kScaleFull, (const byte *)yComponent->pixels, (const byte *)uComponent->pixels, (const byte *)vComponent->pixels, _w, h, yComponent->pitch, uComponent->pitch);
+}
+
 // Marker 0xDB (Define Quantization Tables)
 bool JPEGDecoder::readDQT() {
 	debug(5, "JPEG: readDQT");
@@ -548,12 +641,13 @@ bool JPEGDecoder::readMCU(uint16 xMCU, uint16 yMCU) {
 void JPEGDecoder::idct1D8x8(int32 src[8], int32 dest[64], int32 ps, int32 half) {
 	int p, n;
 
-	src[0] <<= 9;
-	src[1] <<= 7;
+	// Multiply instead of shifting, the coefficients may be negative
+	src[0] *= 512;
+	src[1] *= 128;
 	src[3] *= 181;
-	src[4] <<= 9;
+	src[4] *= 512;
 	src[5] *= 181;
-	src[7] <<= 7;
+	src[7] *= 128;
 
 	// Even part
 	xmul(src[6], src[2], 277, 669, 0)
@@ -574,56 +668,184 @@ void JPEGDecoder::idct1D8x8(int32 src[8], int32 dest[64], int32 ps, int32 half)
 	dest[7 * 8] = (src[0] - src[1]) >> ps;
 }
 
+#if defined(JPEG_IDCT_SSE2) || defined(JPEG_IDCT_NEON)
+
+#ifdef JPEG_IDCT_SSE2
+typedef __m128i IdctVector;
+
+static inline IdctVector idctLoad(const int32 *src) { return _mm_loadu_si128((const __m128i *)src); }
+static inline void idctStore(int32 *dest, IdctVector a) { _mm_storeu_si128((__m128i *)dest, a); }
+static inline IdctVector idctSet(int32 value) { return _mm_set1_epi32(value); }
+static inline IdctVector idctAdd(IdctVector a, IdctVector b) { return _mm_add_epi32(a, b); }
+static inline IdctVector idctSub(IdctVector a, IdctVector b) { return _mm_sub_epi32(a, b); }
+static inline IdctVector idctShiftLeft(IdctVector a, int bits) { return _mm_sll_epi32(a, _mm_cvtsi32_si128(bits)); }
+static inline IdctVector idctShiftRight(IdctVector a, int bits) { return _mm_sra_epi32(a, _mm_cvtsi32_si128(bits)); }
+
+static inline IdctVector idctMul(IdctVector a, int32 k) {
+	// SSE2 has no 32 bit multiplication keeping the low halves, so multiply
+	// the even and the odd elements separately and merge the results.
+	const __m128i factor = _mm_set1_epi32(k);
+	const __m128i even = _mm_mul_epu32(a, factor);
+	const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), factor);
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static inline void idctTranspose(IdctVector &r0, IdctVector &r1, IdctVector &r2, IdctVector &r3) {
+	const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+	const __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+	const __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+	const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+	r0 = _mm_unpacklo_epi64(t0, t1);
+	r1 = _mm_unpackhi_epi64(t0, t1);
+	r2 = _mm_unpacklo_epi64(t2, t3);
+	r3 = _mm_unpackhi_epi64(t2, t3);
+}
+#endif
+
+#ifdef JPEG_IDCT_NEON
+typedef int32x4_t IdctVector;
+
+static inline IdctVector idctLoad(const int32 *src) { return vld1q_s32(src); }
+static inline void idctStore(int32 *dest, IdctVector a) { vst1q_s32(dest, a); }
+static inline IdctVector idctSet(int32 value) { return vdupq_n_s32(value); }
+static inline IdctVector idctAdd(IdctVector a, IdctVector b) { return vaddq_s32(a, b); }
+static inline IdctVector idctSub(IdctVector a, IdctVector b) { return vsubq_s32(a, b); }
+static inline IdctVector idctShiftLeft(IdctVector a, int bits) { return vshlq_s32(a, vdupq_n_s32(bits)); }
+static inline IdctVector idctShiftRight(IdctVector a, int bits) { return vshlq_s32(a, vdupq_n_s32(-bits)); }
+static inline IdctVector idctMul(IdctVector a, int32 k) { return vmulq_n_s32(a, k); }
+
+static inline void idctTranspose(IdctVector &r0, IdctVector &r1, IdctVector &r2, IdctVector &r3) {
+	const int32x4x2_t t01 = vtrnq_s32(r0, r1);
+	const int32x4x2_t t23 = vtrnq_s32(r2, r3);
+	r0 = vcombine_s32(vget_low_s32(t01.val[0]), vget_low_s32(t23.val[0]));
+	r1 = vcombine_s32(vget_low_s32(t01.val[1]), vget_low_s32(t23.val[1]));
+	r2 = vcombine_s32(vget_high_s32(t01.val[0]), vget_high_s32(t23.val[0]));
+	r3 = vcombine_s32(vget_high_s32(t01.val[1]), vget_high_s32(t23.val[1]));
+}
+#endif
+
+// Same as xadd3 and xmul, on vectors
+#define xadd3v(xa, xb, xc, xd, h) \
+	p = idctAdd(xa, xb); \
+	n = idctSub(xa, xb); \
+	xa = idctAdd(idctAdd(p, xc), h); \
+	xb = idctAdd(idctAdd(n, xd), h); \
+	xc = idctAdd(idctSub(p, xc), h); \
+	xd = idctAdd(idctSub(n, xd), h);
+
+#define xmulv(xa, xb, k1, k2, sh) \
+	n = idctMul(idctAdd(xa, xb), k1); \
+	p = xa; \
+	xa = idctShiftRight(idctAdd(n, idctMul(xb, k2 - k1)), sh); \
+	xb = idctShiftRight(idctSub(n, idctMul(p, k2 + k1)), sh);
+
+/**
+ * idct1D8x8() of the four rows starting with row first of src, each of the
+ * vectors holding the same element of the four rows. The output goes to the
+ * columns first to first + 3 of dest, as with idct1D8x8().
+ */
+static void idct1D8x8Vector(const int32 src[64], int first, int32 dest[64], int32 ps, int32 half) {
+	IdctVector s[8];
+	for (int i = 0; i < 8; i += 4) {
+		s[i + 0] = idctLoad(&src[(first + 0) * 8 + i]);
+		s[i + 1] = idctLoad(&src[(first + 1) * 8 + i]);
+		s[i + 2] = idctLoad(&src[(first + 2) * 8 + i]);
+		s[i + 3] = idctLoad(&src[(first + 3) * 8 + i]);
+		idctTranspose(s[i + 0], s[i + 1], s[i + 2], s[i + 3]);
+	}
+
+	const IdctVector h = idctSet(half);
+	const IdctVector zero = idctSet(0);
+	IdctVector p, n;
+
+	s[0] = idctShiftLeft(s[0], 9);
+	s[1] = idctShiftLeft(s[1], 7);
+	s[3] = idctMul(s[3], 181);
+	s[4] = idctShiftLeft(s[4], 9);
+	s[5] = idctMul(s[5], 181);
+	s[7] = idctShiftLeft(s[7], 7);
+
+	// Even part
+	xmulv(s[6], s[2], 277, 669, 0)
+	xadd3v(s[0], s[4], s[6], s[2], h)
+
+	// Odd part
+	xadd3v(s[1], s[7], s[3], s[5], zero)
+	xmulv(s[5], s[3], 251, 50, 6)
+	xmulv(s[1], s[7], 213, 142, 6)
+
+	idctStore(&dest[0 * 8 + first], idctShiftRight(idctAdd(s[0], s[1]), ps));
+	idctStore(&dest[1 * 8 + first], idctShiftRight(idctAdd(s[4], s[5]), ps));
+	idctStore(&dest[2 * 8 + first], idctShiftRight(idctAdd(s[2], s[3]), ps));
+	idctStore(&dest[3 * 8 + first], idctShiftRight(idctAdd(s[6], s[7]), ps));
+	idctStore(&dest[4 * 8 + first], idctShiftRight(idctSub(s[6], s[7]), ps));
+	idctStore(&dest[5 * 8 + first], idctShiftRight(idctSub(s[2], s[3]), ps));
+	idctStore(&dest[6 * 8 + first], idctShiftRight(idctSub(s[4], s[5]), ps));
+	idctStore(&dest[7 * 8 + first], idctShiftRight(idctSub(s[0], s[1]), ps));
+}
+
+#undef xadd3v
+#undef xmulv
+
 void JPEGDecoder::idct2D8x8(int32 block[64]) {
 	int32 tmp[64];
 
 	// Apply 1D IDCT to rows
-	for (int i = 0; i < 8; i++)
-		idct1D8x8(&block[i * 8], &tmp[i], 9, 1 << 8);
+	idct1D8x8Vector(block, 0, tmp, 9, 1 << 8);
+	idct1D8x8Vector(block, 4, tmp, 9, 1 << 8);
 
 	// Apply 1D IDCT to columns
-	for (int i = 0; i < 8; i++)
-		idct1D8x8(&tmp[i * 8], &block[i], 12, 1 << 11);
- }
-
-bool JPEGDecoder::readDataUnit(uint16 x, uint16 y) {
-	// Prepare an empty data array
-	int16 readData[64];
-	for (int i = 1; i < 64; i++)
-		readData[i] = 0;
+	idct1D8x8Vector(tmp, 0, block, 12, 1 << 11);
+	idct1D8x8Vector(tmp, 4, block, 12, 1 << 11);
+}
 
-	// Read the DC component
-	readData[0] = _currentComp->DCpredictor + readDC();
-	_currentComp->DCpredictor = readData[0];
+#else
 
-	// Read the AC components (stored in Zig-Zag)
-	readAC(readData);
+void JPEGDecoder::idct2D8x8(int32 block[64]) {
+	int32 tmp[64];
 
-	// Calculate the DCT coefficients from the input sequence
-	int32 block[64];
-	for (uint8 i = 0; i < 64; i++) {
-		// Dequantize
-		int32 val = readData[i];
-		int16 quant = _quant[_currentComp->quantTableSelector][i];
-		val *= quant;
+	// Apply 1D IDCT to rows. A row with only a DC coefficient, as most of
+	// them are, transforms to that coefficient on all its values.
+	for (int i = 0; i < 8; i++) {
+		const int32 *row = &block[i * 8];
+		if (row[1] | row[2] | row[3] | row[4] | row[5] | row[6] | row[7]) {
+			idct1D8x8(&block[i * 8], &tmp[i], 9, 1 << 8);
+		} else {
+			for (int j = 0; j < 8; j++)
+				tmp[j * 8 + i] = row[0];
+		}
+	}
 
-		// Store the normalized coefficients, undoing the Zig-Zag
-		block[_zigZagOrder[i]] = val;
+	// Apply 1D IDCT to columns
+	for (int i = 0; i < 8; i++) {
+		const int32 *column = &tmp[i * 8];
+		if (column[1] | column[2] | column[3] | column[4] | column[5] | column[6] | column[7]) {
+			idct1D8x8(&tmp[i * 8], &block[i], 12, 1 << 11);
+		} else {
+			const int32 value = (column[0] * 512 + (1 << 11)) >> 12;
+			for (int j = 0; j < 8; j++)
+				block[j * 8 + i] = value;
+		}
 	}
+}
 
-	// Apply the IDCT
-	idct2D8x8(block);
+#endif
+
+bool JPEGDecoder::readDataUnit(uint16 x, uint16 y) {
+	const uint16 *quant = _quant[_currentComp->quantTableSelector];
 
-	// Level shift to make the values unsigned
-	for (int i = 0; i < 64; i++) {
-		block[i] = block[i] + 128;
+	// Read the DC and AC components, dequantizing them and undoing the
+	// Zig-Zag order on the way
+	int32 block[64];
+	memset(block, 0, sizeof(block));
 
-		if (block[i] < 0)
-			block[i] = 0;
+	_currentComp->DCpredictor += readDC();
+	block[0] = _currentComp->DCpredictor * (int16)quant[0];
 
-		if (block[i] > 255)
-			block[i] = 255;
-	}
+	readAC(block, quant);
+
+	// Apply the IDCT
+	idct2D8x8(block);
 
 	// Paint the component surface
 	uint8 scalingV = _maxFactorV / _currentComp->factorV;
@@ -634,14 +856,23 @@ bool JPEGDecoder::readDataUnit(uint16 x, uint16 y) {
 	y <<= 3;
 
 	for (uint8 j = 0; j < 8; j++) {
+		// Level shift to make the values unsigned
+		byte line[8];
+		for (uint8 i = 0; i < 8; i++)
+			line[i] = CLIP<int32>(block[j * 8 + i] + 128, 0, 255);
+
 		for (uint16 sV = 0; sV < scalingV; sV++) {
 			// Get the beginning of the block line
-			byte *ptr = (byte *)_currentComp->surface.getBasePtr(x * scalingH, (y + j) * scalingV + sV);
+			byte *ptr = (byte *)_currentComp->surface.getBasePtr(x * scalingH, (y + j) * scalingV + sV - _stripY);
 
-			for (uint8 i = 0; i < 8; i++) {
-				for (uint16 sH = 0; sH < scalingH; sH++) {
-					*ptr = (byte)(block[j * 8 + i]);
-					ptr++;
+			if (scalingH == 1) {
+				memcpy(ptr, line, 8);
+			} else {
+				for (uint8 i = 0; i < 8; i++) {
+					for (uint16 sH = 0; sH < scalingH; sH++) {
+						*ptr = line[i];
+						ptr++;
+					}
 				}
 			}
 		}
@@ -661,7 +892,7 @@ int16 JPEGDecoder::readDC() {
 	return readSignedBits(numBits);
 }
 
-void JPEGDecoder::readAC(int16 *out) {
+void JPEGDecoder::readAC(int32 *block, const uint16 *quant) {
 	// AC is type 1
 	uint8 tableNum = (_currentComp->ACentropyTableSelector << 1) + 1;
 
@@ -684,89 +915,125 @@ void JPEGDecoder::readAC(int16 *out) {
 			// Skip r values
 			cur += r;
 
-			// Read the next value
-			out[cur] = readSignedBits(s);
+			// Don't write past the block with broken data
+			if (cur >= 64)
+				break;
+
+			// Read the next value and store it dequantized
+			block[_zigZagOrder[cur]] = readSignedBits(s) * (int16)quant[cur];
 			cur++;
 		}
 	}
 }
 
 int16 JPEGDecoder::readSignedBits(uint8 numBits) {
-	uint16 ret = 0;
+	if (numBits == 0)
+		return 0;
+
 	if (numBits > 16)
 		error("requested %d bits", numBits); //XXX
 
+	if (_bitsNumber < numBits)
+		fillBits();
+
 	// MSB=0 for negatives, 1 for positives
-	for (int i = 0; i < numBits; i++)
-		ret = (ret << 1) + readBit();
+	uint32 ret = _bitsData >> (32 - numBits);
+	_bitsData <<= numBits;
+	_bitsNumber -= numBits;
 
 	// Extend sign bits (PAG109)
-	if (!(ret >> (numBits - 1))) {
-		uint16 tmp = ((uint16)-1 << numBits) + 1;
-		ret = ret + tmp;
-	}
-	return ret;
+	if (!(ret >> (numBits - 1)))
+		ret += ((uint32)-1 << numBits) + 1;
+
+	return (int16)ret;
 }
 
-// TODO: optimize?
 uint8 JPEGDecoder::readHuff(uint8 table) {
-	bool foundCode = false;
-	uint8 val = 0;
-
-	uint8 cur = 0;
-	uint8 codeSize = 1;
-	uint16 code = readBit();
-	while (!foundCode) {
-		// Prepare a code of the current size
-		while (codeSize < _huff[table].sizes[cur]) {
-			code = (code << 1) + readBit();
-			codeSize++;
-		}
+	const HuffmanTable &huff = _huff[table];
 
-		// Compare the codes of the current size
-		while (!foundCode && (codeSize == _huff[table].sizes[cur])) {
-			if (code == _huff[table].codes[cur]) {
-				// Found the code
-				val = _huff[table].values[cur];
-				foundCode = true;
-			} else {
-				// Continue reading
-				cur++;
-			}
+	if (_bitsNumber < 16)
+		fillBits();
+
+	// Look short codes up by the next bits
+	uint16 entry = huff.lookup[_bitsData >> (32 - kHuffLookupBits)];
+	if (entry) {
+		_bitsData <<= entry >> 8;
+		_bitsNumber -= entry >> 8;
+		return entry & 0xFF;
+	}
+
+	// Longer codes are below or at the longest code of their size
+	for (uint8 size = kHuffLookupBits + 1; size <= 16; size++) {
+		int32 code = _bitsData >> (32 - size);
+		if (code <= huff.maxCode[size]) {
+			_bitsData <<= size;
+			_bitsNumber -= size;
+			return huff.values[huff.valueOffset[size] + code];
 		}
 	}
 
-	return val;
+	warning("JPEG: Invalid Huffman code");
+	return 0;
 }
 
-uint8 JPEGDecoder::readBit() {
-	// Read a whole byte if necessary
-	if (_bitsNumber == 0) {
-		_bitsData = _stream->readByte();
-		_bitsNumber = 8;
-
-		// Detect markers
-		if (_bitsData == 0xFF) {
-			uint8 byte2 = _stream->readByte();
-
-			// A stuffed 0 validates the previous byte
-			if (byte2 != 0) {
-				if (byte2 == 0xDC) {
-					// DNL marker: Define Number of Lines
-					// TODO: terminate scan
-					warning("DNL marker detected: terminate scan");
-				} else if (byte2 >= 0xD0 && byte2 <= 0xD7) {
-					debug(7, "RST%d marker detected", byte2 & 7);
-					_bitsData = _stream->readByte();
-				} else {
-					warning("Error: marker 0x%02X read in entropy data", byte2);
-				}
-			}
+void JPEGDecoder::fillBits() {
+	while (_bitsNumber <= 24) {
+		_bitsData |= (uint32)readEntropyByte() << (24 - _bitsNumber);
+		_bitsNumber += 8;
+	}
+}
+
+uint8 JPEGDecoder::readEntropyByte() {
+	// Past the end of the entropy coded data, zeros are decoded
+	if (_bitsEnd)
+		return 0;
+
+	uint8 data = _stream->readByte();
+
+	// Detect markers
+	while (data == 0xFF && !_stream->eos()) {
+		uint8 byte2 = _stream->readByte();
+
+		// A stuffed 0 validates the previous byte
+		if (byte2 == 0 && !_stream->eos())
+			return data;
+
+		if (byte2 >= 0xD0 && byte2 <= 0xD7) {
+			debug(7, "RST%d marker detected", byte2 & 7);
+			data = _stream->readByte();
+			continue;
 		}
+
+		if (byte2 == 0xDC) {
+			// DNL marker: Define Number of Lines
+			// TODO: terminate scan
+			warning("DNL marker detected: terminate scan");
+		}
+
+		// Any other marker ends the entropy coded data. The data is read
+		// ahead of the decoding, so leave the marker for loadStream().
+		if (!_stream->eos())
+			_stream->seek(-2, SEEK_CUR);
+		_bitsEnd = true;
+		return 0;
+	}
+
+	if (_stream->eos()) {
+		// Leave the end of the stream to loadStream(), to insert a fake EOI
+		_stream->seek(0, SEEK_END);
+		_bitsEnd = true;
+		return 0;
 	}
-	_bitsNumber--;
 
-	return (_bitsData & (1 << _bitsNumber)) ? 1 : 0;
+	return data;
+}
+
+void JPEGDecoder::alignBits() {
+	// The data before a restart marker is padded to a whole byte, so skip
+	// what is left of the current byte. Every byte read adds 8 bits.
+	uint8 skip = _bitsNumber & 7;
+	_bitsData <<= skip;
+	_bitsNumber -= skip;
 }
 
 const Surface *JPEGDecoder::getComponent(uint c) const {
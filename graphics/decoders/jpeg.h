@@ -31,6 +31,7 @@
 #ifndef GRAPHICS_JPEG_H
 #define GRAPHICS_JPEG_H
 
+#include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 #include "graphics/decoders/image_decoder.h"
 
@@ -40,8 +41,6 @@ class SeekableReadStream;
 
 namespace Graphics {
 
-struct PixelFormat;
-
 #define JPEG_MAX_QUANT_TABLES 4
 #define JPEG_MAX_HUFF_TABLES 2
 
@@ -58,8 +57,25 @@ public:
 	bool isLoaded() const { return _numComp && _w && _h; }
 	uint16 getWidth() const { return _w; }
 	uint16 getHeight() const { return _h; }
+
+	/**
+	 * Return the plane of the component with the given id.
+	 *
+	 * The planes of YCbCr images are only kept when no output pixel
+	 * format has been set.
+	 */
 	const Surface *getComponent(uint c) const;
 
+	/**
+	 * Convert YCbCr images to this pixel format while decoding.
+	 *
+	 * The image lines are then converted as soon as they are decoded,
+	 * instead of decoding full size component planes first and converting
+	 * them in getSurface(). The format needs 2 or 4 bytes per pixel, and
+	 * the setting is kept for the following loadStream() calls.
+	 */
+	void setOutputPixelFormat(const PixelFormat &format);
+
 private:
 	Common::SeekableReadStream *_stream;
 	uint16 _w, _h;
@@ -70,6 +86,13 @@ private:
 	// const requirement in other ImageDecoders
 	mutable Graphics::Surface *_rgbSurface;
 
+	// The format to decode to, if bytesPerPixel isn't 0
+	PixelFormat _outputFormat;
+
+	// First image line held by the component surfaces, when they only
+	// hold one row of MCUs to be converted to _outputFormat
+	uint16 _stripY;
+
 	// Image components
 	uint8 _numComp;
 	struct Component {
@@ -103,11 +126,23 @@ private:
 	uint16 *_quant[JPEG_MAX_QUANT_TABLES];
 
 	// Huffman tables
+	enum {
+		kHuffLookupBits = 9
+	};
+
 	struct HuffmanTable {
 		uint8 count;
 		uint8 *values;
 		uint8 *sizes;
 		uint16 *codes;
+
+		// Size << 8 | value of the codes up to kHuffLookupBits long, by
+		// their first bits, or 0
+		uint16 lookup[1 << kHuffLookupBits];
+
+		// Longest code and value index offset of each code size
+		int32 maxCode[17];
+		int32 valueOffset[17];
 	} _huff[2 * JPEG_MAX_HUFF_TABLES];
 
 	// Marker read functions
@@ -122,14 +157,19 @@ private:
 	bool readMCU(uint16 xMCU, uint16 yMCU);
 	bool readDataUnit(uint16 x, uint16 y);
 	int16 readDC();
-	void readAC(int16 *out);
+	void readAC(int32 *block, const uint16 *quant);
 	int16 readSignedBits(uint8 numBits);
+	void outputStrip(uint16 y, uint16 h);
 
 	// Huffman decoding
+	void buildHuffLookup(HuffmanTable &table);
 	uint8 readHuff(uint8 table);
-	uint8 readBit();
-	uint8 _bitsData;
-	uint8 _bitsNumber;
+	void fillBits();
+	uint8 readEntropyByte();
+	void alignBits();
+	uint32 _bitsData;   // The next bits, starting with the highest one
+	uint8 _bitsNumber;  // Number of valid bits in _bitsData
+	bool _bitsEnd;      // Has the end of the entropy coded data been reached?
 
 	// Inverse Discrete Cosine Transformation
 	static void idct1D8x8(int32 src[8], int32 dest[64], int32 ps, int32 half);
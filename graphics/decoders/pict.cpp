@@ -560,7 +560,9 @@ void PICTDecoder::decodeCompressedQuickTime(Common::SeekableReadStream &stream)
 
 	Common::SeekableSubReadStream jpegStream(&stream, stream.pos(), stream.pos() + jpegSize);
 
+	// Decode straight to RGBA8888, the format JPEGDecoder uses by default
 	JPEGDecoder jpeg;
+	jpeg.setOutputPixelFormat(PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
 	if (!jpeg.loadStream(jpegStream))
 		error("PICTDecoder::decodeCompressedQuickTime(): Could not decode JPEG data");
 
@@ -121,7 +121,12 @@ void InitLUT(Graphics::PixelFormat format) {
 
 
 /** Lookup table for the DotMatrix scaler. */
-uint16 g_dotmatrix[16] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+uint32 g_dotmatrix[16] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+
+/** Size of the pixels the scalers have been initialized for. */
+static inline int getScalerBytesPerPixel() {
+	return (gBitFormat == 8888) ? 4 : 2;
+}
 
 /** Init the scaler subsystem. */
 void InitScalers(uint32 BitFormat) {
@@ -135,21 +140,26 @@ void InitScalers(uint32 BitFormat) {
 		format = Graphics::createPixelFormat<555>();
 	} else if (gBitFormat == 565) {
 		format = Graphics::createPixelFormat<565>();
+	} else if (gBitFormat == 8888) {
+		format = Graphics::createPixelFormat<8888>();
 	} else {
 		assert(g_system);
 		format = g_system->getOverlayFormat();
 	}
 
 #ifdef USE_HQ_SCALERS
-	InitLUT(format);
+	// The hq scalers compute the YUV values of 32 bit pixels on the fly
+	if (format.bytesPerPixel == 2)
+		InitLUT(format);
 #endif
 
-	// Build dotmatrix lookup table for the DotMatrix scaler.
-	g_dotmatrix[0] = g_dotmatrix[10] = format.RGBToColor(0, 63, 0);
-	g_dotmatrix[1] = g_dotmatrix[11] = format.RGBToColor(0, 0, 63);
-	g_dotmatrix[2] = g_dotmatrix[8] = format.RGBToColor(63, 0, 0);
+	// Build dotmatrix lookup table for the DotMatrix scaler. The alpha
+	// channel of 32 bit pixels must not be darkened.
+	g_dotmatrix[0] = g_dotmatrix[10] = format.ARGBToColor(0, 0, 63, 0);
+	g_dotmatrix[1] = g_dotmatrix[11] = format.ARGBToColor(0, 0, 0, 63);
+	g_dotmatrix[2] = g_dotmatrix[8] = format.ARGBToColor(0, 63, 0, 0);
 	g_dotmatrix[4] = g_dotmatrix[6] =
-		g_dotmatrix[12] = g_dotmatrix[14] = format.RGBToColor(63, 63, 63);
+		g_dotmatrix[12] = g_dotmatrix[14] = format.ARGBToColor(0, 63, 63, 63);
 }
 
 void DestroyScalers(){
@@ -166,13 +176,15 @@ void DestroyScalers(){
  */
 void Normal1x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch,
 							int width, int height) {
+	const uint32 lineSize = getScalerBytesPerPixel() * width;
+
 	// Spot the case when it can all be done in 1 hit
-	if ((srcPitch == sizeof(uint16) * (uint)width) && (dstPitch == sizeof(uint16) * (uint)width)) {
-		memcpy(dstPtr, srcPtr, sizeof(uint16) * width * height);
+	if ((srcPitch == lineSize) && (dstPitch == lineSize)) {
+		memcpy(dstPtr, srcPtr, lineSize * height);
 		return;
 	}
 	while (height--) {
-		memcpy(dstPtr, srcPtr, sizeof(uint16) * width);
+		memcpy(dstPtr, srcPtr, lineSize);
 		srcPtr += srcPitch;
 		dstPtr += dstPitch;
 	}
@@ -180,6 +192,27 @@ void Normal1x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPit
 
 #ifdef USE_SCALERS
 
+/**
+ * Trivial nearest-neighbor scaler for 32 bit pixels.
+ */
+template<int scale>
+static void Normal32Template(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch,
+							int width, int height) {
+	while (height--) {
+		const uint32 *s = (const uint32 *)srcPtr;
+		uint32 *d = (uint32 *)dstPtr;
+		for (int i = 0; i < width; ++i) {
+			const uint32 color = s[i];
+			for (int j = 0; j < scale; ++j)
+				*d++ = color;
+		}
+		for (int j = 1; j < scale; ++j)
+			memcpy(dstPtr + j * dstPitch, dstPtr, width * scale * sizeof(uint32));
+
+		srcPtr += srcPitch;
+		dstPtr += dstPitch * scale;
+	}
+}
 
 #ifdef USE_ARM_SCALER_ASM
 extern "C" void Normal2xARM(const uint8  *srcPtr,
@@ -195,7 +228,10 @@ void Normal2x(const uint8  *srcPtr,
                     uint32  dstPitch,
                     int     width,
                     int     height) {
-	Normal2xARM(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+	if (gBitFormat == 8888)
+		Normal32Template<2>(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+	else
+		Normal2xARM(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 }
 
 #else
@@ -204,6 +240,11 @@ void Normal2x(const uint8  *srcPtr,
  */
 void Normal2x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch,
 							int width, int height) {
+	if (gBitFormat == 8888) {
+		Normal32Template<2>(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+		return;
+	}
+
 	uint8 *r;
 
 	assert(IS_ALIGNED(dstPtr, 4));
@@ -228,6 +269,11 @@ void Normal2x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPit
  */
 void Normal3x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch,
 							int width, int height) {
+	if (gBitFormat == 8888) {
+		Normal32Template<3>(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+		return;
+	}
+
 	uint8 *r;
 	const uint32 dstPitch2 = dstPitch * 2;
 	const uint32 dstPitch3 = dstPitch * 3;
@@ -262,29 +308,32 @@ void Normal3x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPit
 template<typename ColorMask>
 void Normal1o5xTemplate(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch,
 							int width, int height) {
-	uint8 *r;
+	typedef typename ColorMask::PixelType Pixel;
 	const uint32 dstPitch2 = dstPitch * 2;
 	const uint32 dstPitch3 = dstPitch * 3;
 	const uint32 srcPitch2 = srcPitch * 2;
 
-	assert(IS_ALIGNED(dstPtr, 2));
+	assert(IS_ALIGNED(dstPtr, sizeof(Pixel)));
 	while (height > 0) {
-		r = dstPtr;
-		for (int i = 0; i < width; i += 2, r += 6) {
-			uint16 color0 = *(((const uint16 *)srcPtr) + i);
-			uint16 color1 = *(((const uint16 *)srcPtr) + i + 1);
-			uint16 color2 = *(((const uint16 *)(srcPtr + srcPitch)) + i);
-			uint16 color3 = *(((const uint16 *)(srcPtr + srcPitch)) + i + 1);
-
-			*(uint16 *)(r + 0) = color0;
-			*(uint16 *)(r + 2) = interpolate_1_1(color0, color1);
-			*(uint16 *)(r + 4) = color1;
-			*(uint16 *)(r + 0 + dstPitch) = interpolate_1_1(color0, color2);
-			*(uint16 *)(r + 2 + dstPitch) = interpolate_1_1_1_1(color0, color1, color2, color3);
-			*(uint16 *)(r + 4 + dstPitch) = interpolate_1_1(color1, color3);
-			*(uint16 *)(r + 0 + dstPitch2) = color2;
-			*(uint16 *)(r + 2 + dstPitch2) = interpolate_1_1(color2, color3);
-			*(uint16 *)(r + 4 + dstPitch2) = color3;
+		Pixel *r = (Pixel *)dstPtr;
+		for (int i = 0; i < width; i += 2, r += 3) {
+			Pixel color0 = *(((const Pixel *)srcPtr) + i);
+			Pixel color1 = *(((const Pixel *)srcPtr) + i + 1);
+			Pixel color2 = *(((const Pixel *)(srcPtr + srcPitch)) + i);
+			Pixel color3 = *(((const Pixel *)(srcPtr + srcPitch)) + i + 1);
+
+			Pixel *r1 = (Pixel *)((uint8 *)r + dstPitch);
+			Pixel *r2 = (Pixel *)((uint8 *)r + dstPitch2);
+
+			r[0] = color0;
+			r[1] = interpolate_1_1(color0, color1);
+			r[2] = color1;
+			r1[0] = interpolate_1_1(color0, color2);
+			r1[1] = interpolate_1_1_1_1(color0, color1, color2, color3);
+			r1[2] = interpolate_1_1(color1, color3);
+			r2[0] = color2;
+			r2[1] = interpolate_1_1(color2, color3);
+			r2[2] = color3;
 		}
 		srcPtr += srcPitch2;
 		dstPtr += dstPitch3;
@@ -295,6 +344,8 @@ void Normal1o5xTemplate(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uin
 void Normal1o5x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	if (gBitFormat == 565)
 		Normal1o5xTemplate<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+	else if (gBitFormat == 8888)
+		Normal1o5xTemplate<Graphics::ColorMasks<8888> >(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 	else
 		Normal1o5xTemplate<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 }
@@ -305,7 +356,7 @@ void Normal1o5x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstP
  */
 void AdvMame2x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch,
 							 int width, int height) {
-	scale(2, dstPtr, dstPitch, srcPtr - srcPitch, srcPitch, 2, width, height);
+	scale(2, dstPtr, dstPitch, srcPtr - srcPitch, srcPitch, getScalerBytesPerPixel(), width, height);
 }
 
 /**
@@ -314,30 +365,32 @@ void AdvMame2x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPi
  */
 void AdvMame3x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch,
 							 int width, int height) {
-	scale(3, dstPtr, dstPitch, srcPtr - srcPitch, srcPitch, 2, width, height);
+	scale(3, dstPtr, dstPitch, srcPtr - srcPitch, srcPitch, getScalerBytesPerPixel(), width, height);
 }
 
 template<typename ColorMask>
 void TV2xTemplate(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch,
 					int width, int height) {
-	const uint32 nextlineSrc = srcPitch / sizeof(uint16);
-	const uint16 *p = (const uint16 *)srcPtr;
+	typedef typename ColorMask::PixelType Pixel;
+	const uint32 nextlineSrc = srcPitch / sizeof(Pixel);
+	const Pixel *p = (const Pixel *)srcPtr;
 
-	const uint32 nextlineDst = dstPitch / sizeof(uint16);
-	uint16 *q = (uint16 *)dstPtr;
+	const uint32 nextlineDst = dstPitch / sizeof(Pixel);
+	Pixel *q = (Pixel *)dstPtr;
 
 	while (height--) {
 		for (int i = 0, j = 0; i < width; ++i, j += 2) {
-			uint16 p1 = *(p + i);
+			Pixel p1 = *(p + i);
 			uint32 pi;
 
 			pi = (((p1 & ColorMask::kRedBlueMask) * 7) >> 3) & ColorMask::kRedBlueMask;
 			pi |= (((p1 & ColorMask::kGreenMask) * 7) >> 3) & ColorMask::kGreenMask;
+			pi |= p1 & ColorMask::kAlphaMask;
 
 			*(q + j) = p1;
 			*(q + j + 1) = p1;
-			*(q + j + nextlineDst) = (uint16)pi;
-			*(q + j + nextlineDst + 1) = (uint16)pi;
+			*(q + j + nextlineDst) = (Pixel)pi;
+			*(q + j + nextlineDst + 1) = (Pixel)pi;
 		}
 		p += nextlineSrc;
 		q += nextlineDst << 1;
@@ -347,11 +400,14 @@ void TV2xTemplate(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 ds
 void TV2x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	if (gBitFormat == 565)
 		TV2xTemplate<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+	else if (gBitFormat == 8888)
+		TV2xTemplate<Graphics::ColorMasks<8888> >(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 	else
 		TV2xTemplate<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 }
 
-static inline uint16 DOT_16(const uint16 *dotmatrix, uint16 c, int j, int i) {
+template<typename Pixel>
+static inline Pixel DOT_16(const uint32 *dotmatrix, Pixel c, int j, int i) {
 	return c - ((c >> 2) & dotmatrix[((j & 3) << 2) + (i & 3)]);
 }
 
@@ -362,20 +418,21 @@ static inline uint16 DOT_16(const uint16 *dotmatrix, uint16 c, int j, int i) {
 // a way that also works together with aspect-ratio correction is left as an
 // exercise for the reader.)
 
-void DotMatrix(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch,
+template<typename Pixel>
+static void DotMatrixTemplate(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch,
 					int width, int height) {
 
-	const uint16 *dotmatrix = g_dotmatrix;
+	const uint32 *dotmatrix = g_dotmatrix;
 
-	const uint32 nextlineSrc = srcPitch / sizeof(uint16);
-	const uint16 *p = (const uint16 *)srcPtr;
+	const uint32 nextlineSrc = srcPitch / sizeof(Pixel);
+	const Pixel *p = (const Pixel *)srcPtr;
 
-	const uint32 nextlineDst = dstPitch / sizeof(uint16);
-	uint16 *q = (uint16 *)dstPtr;
+	const uint32 nextlineDst = dstPitch / sizeof(Pixel);
+	Pixel *q = (Pixel *)dstPtr;
 
 	for (int j = 0, jj = 0; j < height; ++j, jj += 2) {
 		for (int i = 0, ii = 0; i < width; ++i, ii += 2) {
-			uint16 c = *(p + i);
+			Pixel c = *(p + i);
 			*(q + ii) = DOT_16(dotmatrix, c, jj, ii);
 			*(q + ii + 1) = DOT_16(dotmatrix, c, jj, ii + 1);
 			*(q + ii + nextlineDst) = DOT_16(dotmatrix, c, jj + 1, ii);
@@ -386,4 +443,12 @@ void DotMatrix(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPi
 	}
 }
 
+void DotMatrix(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch,
+					int width, int height) {
+	if (gBitFormat == 8888)
+		DotMatrixTemplate<uint32>(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+	else
+		DotMatrixTemplate<uint16>(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+}
+
 #endif // #ifdef USE_SCALERS
@@ -25,6 +25,11 @@
 #include "common/scummsys.h"
 #include "graphics/surface.h"
 
+/**
+ * Init the scaler subsystem for the given pixel format, which can be 555 or
+ * 565 for 16 bit pixels and 8888 for 32 bit pixels. All scalers use the
+ * pixel size of the last format passed in.
+ */
 extern void InitScalers(uint32 BitFormat);
 extern void DestroyScalers();
 
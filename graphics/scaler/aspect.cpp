@@ -96,27 +96,32 @@ static void interpolate5LineNeon(uint16 *dst, const uint16 *srcA, const uint16 *
 #endif // USE_ARM_NEON_ASPECT_CORRECTOR
 
 template<typename ColorMask, int scale>
-static void interpolate5Line(uint16 *dst, const uint16 *srcA, const uint16 *srcB, int width) {
+static void interpolate5Line(typename ColorMask::PixelType *dst, const typename ColorMask::PixelType *srcA, const typename ColorMask::PixelType *srcB, int width) {
 	if (scale == 1) {
 #ifdef USE_NEON_ASPECT_CORRECTOR
-		int width4 = width & ~3;
-		interpolate5LineNeon<ColorMask>(dst, srcA, srcB, width4, 7, 1);
-		srcA += width4;
-		srcB += width4;
-		dst += width4;
-		width -= width4;
+		// The NEON code only handles 16 bit pixels
+		if (ColorMask::kBytesPerPixel == 2) {
+			int width4 = width & ~3;
+			interpolate5LineNeon<ColorMask>((uint16 *)dst, (const uint16 *)srcA, (const uint16 *)srcB, width4, 7, 1);
+			srcA += width4;
+			srcB += width4;
+			dst += width4;
+			width -= width4;
+		}
 #endif // USE_ARM_NEON_ASPECT_CORRECTOR
 		while (width--) {
 			*dst++ = interpolate16_7_1<ColorMask>(*srcB++, *srcA++);
 		}
 	} else {
 #ifdef USE_ARM_NEON_ASPECT_CORRECTOR
-		int width4 = width & ~3;
-		interpolate5LineNeon<ColorMask>(dst, srcA, srcB, width4, 5, 3);
-		srcA += width4;
-		srcB += width4;
-		dst += width4;
-		width -= width4;
+		if (ColorMask::kBytesPerPixel == 2) {
+			int width4 = width & ~3;
+			interpolate5LineNeon<ColorMask>((uint16 *)dst, (const uint16 *)srcA, (const uint16 *)srcB, width4, 5, 3);
+			srcA += width4;
+			srcB += width4;
+			dst += width4;
+			width -= width4;
+		}
 #endif // USE_ARM_NEON_ASPECT_CORRECTOR
 		while (width--) {
 			*dst++ = interpolate16_5_3<ColorMask>(*srcB++, *srcA++);
@@ -188,7 +193,7 @@ void makeRectStretchable(int &x, int &y, int &w, int &h) {
 }
 
 /**
- * Stretch a 16bpp image vertically by factor 1.2. Used to correct the
+ * Stretch a 16bpp or 32bpp image vertically by factor 1.2. Used to correct the
  * aspect-ratio in games using 320x200 pixel graphics with non-qudratic
  * pixels. Applying this method effectively turns that into 320x240, which
  * provides the correct aspect-ratio on modern displays.
@@ -205,10 +210,11 @@ void makeRectStretchable(int &x, int &y, int &w, int &h) {
  */
 template<typename ColorMask>
 int stretch200To240(uint8 *buf, uint32 pitch, int width, int height, int srcX, int srcY, int origSrcY) {
+	typedef typename ColorMask::PixelType Pixel;
 	int maxDstY = real2Aspect(origSrcY + height - 1);
 	int y;
-	const uint8 *startSrcPtr = buf + srcX * 2 + (srcY - origSrcY) * pitch;
-	uint8 *dstPtr = buf + srcX * 2 + maxDstY * pitch;
+	const uint8 *startSrcPtr = buf + srcX * sizeof(Pixel) + (srcY - origSrcY) * pitch;
+	uint8 *dstPtr = buf + srcX * sizeof(Pixel) + maxDstY * pitch;
 
 	for (y = maxDstY; y >= srcY; y--) {
 		const uint8 *srcPtr = startSrcPtr + aspect2Real(y) * pitch;
@@ -216,26 +222,26 @@ int stretch200To240(uint8 *buf, uint32 pitch, int width, int height, int srcX, i
 #if ASPECT_MODE == kSuperFastAndUglyAspectMode
 		if (srcPtr == dstPtr)
 			break;
-		memcpy(dstPtr, srcPtr, sizeof(uint16) * width);
+		memcpy(dstPtr, srcPtr, sizeof(Pixel) * width);
 #else
 		// Bilinear filter
 		switch (y % 6) {
 		case 0:
 		case 5:
 			if (srcPtr != dstPtr)
-				memcpy(dstPtr, srcPtr, sizeof(uint16) * width);
+				memcpy(dstPtr, srcPtr, sizeof(Pixel) * width);
 			break;
 		case 1:
-			interpolate5Line<ColorMask, 1>((uint16 *)dstPtr, (const uint16 *)(srcPtr - pitch), (const uint16 *)srcPtr, width);
+			interpolate5Line<ColorMask, 1>((Pixel *)dstPtr, (const Pixel *)(srcPtr - pitch), (const Pixel *)srcPtr, width);
 			break;
 		case 2:
-			interpolate5Line<ColorMask, 2>((uint16 *)dstPtr, (const uint16 *)(srcPtr - pitch), (const uint16 *)srcPtr, width);
+			interpolate5Line<ColorMask, 2>((Pixel *)dstPtr, (const Pixel *)(srcPtr - pitch), (const Pixel *)srcPtr, width);
 			break;
 		case 3:
-			interpolate5Line<ColorMask, 2>((uint16 *)dstPtr, (const uint16 *)srcPtr, (const uint16 *)(srcPtr - pitch), width);
+			interpolate5Line<ColorMask, 2>((Pixel *)dstPtr, (const Pixel *)srcPtr, (const Pixel *)(srcPtr - pitch), width);
 			break;
 		case 4:
-			interpolate5Line<ColorMask, 1>((uint16 *)dstPtr, (const uint16 *)srcPtr, (const uint16 *)(srcPtr - pitch), width);
+			interpolate5Line<ColorMask, 1>((Pixel *)dstPtr, (const Pixel *)srcPtr, (const Pixel *)(srcPtr - pitch), width);
 			break;
 		}
 #endif
@@ -249,6 +255,8 @@ int stretch200To240(uint8 *buf, uint32 pitch, int width, int height, int srcX, i
 	extern int gBitFormat;
 	if (gBitFormat == 565)
 		return stretch200To240<Graphics::ColorMasks<565> >(buf, pitch, width, height, srcX, srcY, origSrcY);
+	else if (gBitFormat == 8888)
+		return stretch200To240<Graphics::ColorMasks<8888> >(buf, pitch, width, height, srcX, srcY, origSrcY);
 	else // gBitFormat == 555
 		return stretch200To240<Graphics::ColorMasks<555> >(buf, pitch, width, height, srcX, srcY, origSrcY);
 }
@@ -256,40 +264,41 @@ int stretch200To240(uint8 *buf, uint32 pitch, int width, int height, int srcX, i
 
 template<typename ColorMask>
 void Normal1xAspectTemplate(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+	typedef typename ColorMask::PixelType Pixel;
 
 	for (int y = 0; y < (height * 6 / 5); ++y) {
 
 #if ASPECT_MODE == kSuperFastAndUglyAspectMode
 		if ((y % 6) == 5)
 			srcPtr -= srcPitch;
-		memcpy(dstPtr, srcPtr, sizeof(uint16) * width);
+		memcpy(dstPtr, srcPtr, sizeof(Pixel) * width);
 #else
 		// Bilinear filter five input lines onto six output lines
 		switch (y % 6) {
 		case 0:
 			// First output line is copied from first input line
-			memcpy(dstPtr, srcPtr, sizeof(uint16) * width);
+			memcpy(dstPtr, srcPtr, sizeof(Pixel) * width);
 			break;
 		case 1:
 			// Second output line is mixed from first and second input line
-			interpolate5Line<ColorMask, 1>((uint16 *)dstPtr, (const uint16 *)(srcPtr - srcPitch), (const uint16 *)srcPtr, width);
+			interpolate5Line<ColorMask, 1>((Pixel *)dstPtr, (const Pixel *)(srcPtr - srcPitch), (const Pixel *)srcPtr, width);
 			break;
 		case 2:
 			// Third output line is mixed from second and third input line
-			interpolate5Line<ColorMask, 2>((uint16 *)dstPtr, (const uint16 *)(srcPtr - srcPitch), (const uint16 *)srcPtr, width);
+			interpolate5Line<ColorMask, 2>((Pixel *)dstPtr, (const Pixel *)(srcPtr - srcPitch), (const Pixel *)srcPtr, width);
 			break;
 		case 3:
 			// Fourth output line is mixed from third and fourth input line
-			interpolate5Line<ColorMask, 2>((uint16 *)dstPtr, (const uint16 *)srcPtr, (const uint16 *)(srcPtr - srcPitch), width);
+			interpolate5Line<ColorMask, 2>((Pixel *)dstPtr, (const Pixel *)srcPtr, (const Pixel *)(srcPtr - srcPitch), width);
 			break;
 		case 4:
 			// Fifth output line is mixed from fourth and fifth input line
-			interpolate5Line<ColorMask, 1>((uint16 *)dstPtr, (const uint16 *)srcPtr, (const uint16 *)(srcPtr - srcPitch), width);
+			interpolate5Line<ColorMask, 1>((Pixel *)dstPtr, (const Pixel *)srcPtr, (const Pixel *)(srcPtr - srcPitch), width);
 			break;
 		case 5:
 			// Sixth (and last) output line is copied from fifth (and last) input line
 			srcPtr -= srcPitch;
-			memcpy(dstPtr, srcPtr, sizeof(uint16) * width);
+			memcpy(dstPtr, srcPtr, sizeof(Pixel) * width);
 			break;
 		}
 #endif
@@ -303,6 +312,8 @@ void Normal1xAspect(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32
 	extern int gBitFormat;
 	if (gBitFormat == 565)
 		Normal1xAspectTemplate<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+	else if (gBitFormat == 8888)
+		Normal1xAspectTemplate<Graphics::ColorMasks<8888> >(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 	else
 		Normal1xAspectTemplate<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 }
@@ -35,11 +35,9 @@ void hq2x_16(const byte *, byte *, uint32, uint32, uint32, uint32);
 
 }
 
-void HQ2x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
-	hq2x_16(srcPtr, dstPtr, width, height, srcPitch, dstPitch);
-}
+#endif
 
-#else
+#include "graphics/scaler/hqx_pattern.h"
 
 #define PIXEL00_0	*(q) = w5;
 #define PIXEL00_10	*(q) = interpolate16_3_1<ColorMask >(w5, w1);
@@ -93,8 +91,7 @@ void HQ2x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch,
 #define PIXEL11_90	*(q+1+nextlineDst) = interpolate16_2_3_3<ColorMask >(w5, w6, w8);
 #define PIXEL11_100	*(q+1+nextlineDst) = interpolate16_14_1_1<ColorMask >(w5, w6, w8);
 
-extern "C" uint32   *RGBtoYUV;
-#define YUV(x)	RGBtoYUV[w ## x]
+#define YUV(x)	hqxRGBToYUV<ColorMask>(w ## x)
 
 /*
  * The HQ2x high quality 2x graphics filter.
@@ -103,13 +100,16 @@ extern "C" uint32   *RGBtoYUV;
  */
 template<typename ColorMask>
 static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
-	register int w1, w2, w3, w4, w5, w6, w7, w8, w9;
+	typedef typename ColorMask::PixelType Pixel;
+	register unsigned w1, w2, w3, w4, w5, w6, w7, w8, w9;
 
-	const uint32 nextlineSrc = srcPitch / sizeof(uint16);
-	const uint16 *p = (const uint16 *)srcPtr;
+	const uint32 nextlineSrc = srcPitch / sizeof(Pixel);
+	const Pixel *p = (const Pixel *)srcPtr;
 
-	const uint32 nextlineDst = dstPitch / sizeof(uint16);
-	uint16 *q = (uint16 *)dstPtr;
+	const uint32 nextlineDst = dstPitch / sizeof(Pixel);
+	Pixel *q = (Pixel *)dstPtr;
+
+	uint8 patterns[kHQxChunkWidth];
 
 	//	 +----+----+----+
 	//	 |    |    |    |
@@ -132,23 +132,21 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 		w8 = *(p + nextlineSrc);
 
 		int tmpWidth = width;
+		int patternPos = kHQxChunkWidth;
 		while (tmpWidth--) {
+			// Classify the next chunk of pixels of this row
+			if (patternPos == kHQxChunkWidth) {
+				hqxComputePatterns<ColorMask>(p, nextlineSrc, MIN<int>(tmpWidth + 1, kHQxChunkWidth), patterns);
+				patternPos = 0;
+			}
+
 			p++;
 
 			w3 = *(p - nextlineSrc);
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
-			int pattern = 0;
-			const int yuv5 = YUV(5);
-			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
-			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
-			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
-			if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
-			if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
-			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
-			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
-			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+			const int pattern = patterns[patternPos++];
 
 			switch (pattern) {
 			case 0:
@@ -1959,10 +1957,17 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 
 void HQ2x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	extern int gBitFormat;
+#ifdef USE_NASM
+	// The assembly version only handles 16 bit pixels
+	if (gBitFormat != 8888) {
+		hq2x_16(srcPtr, dstPtr, width, height, srcPitch, dstPitch);
+		return;
+	}
+#endif
 	if (gBitFormat == 565)
 		HQ2x_implementation<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+	else if (gBitFormat == 8888)
+		HQ2x_implementation<Graphics::ColorMasks<8888> >(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 	else
 		HQ2x_implementation<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 }
-
-#endif // Assembly version
@@ -36,11 +36,9 @@ void hq3x_16(const byte *, byte *, uint32, uint32, uint32, uint32);
 
 }
 
-void HQ3x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
-	hq3x_16(srcPtr, dstPtr, width, height, srcPitch, dstPitch);
-}
+#endif
 
-#else
+#include "graphics/scaler/hqx_pattern.h"
 
 #define PIXEL00_1M  *(q) = interpolate16_3_1<ColorMask >(w5, w1);
 #define PIXEL00_1U  *(q) = interpolate16_3_1<ColorMask >(w5, w2);
@@ -96,8 +94,7 @@ void HQ3x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch,
 #define PIXEL22_5   *(q+2+nextlineDst2) = interpolate16_1_1<ColorMask >(w6, w8);
 #define PIXEL22_C   *(q+2+nextlineDst2) = w5;
 
-extern "C" uint32   *RGBtoYUV;
-#define YUV(x)	RGBtoYUV[w ## x]
+#define YUV(x)	hqxRGBToYUV<ColorMask>(w ## x)
 
 /*
  * The HQ3x high quality 3x graphics filter.
@@ -106,14 +103,17 @@ extern "C" uint32   *RGBtoYUV;
  */
 template<typename ColorMask>
 static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
-	register int  w1, w2, w3, w4, w5, w6, w7, w8, w9;
+	typedef typename ColorMask::PixelType Pixel;
+	register unsigned w1, w2, w3, w4, w5, w6, w7, w8, w9;
 
-	const uint32 nextlineSrc = srcPitch / sizeof(uint16);
-	const uint16 *p = (const uint16 *)srcPtr;
+	const uint32 nextlineSrc = srcPitch / sizeof(Pixel);
+	const Pixel *p = (const Pixel *)srcPtr;
 
-	const uint32 nextlineDst = dstPitch / sizeof(uint16);
+	const uint32 nextlineDst = dstPitch / sizeof(Pixel);
 	const uint32 nextlineDst2 = 2 * nextlineDst;
-	uint16 *q = (uint16 *)dstPtr;
+	Pixel *q = (Pixel *)dstPtr;
+
+	uint8 patterns[kHQxChunkWidth];
 
 	//	 +----+----+----+
 	//	 |    |    |    |
@@ -136,23 +136,21 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 		w8 = *(p + nextlineSrc);
 
 		int tmpWidth = width;
+		int patternPos = kHQxChunkWidth;
 		while (tmpWidth--) {
+			// Classify the next chunk of pixels of this row
+			if (patternPos == kHQxChunkWidth) {
+				hqxComputePatterns<ColorMask>(p, nextlineSrc, MIN<int>(tmpWidth + 1, kHQxChunkWidth), patterns);
+				patternPos = 0;
+			}
+
 			p++;
 
 			w3 = *(p - nextlineSrc);
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
-			int pattern = 0;
-			const int yuv5 = YUV(5);
-			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
-			if (w5 != w2 && diffYUV(yuv5, YUV(2))) pattern |= 0x0002;
-			if (w5 != w3 && diffYUV(yuv5, YUV(3))) pattern |= 0x0004;
-			if (w5 != w4 && diffYUV(yuv5, YUV(4))) pattern |= 0x0008;
-			if (w5 != w6 && diffYUV(yuv5, YUV(6))) pattern |= 0x0010;
-			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
-			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
-			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+			const int pattern = patterns[patternPos++];
 
 			switch (pattern) {
 			case 0:
@@ -2936,10 +2934,17 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 
 void HQ3x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
 	extern int gBitFormat;
+#ifdef USE_NASM
+	// The assembly version only handles 16 bit pixels
+	if (gBitFormat != 8888) {
+		hq3x_16(srcPtr, dstPtr, width, height, srcPitch, dstPitch);
+		return;
+	}
+#endif
 	if (gBitFormat == 565)
 		HQ3x_implementation<Graphics::ColorMasks<565> >(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+	else if (gBitFormat == 8888)
+		HQ3x_implementation<Graphics::ColorMasks<8888> >(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 	else
 		HQ3x_implementation<Graphics::ColorMasks<555> >(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 }
-
-#endif // Assembly version
@@ -0,0 +1,223 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_SCALER_HQX_PATTERN_H
+#define GRAPHICS_SCALER_HQX_PATTERN_H
+
+#include "common/util.h"
+#include "graphics/colormasks.h"
+#include "graphics/scaler/intern.h"
+
+// Pixel classification shared by the C versions of the hq scalers. For every
+// pixel it computes the 8 bit pattern telling which of the 8 neighbours differ
+// from it according to diffYUV():
+//
+//	 +------+------+------+
+//	 | 0x01 | 0x02 | 0x04 |
+//	 +------+------+------+
+//	 | 0x08 |      | 0x10 |
+//	 +------+------+------+
+//	 | 0x20 | 0x40 | 0x80 |
+//	 +------+------+------+
+//
+// The YUV values of the three rows involved are looked up once per pixel and
+// split into Y, U and V planes, which allows comparing 16 pixels at once with
+// SSE2 or NEON. The results are bit-exact with diffYUV().
+
+#if defined(__SSE2__)
+#define HQX_PATTERN_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define HQX_PATTERN_NEON
+#include <arm_neon.h>
+#endif
+
+// See scaler.cpp
+#if defined(USE_NASM) && !defined(_WIN32) && !defined(MACOSX) && !defined(__OS2__)
+#define RGBtoYUV _RGBtoYUV
+#endif
+
+extern "C" uint32 *RGBtoYUV;
+
+enum {
+	/** Maximal number of pixels classified by one hqxComputePatterns() call */
+	kHQxChunkWidth = 256,
+
+	// Thresholds used by diffYUV(), per 8 bit component
+	kHQxThresholdY = 0x30,
+	kHQxThresholdU = 0x07,
+	kHQxThresholdV = 0x06
+};
+
+/**
+ * Look up the YUV value (encoded 8-8-8) of a pixel, see InitLUT(). 32 bit
+ * pixels are converted on the fly instead, since a table would be far too
+ * large.
+ */
+template<typename ColorMask>
+static inline uint32 hqxRGBToYUV(uint32 color) {
+	return RGBtoYUV[color];
+}
+
+template<>
+inline uint32 hqxRGBToYUV<Graphics::ColorMasks<8888> >(uint32 color) {
+	typedef Graphics::ColorMasks<8888> ColorMask;
+	const int r = (color & ColorMask::kRedMask) >> ColorMask::kRedShift;
+	const int g = (color & ColorMask::kGreenMask) >> ColorMask::kGreenShift;
+	const int b = (color & ColorMask::kBlueMask) >> ColorMask::kBlueShift;
+
+	const int Y = (r + g + b) >> 2;
+	const int u = 128 + ((r - b) >> 2);
+	const int v = 128 + ((-r + 2 * g - b) >> 3);
+	return (Y << 16) | (u << 8) | v;
+}
+
+/** Y, U and V planes of three rows, with one extra pixel on either side */
+struct HQxPlanes {
+	uint8 y[3][kHQxChunkWidth + 2];
+	uint8 u[3][kHQxChunkWidth + 2];
+	uint8 v[3][kHQxChunkWidth + 2];
+};
+
+/** Compare the center pixel at index x of row 1 with the pixel at (row, x + dx) */
+static inline bool hqxDiffNeighbour(const HQxPlanes &planes, int row, int x, int dx) {
+	const int dy = planes.y[1][x] - planes.y[row][x + dx];
+	const int du = planes.u[1][x] - planes.u[row][x + dx];
+	const int dv = planes.v[1][x] - planes.v[row][x + dx];
+	return ABS(dy) > kHQxThresholdY || ABS(du) > kHQxThresholdU || ABS(dv) > kHQxThresholdV;
+}
+
+#ifdef HQX_PATTERN_SSE2
+static inline __m128i hqxAbsDiffSSE2(__m128i a, __m128i b) {
+	return _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+}
+
+/** Pattern bit for 16 pixels, set where the neighbour at (row, x + dx) differs */
+static inline __m128i hqxDiffSSE2(const HQxPlanes &planes, int row, int x, int dx, __m128i cy, __m128i cu, __m128i cv, uint8 bit) {
+	const __m128i ny = _mm_loadu_si128((const __m128i *)&planes.y[row][x + dx]);
+	const __m128i nu = _mm_loadu_si128((const __m128i *)&planes.u[row][x + dx]);
+	const __m128i nv = _mm_loadu_si128((const __m128i *)&planes.v[row][x + dx]);
+
+	// Saturated subtraction of the threshold leaves non-zero bytes exactly
+	// where the difference is above it.
+	const __m128i over = _mm_or_si128(
+		_mm_or_si128(_mm_subs_epu8(hqxAbsDiffSSE2(cy, ny), _mm_set1_epi8(kHQxThresholdY)),
+		             _mm_subs_epu8(hqxAbsDiffSSE2(cu, nu), _mm_set1_epi8(kHQxThresholdU))),
+		_mm_subs_epu8(hqxAbsDiffSSE2(cv, nv), _mm_set1_epi8(kHQxThresholdV)));
+
+	return _mm_andnot_si128(_mm_cmpeq_epi8(over, _mm_setzero_si128()), _mm_set1_epi8(bit));
+}
+#endif
+
+#ifdef HQX_PATTERN_NEON
+/** Pattern bit for 16 pixels, set where the neighbour at (row, x + dx) differs */
+static inline uint8x16_t hqxDiffNEON(const HQxPlanes &planes, int row, int x, int dx, uint8x16_t cy, uint8x16_t cu, uint8x16_t cv, uint8 bit) {
+	const uint8x16_t ny = vld1q_u8(&planes.y[row][x + dx]);
+	const uint8x16_t nu = vld1q_u8(&planes.u[row][x + dx]);
+	const uint8x16_t nv = vld1q_u8(&planes.v[row][x + dx]);
+
+	const uint8x16_t over = vorrq_u8(
+		vorrq_u8(vcgtq_u8(vabdq_u8(cy, ny), vdupq_n_u8(kHQxThresholdY)),
+		         vcgtq_u8(vabdq_u8(cu, nu), vdupq_n_u8(kHQxThresholdU))),
+		vcgtq_u8(vabdq_u8(cv, nv), vdupq_n_u8(kHQxThresholdV)));
+
+	return vandq_u8(over, vdupq_n_u8(bit));
+}
+#endif
+
+/**
+ * Compute the patterns of width (at most kHQxChunkWidth) consecutive pixels,
+ * the first of which is at p. The surrounding pixels have to be accessible.
+ */
+template<typename ColorMask>
+static void hqxComputePatterns(const typename ColorMask::PixelType *p, uint32 nextlineSrc, int width, uint8 *patterns) {
+	HQxPlanes planes;
+
+	assert(width <= kHQxChunkWidth);
+
+	for (int row = 0; row < 3; ++row) {
+		const typename ColorMask::PixelType *src = p + (row - 1) * (int)nextlineSrc - 1;
+		for (int x = 0; x < width + 2; ++x) {
+			const uint32 yuv = hqxRGBToYUV<ColorMask>(src[x]);
+			planes.y[row][x] = (yuv >> 16) & 0xFF;
+			planes.u[row][x] = (yuv >> 8) & 0xFF;
+			planes.v[row][x] = yuv & 0xFF;
+		}
+	}
+
+	int x = 0;
+
+#ifdef HQX_PATTERN_SSE2
+	for (; x + 16 <= width; x += 16) {
+		const __m128i cy = _mm_loadu_si128((const __m128i *)&planes.y[1][x + 1]);
+		const __m128i cu = _mm_loadu_si128((const __m128i *)&planes.u[1][x + 1]);
+		const __m128i cv = _mm_loadu_si128((const __m128i *)&planes.v[1][x + 1]);
+
+		__m128i pattern = hqxDiffSSE2(planes, 0, x, 0, cy, cu, cv, 0x01);
+		pattern = _mm_or_si128(pattern, hqxDiffSSE2(planes, 0, x, 1, cy, cu, cv, 0x02));
+		pattern = _mm_or_si128(pattern, hqxDiffSSE2(planes, 0, x, 2, cy, cu, cv, 0x04));
+		pattern = _mm_or_si128(pattern, hqxDiffSSE2(planes, 1, x, 0, cy, cu, cv, 0x08));
+		pattern = _mm_or_si128(pattern, hqxDiffSSE2(planes, 1, x, 2, cy, cu, cv, 0x10));
+		pattern = _mm_or_si128(pattern, hqxDiffSSE2(planes, 2, x, 0, cy, cu, cv, 0x20));
+		pattern = _mm_or_si128(pattern, hqxDiffSSE2(planes, 2, x, 1, cy, cu, cv, 0x40));
+		pattern = _mm_or_si128(pattern, hqxDiffSSE2(planes, 2, x, 2, cy, cu, cv, 0x80));
+
+		_mm_storeu_si128((__m128i *)(patterns + x), pattern);
+	}
+#endif
+
+#ifdef HQX_PATTERN_NEON
+	for (; x + 16 <= width; x += 16) {
+		const uint8x16_t cy = vld1q_u8(&planes.y[1][x + 1]);
+		const uint8x16_t cu = vld1q_u8(&planes.u[1][x + 1]);
+		const uint8x16_t cv = vld1q_u8(&planes.v[1][x + 1]);
+
+		uint8x16_t pattern = hqxDiffNEON(planes, 0, x, 0, cy, cu, cv, 0x01);
+		pattern = vorrq_u8(pattern, hqxDiffNEON(planes, 0, x, 1, cy, cu, cv, 0x02));
+		pattern = vorrq_u8(pattern, hqxDiffNEON(planes, 0, x, 2, cy, cu, cv, 0x04));
+		pattern = vorrq_u8(pattern, hqxDiffNEON(planes, 1, x, 0, cy, cu, cv, 0x08));
+		pattern = vorrq_u8(pattern, hqxDiffNEON(planes, 1, x, 2, cy, cu, cv, 0x10));
+		pattern = vorrq_u8(pattern, hqxDiffNEON(planes, 2, x, 0, cy, cu, cv, 0x20));
+		pattern = vorrq_u8(pattern, hqxDiffNEON(planes, 2, x, 1, cy, cu, cv, 0x40));
+		pattern = vorrq_u8(pattern, hqxDiffNEON(planes, 2, x, 2, cy, cu, cv, 0x80));
+
+		vst1q_u8(patterns + x, pattern);
+	}
+#endif
+
+	for (; x < width; ++x) {
+		// Index of the center pixel in the planes
+		const int c = x + 1;
+		int pattern = 0;
+		if (hqxDiffNeighbour(planes, 0, c, -1)) pattern |= 0x01;
+		if (hqxDiffNeighbour(planes, 0, c,  0)) pattern |= 0x02;
+		if (hqxDiffNeighbour(planes, 0, c,  1)) pattern |= 0x04;
+		if (hqxDiffNeighbour(planes, 1, c, -1)) pattern |= 0x08;
+		if (hqxDiffNeighbour(planes, 1, c,  1)) pattern |= 0x10;
+		if (hqxDiffNeighbour(planes, 2, c, -1)) pattern |= 0x20;
+		if (hqxDiffNeighbour(planes, 2, c,  0)) pattern |= 0x40;
+		if (hqxDiffNeighbour(planes, 2, c,  1)) pattern |= 0x80;
+		patterns[x] = pattern;
+	}
+}
+
+#endif
@@ -21,6 +21,7 @@
 
 #include "base/version.h"
 
+#include "common/algorithm.h"
 #include "common/config-manager.h"
 #include "common/events.h"
 #include "common/fs.h"
@@ -38,6 +39,7 @@
 #include "gui/gui-manager.h"
 #include "gui/options.h"
 #include "gui/saveload.h"
+#include "gui/saveload-dialog.h"
 #include "gui/widgets/edittext.h"
 #include "gui/widgets/list.h"
 #include "gui/widgets/tab.h"
@@ -704,6 +706,10 @@ void LauncherDialog::open() {
 	// re-launch the same game again.
 	ConfMan.setActiveDomain("");
 
+	// The savegames of the last game are not needed anymore, and its
+	// engine plugin may have been unloaded
+	SaveLoadChooserDialog::clearSaveStateCache();
+
 	CursorMan.popAllCursors();
 	Dialog::open();
 
@@ -722,11 +728,31 @@ void LauncherDialog::close() {
 	Dialog::close();
 }
 
-void LauncherDialog::updateListing() {
-	StringArray l;
+namespace {
+
+struct LauncherEntry {
+	Common::String description;
+	Common::String target;
+
+	LauncherEntry(const Common::String &d, const Common::String &t) : description(d), target(t) {}
+};
 
+struct LauncherEntryComparator {
+	bool operator()(const LauncherEntry &x, const LauncherEntry &y) const {
+		const int result = scumm_stricmp(x.description.c_str(), y.description.c_str());
+		if (result)
+			return result < 0;
+		return x.target < y.target;
+	}
+};
+
+} // End of anonymous namespace
+
+void LauncherDialog::updateListing() {
 	// Retrieve a list of all games defined in the config file
-	_domains.clear();
+	Common::Array<LauncherEntry> entries;
+	Common::StringMap newDescriptions;
+	Common::StringMap engineDescriptions;
 	const ConfigManager::DomainMap &domains = ConfMan.getGameDomains();
 	ConfigManager::DomainMap::const_iterator iter;
 	for (iter = domains.begin(); iter != domains.end(); ++iter) {
@@ -744,24 +770,44 @@ void LauncherDialog::updateListing() {
 		if (gameid.empty())
 			gameid = iter->_key;
 		if (description.empty()) {
-			GameDescriptor g = EngineMan.findGame(gameid);
-			if (g.contains("description"))
-				description = g.description();
+			// Looking up the game may have to load every engine plugin, so
+			// do it only once per gameid, and store the result in the game
+			// domain, so the next start does not need to do it at all.
+			Common::StringMap::const_iterator known = engineDescriptions.find(gameid);
+			if (known != engineDescriptions.end()) {
+				description = known->_value;
+			} else {
+				GameDescriptor g = EngineMan.findGame(gameid);
+				if (g.contains("description"))
+					description = g.description();
+				engineDescriptions[gameid] = description;
+			}
+
+			if (!description.empty())
+				newDescriptions[iter->_key] = description;
 		}
 
 		if (description.empty()) {
 			description = Common::String::format("Unknown (target %s, gameid %s)", iter->_key.c_str(), gameid.c_str());
 		}
 
-		if (!gameid.empty() && !description.empty()) {
-			// Insert the game into the launcher list
-			int pos = 0, size = l.size();
+		if (!gameid.empty() && !description.empty())
+			entries.push_back(LauncherEntry(description, iter->_key));
+	}
+
+	for (Common::StringMap::const_iterator i = newDescriptions.begin(); i != newDescriptions.end(); ++i)
+		ConfMan.set("description", i->_value, i->_key);
 
-			while (pos < size && (scumm_stricmp(description.c_str(), l[pos].c_str()) > 0))
-				pos++;
-			l.insert_at(pos, description);
-			_domains.insert_at(pos, iter->_key);
-		}
+	// Sort the games once, instead of inserting each at its place
+	Common::sort(entries.begin(), entries.end(), LauncherEntryComparator());
+
+	StringArray l;
+	l.reserve(entries.size());
+	_domains.clear();
+	_domains.reserve(entries.size());
+	for (uint i = 0; i < entries.size(); ++i) {
+		l.push_back(entries[i].description);
+		_domains.push_back(entries[i].target);
 	}
 
 	const int oldSel = _list->getSelected();
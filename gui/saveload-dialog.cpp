@@ -20,8 +20,14 @@
  */
 
 #include "gui/saveload-dialog.h"
+#include "common/algorithm.h"
 #include "common/translation.h"
 #include "common/config-manager.h"
+#include "common/hashmap.h"
+#include "common/savefile.h"
+#include "common/system.h"
+
+#include "base/version.h"
 
 #include "gui/message.h"
 #include "gui/gui-manager.h"
@@ -95,6 +101,237 @@ void SaveLoadChooserDialog::open() {
 	setResult(-1);
 }
 
+namespace {
+
+/**
+ * The savegame information of the target the last chooser was run for.
+ * Meta infos are only read for the slots which were shown, so thumbnails
+ * are decoded for the visible slots only.
+ */
+struct SaveStateCache {
+	const MetaEngine *metaEngine;
+	Common::String target;
+	uint32 changeCount;
+
+	bool hasList;
+	SaveStateList list;
+	Common::HashMap<int, SaveStateDescriptor> metaInfos;
+
+	SaveStateCache() : metaEngine(0), changeCount(0), hasList(false) {}
+
+	/**
+	 * Clear the cache unless it is for the given target and no savefile
+	 * changed since it was filled.
+	 */
+	void validate(const MetaEngine *newMetaEngine, const Common::String &newTarget) {
+		const uint32 newChangeCount = g_system->getSavefileManager()->getChangeCount();
+
+		if (newChangeCount && newChangeCount == changeCount && newMetaEngine == metaEngine && newTarget == target)
+			return;
+
+		clear();
+		metaEngine = newMetaEngine;
+		target = newTarget;
+		changeCount = newChangeCount;
+	}
+
+	void clear() {
+		metaEngine = 0;
+		target.clear();
+		changeCount = 0;
+		hasList = false;
+		list.clear();
+		metaInfos.clear(true);
+	}
+};
+
+SaveStateCache &getSaveStateCache() {
+	static SaveStateCache cache;
+	return cache;
+}
+
+/**
+ * The size and modification time of a savefile. The savegame index of a
+ * target is only valid while those of all savefiles stay the same.
+ */
+struct SavefileInfo {
+	Common::String name;
+	uint32 size;
+	uint32 modificationTime;
+};
+
+typedef Common::Array<SavefileInfo> SavefileInfoList;
+
+enum {
+	kSaveStateIndexTag = MKTAG('S', 'V', 'I', 'X'),
+	kSaveStateIndexVersion = 1
+};
+
+/**
+ * Get the size and modification time of all savefiles, sorted by name.
+ * Fails if the savefile manager can't provide them.
+ */
+bool getSavefileInfos(SavefileInfoList &infos) {
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+
+	Common::StringArray files = saveFileMan->listSavefiles("*");
+	if (saveFileMan->getError().getCode() != Common::kNoError)
+		return false;
+	Common::sort(files.begin(), files.end());
+
+	infos.resize(files.size());
+	for (uint i = 0; i < files.size(); ++i) {
+		infos[i].name = files[i];
+		if (!saveFileMan->getSavefileInfo(files[i], infos[i].size, infos[i].modificationTime))
+			return false;
+	}
+
+	return true;
+}
+
+Common::String getSaveStateIndexName(const Common::String &target) {
+	return "." + target + ".index";
+}
+
+void writeIndexString(Common::WriteStream &out, const Common::String &str) {
+	out.writeUint32BE(str.size());
+	out.write(str.c_str(), str.size());
+}
+
+Common::String readIndexString(Common::ReadStream &in) {
+	const uint32 size = in.readUint32BE();
+	Common::String str;
+
+	for (uint32 i = 0; i < size && !in.eos(); ++i)
+		str += (char)in.readByte();
+
+	return str;
+}
+
+/**
+ * Read the savegame list of the target from its index, if the savefiles
+ * are still the ones which it was written for.
+ */
+bool loadSaveStateIndex(const Common::String &target, const SavefileInfoList &infos, SaveStateList &list) {
+	Common::InSaveFile *in = g_system->getSavefileManager()->openForLoading(getSaveStateIndexName(target));
+	if (!in)
+		return false;
+
+	bool valid = in->readUint32BE() == kSaveStateIndexTag && in->readUint32BE() == kSaveStateIndexVersion
+		&& readIndexString(*in) == gScummVMFullVersion && in->readUint32BE() == infos.size();
+
+	for (uint i = 0; valid && i < infos.size(); ++i) {
+		valid = readIndexString(*in) == infos[i].name && in->readUint32BE() == infos[i].size
+			&& in->readUint32BE() == infos[i].modificationTime;
+	}
+
+	if (valid) {
+		// Every savegame takes at least 9 bytes
+		const uint32 count = in->readUint32BE();
+		valid = count <= (in->size() - in->pos()) / 9;
+		list.resize(valid ? count : 0);
+		for (uint i = 0; i < list.size() && !in->err() && !in->eos(); ++i) {
+			list[i].setSaveSlot(in->readSint32BE());
+			list[i].setDescription(readIndexString(*in));
+			const byte flags = in->readByte();
+			list[i].setDeletableFlag(flags & 1);
+			list[i].setWriteProtectedFlag(flags & 2);
+		}
+
+		valid = !in->err() && !in->eos();
+	}
+
+	delete in;
+
+	if (!valid)
+		list.clear();
+	return valid;
+}
+
+/**
+ * Write the savegame list of the target to its index. Empty lists are
+ * quickly made anyway, and lists which hold more than the index can keep
+ * are not stored.
+ */
+bool saveSaveStateIndex(const Common::String &target, const SavefileInfoList &infos, const SaveStateList &list) {
+	if (list.empty())
+		return false;
+
+	for (uint i = 0; i < list.size(); ++i) {
+		if (list[i].getThumbnail() || !list[i].getSaveDate().empty() || !list[i].getSaveTime().empty() || !list[i].getPlayTime().empty())
+			return false;
+	}
+
+	Common::OutSaveFile *out = g_system->getSavefileManager()->openForSaving(getSaveStateIndexName(target), false);
+	if (!out)
+		return false;
+
+	out->writeUint32BE(kSaveStateIndexTag);
+	out->writeUint32BE(kSaveStateIndexVersion);
+	writeIndexString(*out, gScummVMFullVersion);
+
+	out->writeUint32BE(infos.size());
+	for (uint i = 0; i < infos.size(); ++i) {
+		writeIndexString(*out, infos[i].name);
+		out->writeUint32BE(infos[i].size);
+		out->writeUint32BE(infos[i].modificationTime);
+	}
+
+	out->writeUint32BE(list.size());
+	for (uint i = 0; i < list.size(); ++i) {
+		out->writeSint32BE(list[i].getSaveSlot());
+		writeIndexString(*out, list[i].getDescription());
+		out->writeByte((list[i].getDeletableFlag() ? 1 : 0) | (list[i].getWriteProtectedFlag() ? 2 : 0));
+	}
+
+	out->finalize();
+	const bool success = !out->err();
+	delete out;
+	return success;
+}
+
+} // End of anonymous namespace
+
+void SaveLoadChooserDialog::clearSaveStateCache() {
+	getSaveStateCache().clear();
+}
+
+SaveStateList SaveLoadChooserDialog::listSaves() {
+	SaveStateCache &cache = getSaveStateCache();
+	cache.validate(_metaEngine, _target);
+
+	if (!cache.hasList) {
+		// The index of the target spares opening every savefile, which is
+		// what listing the savegames of most engines takes
+		SavefileInfoList infos;
+		const bool hasInfos = cache.changeCount && getSavefileInfos(infos);
+
+		if (!hasInfos || !loadSaveStateIndex(_target, infos, cache.list)) {
+			cache.list = _metaEngine->listSaves(_target.c_str());
+
+			// Writing the index does not change the savegames
+			if (hasInfos && saveSaveStateIndex(_target, infos, cache.list))
+				cache.changeCount = g_system->getSavefileManager()->getChangeCount();
+		}
+		cache.hasList = true;
+	}
+
+	return cache.list;
+}
+
+SaveStateDescriptor SaveLoadChooserDialog::querySaveMetaInfos(int slot) {
+	SaveStateCache &cache = getSaveStateCache();
+	cache.validate(_metaEngine, _target);
+
+	Common::HashMap<int, SaveStateDescriptor>::const_iterator i = cache.metaInfos.find(slot);
+	if (i != cache.metaInfos.end())
+		return i->_value;
+
+	SaveStateDescriptor desc = _metaEngine->querySaveMetaInfos(_target.c_str(), slot);
+	cache.metaInfos[slot] = desc;
+	return desc;
+}
+
 int SaveLoadChooserDialog::run(const Common::String &target, const MetaEngine *metaEngine) {
 	_metaEngine = metaEngine;
 	_target = target;
@@ -360,7 +597,7 @@ void SaveLoadChooserSimple::updateSelection(bool redraw) {
 	_playtime->setLabel(_("No playtime saved"));
 
 	if (selItem >= 0 && _metaInfoSupport) {
-		SaveStateDescriptor desc = _metaEngine->querySaveMetaInfos(_target.c_str(), _saveList[selItem].getSaveSlot());
+		SaveStateDescriptor desc = querySaveMetaInfos(_saveList[selItem].getSaveSlot());
 
 		isDeletable = desc.getDeletableFlag() && _delSupport;
 		isWriteProtected = desc.getWriteProtectedFlag();
@@ -461,7 +698,7 @@ void SaveLoadChooserSimple::close() {
 }
 
 void SaveLoadChooserSimple::updateSaveList() {
-	_saveList = _metaEngine->listSaves(_target.c_str());
+	_saveList = listSaves();
 
 	int curSlot = 0;
 	int saveSlot = 0;
@@ -619,7 +856,7 @@ void SaveLoadChooserGrid::handleMouseWheel(int x, int y, int direction) {
 void SaveLoadChooserGrid::open() {
 	SaveLoadChooserDialog::open();
 
-	_saveList = _metaEngine->listSaves(_target.c_str());
+	_saveList = listSaves();
 	_resultString.clear();
 
 	// Load information to restore the last page the user had open.
@@ -851,7 +1088,7 @@ void SaveLoadChooserGrid::updateSaves() {
 	for (uint i = _curPage * _entriesPerPage, curNum = 0; i < _saveList.size() && curNum < _entriesPerPage; ++i, ++curNum) {
 		const uint saveSlot = _saveList[i].getSaveSlot();
 
-		SaveStateDescriptor desc = _metaEngine->querySaveMetaInfos(_target.c_str(), saveSlot);
+		SaveStateDescriptor desc = querySaveMetaInfos(saveSlot);
 		SlotButton &curButton = _buttons[curNum];
 		curButton.setVisible(true);
 		const Graphics::Surface *thumbnail = desc.getThumbnail();
@@ -66,9 +66,26 @@ public:
 	int run(const Common::String &target, const MetaEngine *metaEngine);
 	virtual const Common::String &getResultString() const = 0;
 
+	/**
+	 * Free the savegame list and meta infos kept for the last target. Has to
+	 * be called when the engine plugin of the target may get unloaded.
+	 */
+	static void clearSaveStateCache();
+
 protected:
 	virtual int runIntern() = 0;
 
+	/**
+	 * MetaEngine::listSaves() and MetaEngine::querySaveMetaInfos() for the
+	 * current target. Both open every savefile they look at, so their
+	 * results are kept until the savefile manager reports a change. The
+	 * savegame list is also stored in a hidden index savefile of the target,
+	 * which later sessions use while the size and modification time of all
+	 * savefiles stay the same.
+	 */
+	SaveStateList listSaves();
+	SaveStateDescriptor querySaveMetaInfos(int slot);
+
 	const bool				_saveMode;
 	const MetaEngine		*_metaEngine;
 	bool					_delSupport;
@@ -0,0 +1,80 @@
+#ifndef TEST_BENCHMARK_BENCHMARK_H
+#define TEST_BENCHMARK_BENCHMARK_H
+
+// Helpers shared by the benchmarks. Every benchmark is a standalone program
+// which prints one tab separated line per measurement:
+//
+//   suite <TAB> name <TAB> variant <TAB> value <TAB> unit
+//
+// Lines starting with '#' are comments. Problems are reported on stderr and
+// through the exit code.
+
+#include "common/scummsys.h"
+
+#include <stdio.h>
+#include <time.h>
+
+namespace Benchmark {
+
+enum {
+	/** Minimal time in milliseconds every measurement runs for */
+	kMinRunTime = 250
+};
+
+/** Processor time in milliseconds since some fixed point */
+static inline double getMillis() {
+	return (double)clock() * 1000.0 / CLOCKS_PER_SEC;
+}
+
+static inline void printHeader(const char *suite) {
+	printf("# %s\n# suite\tname\tvariant\tvalue\tunit\n", suite);
+}
+
+static inline void report(const char *suite, const char *name, const char *variant, double value, const char *unit) {
+	printf("%s\t%s\t%s\t%.3f\t%s\n", suite, name, variant, value, unit);
+	fflush(stdout);
+}
+
+/**
+ * Deterministic pseudo random numbers, so every run of a benchmark measures
+ * exactly the same workload.
+ */
+class Random {
+	uint32 _state;
+
+public:
+	explicit Random(uint32 seed = 0x12345678) : _state(seed) {}
+
+	uint32 next() {
+		_state = _state * 1103515245 + 12345;
+		return _state >> 8;
+	}
+
+	/** A number in the range [0, max) */
+	uint32 next(uint32 max) {
+		return next() % max;
+	}
+};
+
+/**
+ * Run the workload repeatedly for at least kMinRunTime milliseconds. Each
+ * call of workload() has to return the number of operations it performed.
+ *
+ * @return	the number of operations per millisecond
+ */
+template<class Workload>
+double measure(Workload &workload) {
+	double ops = 0;
+	const double start = getMillis();
+	double elapsed;
+	do {
+		ops += workload();
+		elapsed = getMillis() - start;
+	} while (elapsed < kMinRunTime);
+
+	return ops / elapsed;
+}
+
+} // End of namespace Benchmark
+
+#endif
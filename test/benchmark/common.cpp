@@ -0,0 +1,637 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Benchmark of the basic classes in common/: String, Array, List, HashMap,
+// MemoryPool, the stream classes, the bit streams and the Huffman decoder.
+// All workloads are deterministic, so numbers of different builds can be
+// compared directly.
+//
+// Usage: common [pattern]
+// Only workloads whose "suite/name" matches the (case insensitive) pattern
+// are run, e.g. "string/*" or "*/read*".
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "test/benchmark/benchmark.h"
+
+#include "common/array.h"
+#include "common/bitstream.h"
+#include "common/bufferedstream.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/huffman.h"
+#include "common/list.h"
+#include "common/memorypool.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/str.h"
+#include "common/substream.h"
+
+namespace {
+
+/** Sink for results, to keep the compiler from dropping the work */
+volatile uint32 g_sink;
+
+const char *g_pattern = "*";
+
+bool isSelected(const char *suite, const char *name) {
+	return Common::matchString(Common::String::format("%s/%s", suite, name).c_str(), g_pattern, true);
+}
+
+/**
+ * Measure the workload, if selected, and report the number of operations
+ * per second, or the throughput for workloads counting bytes.
+ */
+template<class Workload>
+void run(const char *suite, const char *name, const char *variant, Workload workload, bool bytes = false) {
+	if (!isSelected(suite, name))
+		return;
+
+	const double perMilli = Benchmark::measure(workload);
+	if (bytes)
+		Benchmark::report(suite, name, variant, perMilli * 1000.0 / (1024 * 1024), "MB/s");
+	else
+		Benchmark::report(suite, name, variant, perMilli / 1000.0, "Mops/s");
+}
+
+/** File name like strings, as used for resources and config keys */
+Common::Array<Common::String> makeKeys(uint count) {
+	Common::Array<Common::String> keys;
+	Benchmark::Random random(count);
+	for (uint i = 0; i < count; ++i)
+		keys.push_back(Common::String::format("Resource.%03d/File_%u.DAT", random.next(1000), i));
+	return keys;
+}
+
+//
+// String
+//
+
+struct StringCopy {
+	Common::String _source;
+	explicit StringCopy(const char *source) : _source(source) {}
+
+	uint operator()() {
+		uint32 sum = 0;
+		for (int i = 0; i < 10000; ++i) {
+			Common::String copy(_source);
+			sum += copy.size();
+		}
+		g_sink += sum;
+		return 10000;
+	}
+};
+
+struct StringConcat {
+	uint operator()() {
+		// Build strings piece by piece, as done for paths and messages
+		uint32 sum = 0;
+		for (int i = 0; i < 1000; ++i) {
+			Common::String str;
+			for (int j = 0; j < 32; ++j) {
+				str += "piece";
+				str += '/';
+			}
+			sum += str.size();
+		}
+		g_sink += sum;
+		return 1000 * 64;
+	}
+};
+
+struct StringFormat {
+	uint operator()() {
+		uint32 sum = 0;
+		for (int i = 0; i < 1000; ++i)
+			sum += Common::String::format("%s-%02d.s%02d", "savegame", i % 100, i % 99).size();
+		g_sink += sum;
+		return 1000;
+	}
+};
+
+struct StringCompareIgnoreCase {
+	Common::Array<Common::String> _keys;
+	StringCompareIgnoreCase() : _keys(makeKeys(256)) {}
+
+	uint operator()() {
+		int sum = 0;
+		for (uint i = 0; i < _keys.size(); ++i)
+			for (uint j = 0; j < 16; ++j)
+				sum += _keys[i].compareToIgnoreCase(_keys[(i + j) % _keys.size()]);
+		g_sink += sum;
+		return _keys.size() * 16;
+	}
+};
+
+struct StringHash {
+	Common::Array<Common::String> _keys;
+	StringHash() : _keys(makeKeys(256)) {}
+
+	uint operator()() {
+		uint32 sum = 0;
+		for (uint i = 0; i < _keys.size(); ++i)
+			sum += Common::hashit_lower(_keys[i]);
+		g_sink += sum;
+		return _keys.size();
+	}
+};
+
+//
+// Array and List
+//
+
+template<class T>
+struct ArrayPushBack {
+	T _value;
+	explicit ArrayPushBack(const T &value) : _value(value) {}
+
+	uint operator()() {
+		// Grow from empty, as Arrays usually are
+		Common::Array<T> array;
+		for (int i = 0; i < 10000; ++i)
+			array.push_back(_value);
+		g_sink += array.size();
+		return 10000;
+	}
+};
+
+struct ArrayIterate {
+	Common::Array<uint32> _array;
+	ArrayIterate() {
+		for (uint32 i = 0; i < 10000; ++i)
+			_array.push_back(i);
+	}
+
+	uint operator()() {
+		uint32 sum = 0;
+		for (Common::Array<uint32>::const_iterator i = _array.begin(); i != _array.end(); ++i)
+			sum += *i;
+		g_sink += sum;
+		return _array.size();
+	}
+};
+
+struct ListPushBackErase {
+	uint operator()() {
+		Common::List<uint32> list;
+		for (uint32 i = 0; i < 1000; ++i)
+			list.push_back(i);
+
+		// Erase every other element while iterating
+		Common::List<uint32>::iterator it = list.begin();
+		while (it != list.end()) {
+			it = list.erase(it);
+			if (it != list.end())
+				++it;
+		}
+		g_sink += list.size();
+		return 1000 + 500;
+	}
+};
+
+struct ListIterate {
+	Common::List<uint32> _list;
+	ListIterate() {
+		for (uint32 i = 0; i < 10000; ++i)
+			_list.push_back(i);
+	}
+
+	uint operator()() {
+		uint32 sum = 0;
+		for (Common::List<uint32>::const_iterator i = _list.begin(); i != _list.end(); ++i)
+			sum += *i;
+		g_sink += sum;
+		return 10000;
+	}
+};
+
+//
+// HashMap
+//
+
+/**
+ * A mix of 60% lookups, 25% insertions and 15% erasures on a map with up to
+ * 1024 keys, which keeps the map at a steady size.
+ */
+struct HashMapMix {
+	Common::Array<Common::String> _keys;
+	Common::Array<uint32> _ops;
+	Common::HashMap<Common::String, uint32, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> _map;
+
+	HashMapMix() : _keys(makeKeys(1024)) {
+		Benchmark::Random random;
+		for (int i = 0; i < 4096; ++i)
+			_ops.push_back(random.next());
+	}
+
+	uint operator()() {
+		uint32 sum = 0;
+		for (uint i = 0; i < _ops.size(); ++i) {
+			const Common::String &key = _keys[_ops[i] % _keys.size()];
+			const uint32 op = (_ops[i] >> 12) % 100;
+
+			if (op < 60)
+				sum += _map.getVal(key, 0);
+			else if (op < 85)
+				_map[key] = i;
+			else
+				_map.erase(key);
+		}
+		g_sink += sum;
+		return _ops.size();
+	}
+};
+
+//
+// MemoryPool
+//
+
+/** Allocate chunks and free them again in random order */
+template<class Allocator>
+struct PoolAllocFree {
+	enum {
+		kChunkSize = 24,
+		kNumChunks = 1024
+	};
+
+	Allocator _allocator;
+	void *_chunks[kNumChunks];
+	Benchmark::Random _random;
+
+	PoolAllocFree() {
+		for (int i = 0; i < kNumChunks; ++i)
+			_chunks[i] = 0;
+	}
+
+	~PoolAllocFree() {
+		for (int i = 0; i < kNumChunks; ++i) {
+			if (_chunks[i])
+				_allocator.free(_chunks[i]);
+		}
+	}
+
+	uint operator()() {
+		for (int i = 0; i < 10000; ++i) {
+			void *&chunk = _chunks[_random.next(kNumChunks)];
+			if (chunk) {
+				_allocator.free(chunk);
+				chunk = 0;
+			} else {
+				chunk = _allocator.alloc();
+			}
+		}
+		return 10000;
+	}
+};
+
+struct PoolAllocator {
+	// Shared, since workloads are copied before they run
+	Common::SharedPtr<Common::MemoryPool> _pool;
+	PoolAllocator() : _pool(new Common::MemoryPool(PoolAllocFree<PoolAllocator>::kChunkSize)) {}
+	void *alloc() { return _pool->allocChunk(); }
+	void free(void *chunk) { _pool->freeChunk(chunk); }
+};
+
+struct MallocAllocator {
+	void *alloc() { return ::malloc(PoolAllocFree<MallocAllocator>::kChunkSize); }
+	void free(void *chunk) { ::free(chunk); }
+};
+
+//
+// Streams
+//
+
+enum {
+	kStreamSize = 256 * 1024
+};
+
+/** Wraps a memory buffer in the stream to benchmark, see StreamRead */
+struct MemoryStreamFactory {
+	Common::SeekableReadStream *create(const byte *data) const {
+		return new Common::MemoryReadStream(data, kStreamSize);
+	}
+};
+
+struct SubStreamFactory {
+	Common::SeekableReadStream *create(const byte *data) const {
+		return new Common::SeekableSubReadStream(new Common::MemoryReadStream(data, kStreamSize + 16), 16, kStreamSize + 16, DisposeAfterUse::YES);
+	}
+};
+
+struct BufferedStreamFactory {
+	Common::SeekableReadStream *create(const byte *data) const {
+		return Common::wrapBufferedSeekableReadStream(new Common::MemoryReadStream(data, kStreamSize), 4096, DisposeAfterUse::YES);
+	}
+};
+
+enum StreamReadPattern {
+	kReadByte,
+	kReadUint32LE,
+	kReadBlock
+};
+
+/** Read a whole stream with the given pattern */
+template<class Factory>
+struct StreamRead {
+	byte *_data;
+	StreamReadPattern _pattern;
+
+	StreamRead(byte *data, StreamReadPattern pattern) : _data(data), _pattern(pattern) {}
+
+	uint operator()() {
+		Common::SeekableReadStream *stream = Factory().create(_data);
+		uint32 sum = 0;
+
+		switch (_pattern) {
+		case kReadByte:
+			for (int i = 0; i < kStreamSize; ++i)
+				sum += stream->readByte();
+			break;
+		case kReadUint32LE:
+			for (int i = 0; i < kStreamSize / 4; ++i)
+				sum += stream->readUint32LE();
+			break;
+		case kReadBlock: {
+			byte block[512];
+			for (int i = 0; i < kStreamSize / 512; ++i) {
+				stream->read(block, sizeof(block));
+				sum += block[i & 511];
+			}
+			break;
+		}
+		}
+
+		delete stream;
+		g_sink += sum;
+		return kStreamSize;
+	}
+};
+
+/** Skip through a stream, reading small records at random positions */
+template<class Factory>
+struct StreamSeekRead {
+	byte *_data;
+	explicit StreamSeekRead(byte *data) : _data(data) {}
+
+	uint operator()() {
+		Common::SeekableReadStream *stream = Factory().create(_data);
+		Benchmark::Random random;
+		uint32 sum = 0;
+
+		for (int i = 0; i < 4096; ++i) {
+			stream->seek(random.next(kStreamSize - 16));
+			sum += stream->readUint32LE() + stream->readUint16BE();
+		}
+
+		delete stream;
+		g_sink += sum;
+		return 4096;
+	}
+};
+
+struct StreamWriteDynamic {
+	StreamReadPattern _pattern;
+	explicit StreamWriteDynamic(StreamReadPattern pattern) : _pattern(pattern) {}
+
+	uint operator()() {
+		Common::MemoryWriteStreamDynamic stream(DisposeAfterUse::YES);
+		byte block[512];
+		memset(block, 0x55, sizeof(block));
+
+		switch (_pattern) {
+		case kReadByte:
+			for (int i = 0; i < kStreamSize; ++i)
+				stream.writeByte(i);
+			break;
+		case kReadUint32LE:
+			for (int i = 0; i < kStreamSize / 4; ++i)
+				stream.writeUint32LE(i);
+			break;
+		case kReadBlock:
+			for (int i = 0; i < kStreamSize / 512; ++i)
+				stream.write(block, sizeof(block));
+			break;
+		}
+
+		g_sink += stream.size();
+		return kStreamSize;
+	}
+};
+
+template<class Factory>
+void runStream(const char *variant, byte *data) {
+	run("stream", "readByte", variant, StreamRead<Factory>(data, kReadByte), true);
+	run("stream", "readUint32LE", variant, StreamRead<Factory>(data, kReadUint32LE), true);
+	run("stream", "read512", variant, StreamRead<Factory>(data, kReadBlock), true);
+	run("stream", "seekRead", variant, StreamSeekRead<Factory>(data));
+}
+
+//
+// BitStream
+//
+
+enum {
+	kBitStreamSize = 64 * 1024
+};
+
+/** Read the whole data bit by bit, or in a mix of widths from 1 to 16 bits */
+template<class Stream>
+struct BitStreamRead {
+	const byte *_data;
+	bool _single;
+	BitStreamRead(const byte *data, bool single) : _data(data), _single(single) {}
+
+	uint operator()() {
+		Common::MemoryReadStream stream(_data, kBitStreamSize);
+		Stream bits(stream);
+		uint32 sum = 0;
+		if (_single) {
+			for (uint32 i = 0; i < kBitStreamSize * 8; ++i)
+				sum += bits.getBit();
+			g_sink += sum;
+			return kBitStreamSize;
+		}
+
+		// Each round reads 1 + 2 + ... + 16 = 136 bits
+		const uint32 rounds = kBitStreamSize * 8 / 136;
+		for (uint32 i = 0; i < rounds; ++i)
+			for (uint8 n = 1; n <= 16; ++n)
+				sum += bits.getBits(n);
+		g_sink += sum;
+		return rounds * 136 / 8;
+	}
+};
+
+template<class Stream>
+void runBitStream(const char *variant, const byte *data) {
+	run("bitstream", "getBit", variant, BitStreamRead<Stream>(data, true), true);
+	run("bitstream", "getBits", variant, BitStreamRead<Stream>(data, false), true);
+}
+
+//
+// Huffman
+//
+
+enum {
+	kHuffmanCodes = 126,
+	kHuffmanSymbols = 64 * 1024
+};
+
+/**
+ * Symbols of a code with lengths from 2 to 13 bits, as used by the video
+ * decoders, encoded for an MSB or LSB first bit stream.
+ */
+struct HuffmanData {
+	uint32 _codes[kHuffmanCodes];
+	uint8 _lengths[kHuffmanCodes];
+	Common::Huffman *_huffman;
+	byte *_data;
+	uint32 _size;
+
+	explicit HuffmanData(bool msbFirst) {
+		// A canonical code: 2 codes of 2 bits, 4 of 4 bits, ... 64 of 13 bits
+		uint32 code = 0;
+		uint8 length = 2;
+		uint32 count = 2;
+		for (uint32 i = 0; i < kHuffmanCodes; ) {
+			for (uint32 j = 0; j < count; ++j, ++i) {
+				_lengths[i] = length;
+				_codes[i] = code++;
+			}
+			const uint8 nextLength = (length == 10) ? 13 : length + 2;
+			code <<= nextLength - length;
+			length = nextLength;
+			count *= 2;
+		}
+
+		// LSB first streams read the codes from their lowest bit
+		if (!msbFirst) {
+			for (uint32 i = 0; i < kHuffmanCodes; ++i) {
+				uint32 reversed = 0;
+				for (uint8 j = 0; j < _lengths[i]; ++j)
+					reversed |= ((_codes[i] >> j) & 1) << (_lengths[i] - 1 - j);
+				_codes[i] = reversed;
+			}
+		}
+
+		_huffman = new Common::Huffman(0, kHuffmanCodes, _codes, _lengths);
+
+		// Encode random symbols
+		_size = kHuffmanSymbols * 2 + 4;
+		_data = new byte[_size];
+		memset(_data, 0, _size);
+		Benchmark::Random random;
+		uint32 bit = 0;
+		for (uint32 i = 0; i < kHuffmanSymbols; ++i) {
+			const uint32 symbol = random.next(kHuffmanCodes);
+			for (uint8 j = 0; j < _lengths[symbol]; ++j, ++bit) {
+				if (msbFirst && ((_codes[symbol] >> (_lengths[symbol] - 1 - j)) & 1))
+					_data[bit / 8] |= 0x80 >> (bit % 8);
+				else if (!msbFirst && ((_codes[symbol] >> j) & 1))
+					_data[bit / 8] |= 1 << (bit % 8);
+			}
+		}
+	}
+
+	~HuffmanData() {
+		delete _huffman;
+		delete[] _data;
+	}
+
+private:
+	HuffmanData(const HuffmanData &);
+	HuffmanData &operator=(const HuffmanData &);
+};
+
+template<class Stream>
+struct HuffmanDecode {
+	const HuffmanData &_data;
+	explicit HuffmanDecode(const HuffmanData &data) : _data(data) {}
+
+	uint operator()() {
+		Common::MemoryReadStream stream(_data._data, _data._size);
+		Stream bits(stream);
+		uint32 sum = 0;
+		for (uint32 i = 0; i < kHuffmanSymbols; ++i)
+			sum += _data._huffman->getSymbol(bits);
+		g_sink += sum;
+		return kHuffmanSymbols;
+	}
+};
+
+} // End of anonymous namespace
+
+int main(int argc, char *argv[]) {
+	if (argc > 1)
+		g_pattern = argv[1];
+
+	Benchmark::printHeader("ScummVM common benchmark");
+
+	run("string", "copy", "short", StringCopy("short"));
+	run("string", "copy", "long", StringCopy("a string which is too long for the builtin storage"));
+	run("string", "concat", "", StringConcat());
+	run("string", "format", "", StringFormat());
+	run("string", "compareToIgnoreCase", "", StringCompareIgnoreCase());
+	run("string", "hashit_lower", "", StringHash());
+
+	run("array", "push_back", "uint32", ArrayPushBack<uint32>(42));
+	run("array", "push_back", "String", ArrayPushBack<Common::String>("Resource.001/File.DAT"));
+	run("array", "iterate", "uint32", ArrayIterate());
+
+	run("list", "push_back_erase", "uint32", ListPushBackErase());
+	run("list", "iterate", "uint32", ListIterate());
+
+	run("hashmap", "mix", "String", HashMapMix());
+
+	run("memorypool", "alloc_free", "MemoryPool", PoolAllocFree<PoolAllocator>());
+	run("memorypool", "alloc_free", "malloc", PoolAllocFree<MallocAllocator>());
+
+	byte *data = new byte[kStreamSize + 16];
+	Benchmark::Random random;
+	for (int i = 0; i < kStreamSize + 16; ++i)
+		data[i] = random.next();
+
+	runStream<MemoryStreamFactory>("MemoryReadStream", data);
+	runStream<SubStreamFactory>("SeekableSubReadStream", data);
+	runStream<BufferedStreamFactory>("BufferedSeekableReadStream", data);
+
+	run("stream", "writeByte", "MemoryWriteStreamDynamic", StreamWriteDynamic(kReadByte), true);
+	run("stream", "writeUint32LE", "MemoryWriteStreamDynamic", StreamWriteDynamic(kReadUint32LE), true);
+	run("stream", "write512", "MemoryWriteStreamDynamic", StreamWriteDynamic(kReadBlock), true);
+
+	runBitStream<Common::BitStream32LELSB>("BitStream32LELSB", data);
+	runBitStream<Common::BitStreamMemory32LELSB>("BitStreamMemory32LELSB", data);
+	runBitStream<Common::BitStream16LEMSB>("BitStream16LEMSB", data);
+	runBitStream<Common::BitStreamMemory16LEMSB>("BitStreamMemory16LEMSB", data);
+
+	delete[] data;
+
+	if (isSelected("huffman", "getSymbol")) {
+		HuffmanData msbData(true), lsbData(false);
+		run("huffman", "getSymbol", "BitStream8MSB", HuffmanDecode<Common::BitStream8MSB>(msbData));
+		run("huffman", "getSymbol", "BitStream32LELSB", HuffmanDecode<Common::BitStream32LELSB>(lsbData));
+		run("huffman", "getSymbol", "BitStreamMemory8MSB", HuffmanDecode<Common::BitStreamMemory8MSB>(msbData));
+		run("huffman", "getSymbol", "BitStreamMemory32LELSB", HuffmanDecode<Common::BitStreamMemory32LELSB>(lsbData));
+	}
+
+	return 0;
+}
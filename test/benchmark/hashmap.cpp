@@ -0,0 +1,188 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Hash map benchmark: compares Common::HashMap and Common::FlatHashMap for
+// integer keys and for case insensitive string keys (as used for file names
+// and config domains), reporting millions of operations per second.
+//
+// Usage: hashmap [pattern]
+// Only operations whose name matches the (case insensitive) pattern are run.
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "test/benchmark/benchmark.h"
+
+#include "common/array.h"
+#include "common/flathashmap.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/str.h"
+
+namespace {
+
+/** Sink for results, to keep the compiler from dropping the lookups */
+volatile uint32 g_sink;
+
+const char *g_pattern = "*";
+
+enum {
+	/** Minimal number of operations timed at once, for the clock resolution */
+	kMinBatch = 100000
+};
+
+uint32 valueOf(uint key) {
+	return key;
+}
+
+uint32 valueOf(const Common::String &key) {
+	return key.size();
+}
+
+template<class Map, class Key>
+void benchInsert(const char *name, const char *variant, const Common::Array<Key> &keys) {
+	const uint rounds = (kMinBatch + keys.size() - 1) / keys.size();
+	uint32 ops = 0;
+	const double start = Benchmark::getMillis();
+	double elapsed;
+	do {
+		for (uint r = 0; r < rounds; ++r) {
+			Map map;
+			for (uint i = 0; i < keys.size(); ++i)
+				map[keys[i]] = i;
+			g_sink += map.size();
+		}
+		ops += rounds * keys.size();
+		elapsed = Benchmark::getMillis() - start;
+	} while (elapsed < Benchmark::kMinRunTime);
+
+	Benchmark::report(name, "insert", variant, ops / (elapsed * 1000.0), "Mops/s");
+}
+
+template<class Map, class Key>
+void benchLookup(const char *name, const char *op, const char *variant, const Map &map, const Common::Array<Key> &keys) {
+	const uint rounds = (kMinBatch + keys.size() - 1) / keys.size();
+	uint32 ops = 0;
+	const double start = Benchmark::getMillis();
+	double elapsed;
+	do {
+		uint32 sum = 0;
+		for (uint r = 0; r < rounds; ++r) {
+			for (uint i = 0; i < keys.size(); ++i)
+				sum += map.getVal(keys[i], 0);
+		}
+		g_sink += sum;
+		ops += rounds * keys.size();
+		elapsed = Benchmark::getMillis() - start;
+	} while (elapsed < Benchmark::kMinRunTime);
+
+	Benchmark::report(name, op, variant, ops / (elapsed * 1000.0), "Mops/s");
+}
+
+template<class Map, class Key>
+void benchErase(const char *name, const char *variant, const Map &map, const Common::Array<Key> &keys) {
+	// Erase from enough copies at once to get a measurable time.
+	const uint copies = (kMinBatch + keys.size() - 1) / keys.size();
+	Map *maps = new Map[copies];
+
+	uint32 ops = 0;
+	double elapsed = 0;
+	while (elapsed < Benchmark::kMinRunTime) {
+		for (uint c = 0; c < copies; ++c)
+			maps[c] = map;
+
+		const double start = Benchmark::getMillis();
+		for (uint c = 0; c < copies; ++c) {
+			for (uint i = 0; i < keys.size(); ++i)
+				maps[c].erase(keys[i]);
+			g_sink += maps[c].size();
+		}
+		elapsed += Benchmark::getMillis() - start;
+		ops += copies * keys.size();
+	}
+
+	delete[] maps;
+	Benchmark::report(name, "erase", variant, ops / (elapsed * 1000.0), "Mops/s");
+}
+
+template<class Map, class Key>
+void benchMap(const char *name, const char *variant, const Common::Array<Key> &keys, const Common::Array<Key> &missing) {
+	Map map;
+	for (uint i = 0; i < keys.size(); ++i)
+		map[keys[i]] = valueOf(keys[i]);
+
+	if (Common::matchString("insert", g_pattern, true))
+		benchInsert<Map>(name, variant, keys);
+	if (Common::matchString("hit", g_pattern, true))
+		benchLookup(name, "hit", variant, map, keys);
+	if (Common::matchString("miss", g_pattern, true))
+		benchLookup(name, "miss", variant, map, missing);
+	if (Common::matchString("erase", g_pattern, true))
+		benchErase(name, variant, map, keys);
+}
+
+template<class Key, class HashMapType, class FlatHashMapType>
+void benchKeys(const char *keyName, const Common::Array<Key> &allKeys) {
+	const uint sizes[] = { 64, 4096 };
+
+	for (int s = 0; s < ARRAYSIZE(sizes); ++s) {
+		// Use the first keys for the map, and the rest for failing lookups.
+		Common::Array<Key> keys, missing;
+		for (uint i = 0; i < sizes[s]; ++i) {
+			keys.push_back(allKeys[i]);
+			missing.push_back(allKeys[allKeys.size() - 1 - i]);
+		}
+
+		const Common::String name = Common::String::format("%s/%d", keyName, sizes[s]);
+		benchMap<HashMapType>(name.c_str(), "HashMap", keys, missing);
+		benchMap<FlatHashMapType>(name.c_str(), "FlatHashMap", keys, missing);
+	}
+}
+
+} // End of anonymous namespace
+
+int main(int argc, char *argv[]) {
+	if (argc > 1)
+		g_pattern = argv[1];
+
+	Benchmark::printHeader("ScummVM hash map benchmark");
+
+	// Scrambled, sequential and strided keys; Hash<uint> returns the key
+	// itself, so the last two only spread over the slots if the map mixes
+	// the hash bits.
+	Common::Array<uint> intKeys, sequentialKeys, stridedKeys;
+	Common::Array<Common::String> stringKeys;
+	for (uint i = 0; i < 8192; ++i) {
+		intKeys.push_back(i * 2654435761U);
+		sequentialKeys.push_back(i);
+		stridedKeys.push_back(i << 16);
+		stringKeys.push_back(Common::String::format("Resource.%03d/File_%u.dat", i % 100, i));
+	}
+
+	benchKeys<uint, Common::HashMap<uint, uint>, Common::FlatHashMap<uint, uint> >("uint", intKeys);
+	benchKeys<uint, Common::HashMap<uint, uint>, Common::FlatHashMap<uint, uint> >("uint-sequential", sequentialKeys);
+	benchKeys<uint, Common::HashMap<uint, uint>, Common::FlatHashMap<uint, uint> >("uint-strided", stridedKeys);
+	benchKeys<Common::String,
+		Common::HashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo>,
+		Common::FlatHashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> >("string", stringKeys);
+
+	return 0;
+}
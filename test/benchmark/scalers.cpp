@@ -0,0 +1,89 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Scaler benchmark: runs every ScalerProc over the 320x200 test images in
+// 555, 565 and 8888 format, reports the throughput in source megapixels per
+// second and checks the output against the golden hashes of the unit tests.
+//
+// Usage: scalers [pattern]
+// Only scalers whose name matches the (case insensitive) pattern are run.
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "test/benchmark/benchmark.h"
+#include "test/graphics/scaler_helper.h"
+
+using namespace ScalerTest;
+
+int main(int argc, char *argv[]) {
+	const char *pattern = (argc > 1) ? argv[1] : "*";
+	const int bitFormats[] = { 555, 565, 8888 };
+	int failures = 0;
+
+	Benchmark::printHeader("ScummVM scaler benchmark");
+
+	uint8 *images[kNumImages];
+	for (int i = 0; i < kNumImages; ++i)
+		images[i] = new uint8[getSrcPitch(8888) * kSrcHeight];
+
+	for (int f = 0; f < ARRAYSIZE(bitFormats); ++f) {
+		const int bitFormat = bitFormats[f];
+		const Common::String variant = Common::String::format("%d", bitFormat);
+		const int srcPitch = getSrcPitch(bitFormat);
+
+		InitScalers(bitFormat);
+		for (int i = 0; i < kNumImages; ++i)
+			generateImage(i, bitFormat, images[i]);
+
+		for (int s = 0; s < ARRAYSIZE(s_scalers); ++s) {
+			const ScalerInfo &info = s_scalers[s];
+			if (!Common::matchString(info.name, pattern, true))
+				continue;
+
+			const Common::String md5 = hashScaler(info, bitFormat);
+			const char *expected = info.getMD5(bitFormat);
+			if (md5 != expected) {
+				fprintf(stderr, "%s (%d): output %s does not match golden hash %s\n", info.name, bitFormat, md5.c_str(), expected);
+				failures++;
+			}
+
+			ScalerOutput output(info, bitFormat);
+			uint32 frames = 0;
+			const double start = Benchmark::getMillis();
+			double elapsed;
+			do {
+				info.proc(images[frames % kNumImages] + srcPitch + getBytesPerPixel(bitFormat), srcPitch, output.getPixels(), output.getPitch(), kWidth, kHeight);
+				frames++;
+				elapsed = Benchmark::getMillis() - start;
+			} while (elapsed < Benchmark::kMinRunTime);
+
+			Benchmark::report("scaler", info.name, variant.c_str(), (double)frames * kWidth * kHeight / (elapsed * 1000.0), "Mpixel/s");
+		}
+
+		DestroyScalers();
+	}
+
+	for (int i = 0; i < kNumImages; ++i)
+		delete[] images[i];
+
+	return failures ? 1 : 0;
+}
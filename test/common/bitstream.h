@@ -0,0 +1,110 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/bitstream.h"
+#include "common/memstream.h"
+
+class BitStreamTestSuite : public CxxTest::TestSuite {
+	uint32 _seed;
+
+	uint32 nextRandom(uint32 max) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 16) % max;
+	}
+
+	// Reads the same data with the stream based and the memory based bit
+	// stream of one memory layout, in a pseudo random mix of calls, and
+	// checks that both always return the same.
+	template<int valueBits, bool isLE, bool isMSB2LSB>
+	void checkLayout(uint32 size) {
+		byte data[67];
+		_seed = size;
+		for (uint32 i = 0; i < size; i++)
+			data[i] = nextRandom(256);
+
+		Common::MemoryReadStream stream(data, size);
+		Common::BitStreamImpl<valueBits, isLE, isMSB2LSB> streamBits(stream);
+		Common::BitStreamMemoryImpl<valueBits, isLE, isMSB2LSB> memoryBits(data, size);
+
+		TS_ASSERT_EQUALS(memoryBits.size(), streamBits.size());
+		TS_ASSERT_EQUALS(memoryBits.isMSBFirst(), streamBits.isMSBFirst());
+
+		while (!streamBits.eos()) {
+			const uint32 left = streamBits.size() - streamBits.pos();
+			const uint8 n = nextRandom(33);
+
+			switch (nextRandom(5)) {
+			case 0:
+				TS_ASSERT_EQUALS(memoryBits.getBit(), streamBits.getBit());
+				break;
+			case 1:
+				TS_ASSERT_EQUALS(memoryBits.peekBit(), streamBits.peekBit());
+				break;
+			case 2:
+				TS_ASSERT_EQUALS(memoryBits.peekBits(n), streamBits.peekBits(n));
+				break;
+			case 3:
+				if (n <= left)
+					TS_ASSERT_EQUALS(memoryBits.getBits(n), streamBits.getBits(n));
+				break;
+			default:
+				if (n <= left) {
+					memoryBits.skip(n);
+					streamBits.skip(n);
+				}
+				break;
+			}
+
+			TS_ASSERT_EQUALS(memoryBits.pos(), streamBits.pos());
+		}
+
+		TS_ASSERT(memoryBits.eos());
+		TS_ASSERT_EQUALS(memoryBits.peekBits(32), 0u);
+
+		memoryBits.rewind();
+		TS_ASSERT_EQUALS(memoryBits.pos(), 0u);
+	}
+
+	void checkSize(uint32 size) {
+		checkLayout< 8, false, true >(size);
+		checkLayout< 8, false, false>(size);
+		checkLayout<16, true , true >(size);
+		checkLayout<16, true , false>(size);
+		checkLayout<16, false, true >(size);
+		checkLayout<16, false, false>(size);
+		checkLayout<32, true , true >(size);
+		checkLayout<32, true , false>(size);
+		checkLayout<32, false, true >(size);
+		checkLayout<32, false, false>(size);
+	}
+
+public:
+	void test_memory_matches_stream() {
+		checkSize(64);
+		checkSize(67);
+		checkSize(1);
+	}
+
+	void test_memory_bit_order() {
+		const byte data[] = { 0x12, 0x34, 0x56, 0x78, 0x9A };
+
+		Common::BitStreamMemory8MSB bits8MSB(data, sizeof(data));
+		TS_ASSERT_EQUALS(bits8MSB.getBits(4), 0x1u);
+		TS_ASSERT_EQUALS(bits8MSB.getBits(32), 0x23456789u);
+		TS_ASSERT_EQUALS(bits8MSB.peekBits(8), 0xA0u);
+
+		Common::BitStreamMemory8LSB bits8LSB(data, sizeof(data));
+		TS_ASSERT_EQUALS(bits8LSB.getBits(4), 0x2u);
+		TS_ASSERT_EQUALS(bits8LSB.getBits(32), 0xA7856341u);
+		TS_ASSERT_EQUALS(bits8LSB.peekBits(8), 0x09u);
+
+		Common::BitStreamMemory16LEMSB bits16LEMSB(data, sizeof(data));
+		TS_ASSERT_EQUALS(bits16LEMSB.getBits(16), 0x3412u);
+		TS_ASSERT_EQUALS(bits16LEMSB.getBits(12), 0x785u);
+		TS_ASSERT_EQUALS(bits16LEMSB.size(), 32u);
+
+		Common::BitStreamMemory32BELSB bits32BELSB(data, sizeof(data));
+		TS_ASSERT_EQUALS(bits32BELSB.getBits(8), 0x78u);
+		TS_ASSERT_EQUALS(bits32BELSB.getBits(24), 0x123456u);
+		TS_ASSERT(bits32BELSB.eos());
+	}
+};
@@ -0,0 +1,223 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/flathashmap.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+
+class FlatHashMapTestSuite : public CxxTest::TestSuite
+{
+	typedef Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FlatStringMap;
+
+	public:
+	void test_empty_clear() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(!container.empty());
+		container.clear();
+		TS_ASSERT(container.empty());
+
+		FlatStringMap container2;
+		TS_ASSERT(container2.empty());
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(!container2.empty());
+		container2.clear(true);
+		TS_ASSERT(container2.empty());
+		container2["foo"] = "bar";
+		TS_ASSERT_EQUALS(container2["FOO"], "bar");
+	}
+
+	void test_contains() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(container.contains(0));
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT(!container.contains(17));
+		TS_ASSERT(!container.contains(-1));
+
+		FlatStringMap container2;
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(container2.contains("foo"));
+		TS_ASSERT(container2.contains("QUUX"));
+		TS_ASSERT(!container2.contains("bar"));
+		TS_ASSERT(!container2.contains("asdf"));
+	}
+
+	void test_add_remove() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		TS_ASSERT(container.contains(1));
+		container.erase(1);
+		TS_ASSERT(!container.contains(1));
+		container[1] = 42;
+		TS_ASSERT(container.contains(1));
+		container.erase(0);
+		TS_ASSERT(!container.empty());
+		container.erase(1);
+		TS_ASSERT(!container.empty());
+		container.erase(2);
+		TS_ASSERT(!container.empty());
+		container.erase(3);
+		TS_ASSERT(!container.empty());
+		container.erase(4);
+		TS_ASSERT(container.empty());
+		container[1] = 33;
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT(!container.empty());
+		container.erase(container.find(1));
+		TS_ASSERT(container.empty());
+	}
+
+	void test_lookup_with_default() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = -1;
+		container[2] = 45;
+
+		// We take a const ref now to ensure that the map
+		// is not modified by getVal.
+		const Common::FlatHashMap<int, int> &containerRef = container;
+
+		TS_ASSERT_EQUALS(containerRef.getVal(0), 17);
+		TS_ASSERT_EQUALS(containerRef.getVal(17), 0);
+		TS_ASSERT_EQUALS(containerRef.getVal(0, -10), 17);
+		TS_ASSERT_EQUALS(containerRef.getVal(17, -10), -10);
+		TS_ASSERT_EQUALS(containerRef.size(), 3U);
+		TS_ASSERT_EQUALS(containerRef.find(17), containerRef.end());
+	}
+
+	void test_hash_map_copy() {
+		Common::FlatHashMap<int, int> map1, container2;
+		map1[323] = 32;
+		container2 = map1;
+		TS_ASSERT_EQUALS(container2[323], 32);
+
+		Common::FlatHashMap<int, int> container3(map1);
+		map1.clear();
+		TS_ASSERT_EQUALS(container3[323], 32);
+	}
+
+	void test_collision() {
+		// All these keys hash to the same slot, and erasing one of them
+		// has to move the following ones back.
+		Common::FlatHashMap<int, int> h;
+		h[5] = 1;
+		h[16+5] = 2;
+		h[32+5] = 3;
+		h[6] = 4;
+		TS_ASSERT_EQUALS(h[5], 1);
+		TS_ASSERT_EQUALS(h[16+5], 2);
+		TS_ASSERT_EQUALS(h[32+5], 3);
+		TS_ASSERT_EQUALS(h[6], 4);
+		h.erase(5);
+		TS_ASSERT(!h.contains(5));
+		TS_ASSERT_EQUALS(h[16+5], 2);
+		TS_ASSERT_EQUALS(h[32+5], 3);
+		TS_ASSERT_EQUALS(h[6], 4);
+		h.erase(16+5);
+		TS_ASSERT_EQUALS(h[32+5], 3);
+		TS_ASSERT_EQUALS(h[6], 4);
+		h[5] = 5;
+		TS_ASSERT_EQUALS(h[5], 5);
+		TS_ASSERT_EQUALS(h.size(), 3U);
+	}
+
+	void test_iterator() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		container.erase(1);
+		container[1] = 42;
+		container.erase(0);
+		container.erase(1);
+
+		int found = 0;
+		Common::FlatHashMap<int, int>::iterator i;
+		for (i = container.begin(); i != container.end(); ++i) {
+			int key = i->_key;
+			TS_ASSERT(key >= 0 && key <= 4);
+			TS_ASSERT(!(found & (1 << key)));
+			found |= 1 << key;
+		}
+		TS_ASSERT(found == 16+8+4);
+
+		found = 0;
+		Common::FlatHashMap<int, int>::const_iterator j;
+		for (j = container.begin(); j != container.end(); ++j) {
+			int key = j->_key;
+			TS_ASSERT(key >= 0 && key <= 4);
+			TS_ASSERT(!(found & (1 << key)));
+			found |= 1 << key;
+		}
+		TS_ASSERT(found == 16+8+4);
+	}
+
+	void test_matches_hashmap() {
+		// Apply the same random operations to a HashMap and a FlatHashMap,
+		// making the tables grow and wrap around.
+		Common::HashMap<uint, uint> reference;
+		Common::FlatHashMap<uint, uint> container;
+		uint32 seed = 0x12345678;
+
+		for (int i = 0; i < 20000; ++i) {
+			seed = seed * 1103515245 + 12345;
+			const uint key = (seed >> 8) % 3000;
+
+			if ((seed >> 4) & 1) {
+				reference[key] = i;
+				container[key] = i;
+			} else {
+				reference.erase(key);
+				container.erase(key);
+			}
+		}
+
+		TS_ASSERT_EQUALS(container.size(), reference.size());
+		for (uint key = 0; key < 3000; ++key) {
+			TS_ASSERT_EQUALS(container.contains(key), reference.contains(key));
+			TS_ASSERT_EQUALS(container.getVal(key, 0xFFFFFFFF), reference.getVal(key, 0xFFFFFFFF));
+		}
+
+		uint count = 0;
+		for (Common::FlatHashMap<uint, uint>::const_iterator it = container.begin(); it != container.end(); ++it) {
+			TS_ASSERT_EQUALS(it->_value, reference[it->_key]);
+			count++;
+		}
+		TS_ASSERT_EQUALS(count, reference.size());
+	}
+
+	void test_strided_keys() {
+		// Hash<uint> returns the key itself. Without mixing the hash bits,
+		// all of these keys would start probing at the same slot, and this
+		// would take seconds instead of milliseconds.
+		Common::FlatHashMap<uint, uint> container;
+		const uint count = 65536;
+
+		for (uint i = 0; i < count; ++i)
+			container[i << 16] = i;
+		TS_ASSERT_EQUALS(container.size(), count);
+
+		uint found = 0;
+		for (uint i = 0; i < count; ++i) {
+			if (container.getVal(i << 16, 0xFFFFFFFF) == i)
+				found++;
+		}
+		TS_ASSERT_EQUALS(found, count);
+		TS_ASSERT(!container.contains(1 << 15));
+
+		for (uint i = 0; i < count; ++i)
+			container.erase(i << 16);
+		TS_ASSERT(container.empty());
+	}
+};
@@ -0,0 +1,154 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/bitstream.h"
+#include "common/huffman.h"
+#include "common/memstream.h"
+
+/**
+ * A simple BitStream writer, to encode the test messages.
+ */
+class HuffmanTestWriter {
+public:
+	HuffmanTestWriter(bool msbFirst) : _msbFirst(msbFirst), _bits(0) {
+		memset(_data, 0, sizeof(_data));
+	}
+
+	/** Write a code the way Common::Huffman reads it. */
+	void writeCode(uint32 code, uint8 length) {
+		for (uint8 i = 0; i < length; i++) {
+			uint32 bit = _msbFirst ? ((code >> (length - 1 - i)) & 1) : ((code >> i) & 1);
+			if (bit)
+				_data[_bits / 8] |= _msbFirst ? (0x80 >> (_bits % 8)) : (1 << (_bits % 8));
+			_bits++;
+		}
+	}
+
+	const byte *getData() const { return _data; }
+	uint32 getSize() const { return (_bits + 7) / 8; }
+	uint32 getBits() const { return _bits; }
+
+private:
+	bool _msbFirst;
+	uint32 _bits;
+	byte _data[4096];
+};
+
+class HuffmanTestSuite : public CxxTest::TestSuite {
+	// Decodes the symbols [0, count) encoded with the given codes, in a
+	// pseudo random order, from a stream of both bit orders. The codes are
+	// given MSB first, LSB first streams read them reversed.
+	void checkCodes(uint32 count, const uint32 *msbCodes, const uint8 *lengths, const uint32 *symbols) {
+		uint32 message[512];
+		uint32 seed = 1;
+		for (int i = 0; i < ARRAYSIZE(message); i++) {
+			seed = seed * 1103515245 + 12345;
+			message[i] = (seed >> 16) % count;
+		}
+
+		for (int msbFirst = 0; msbFirst < 2; msbFirst++) {
+			uint32 codes[64];
+			for (uint32 i = 0; i < count; i++) {
+				codes[i] = 0;
+				for (uint8 j = 0; j < lengths[i]; j++)
+					codes[i] |= ((msbFirst ? (msbCodes[i] >> j) : (msbCodes[i] >> (lengths[i] - 1 - j))) & 1) << j;
+			}
+
+			Common::Huffman huffman(0, count, codes, lengths, symbols);
+
+			HuffmanTestWriter writer(msbFirst);
+			for (int i = 0; i < ARRAYSIZE(message); i++)
+				writer.writeCode(codes[message[i]], lengths[message[i]]);
+
+			Common::MemoryReadStream stream(writer.getData(), writer.getSize());
+			Common::BitStream *bits;
+			if (msbFirst)
+				bits = new Common::BitStream8MSB(stream);
+			else
+				bits = new Common::BitStream8LSB(stream);
+
+			checkMessage(huffman, *bits, message, ARRAYSIZE(message), symbols, writer.getBits());
+			delete bits;
+
+			if (msbFirst) {
+				Common::BitStreamMemory8MSB memoryBits(writer.getData(), writer.getSize());
+				checkMessage(huffman, memoryBits, message, ARRAYSIZE(message), symbols, writer.getBits());
+			} else {
+				Common::BitStreamMemory8LSB memoryBits(writer.getData(), writer.getSize());
+				checkMessage(huffman, memoryBits, message, ARRAYSIZE(message), symbols, writer.getBits());
+			}
+		}
+	}
+
+	template<class BITSTREAM>
+	void checkMessage(const Common::Huffman &huffman, BITSTREAM &bits, const uint32 *message, int length, const uint32 *symbols, uint32 messageBits) {
+		for (int i = 0; i < length; i++)
+			TS_ASSERT_EQUALS(huffman.getSymbol(bits), (symbols ? symbols[message[i]] : message[i]));
+		TS_ASSERT_EQUALS(bits.pos(), messageBits);
+	}
+
+public:
+	void test_short_codes() {
+		// A complete code, including the 1 bit code '0'
+		const uint32 codes[]   = { 0, 4, 5, 6, 14, 15 };
+		const uint8  lengths[] = { 1, 3, 3, 3,  4,  4 };
+		const uint32 symbols[] = { 10, 20, 30, 40, 50, 60 };
+
+		checkCodes(ARRAYSIZE(codes), codes, lengths, 0);
+		checkCodes(ARRAYSIZE(codes), codes, lengths, symbols);
+	}
+
+	void test_long_codes() {
+		// A complete code with lengths from 1 to 21 bits and then 24 bits, so
+		// that the codes continue in secondary lookup tables
+		uint32 codes[29];
+		uint8 lengths[29];
+
+		uint32 code = 0;
+		for (int i = 0; i < 21; i++) {
+			lengths[i] = i + 1;
+			codes[i] = code;
+			code = (code + 1) << 1;
+		}
+		for (int i = 21; i < 29; i++) {
+			lengths[i] = 24;
+			codes[i] = (code << 2) + (i - 21);
+		}
+
+		checkCodes(ARRAYSIZE(codes), codes, lengths, 0);
+	}
+
+	void test_set_symbols() {
+		const uint32 codes[]   = { 0, 2, 3 };
+		const uint8  lengths[] = { 1, 2, 2 };
+		const uint32 symbols[] = { 7, 8, 9 };
+
+		Common::Huffman huffman(0, ARRAYSIZE(codes), codes, lengths);
+		huffman.setSymbols(symbols);
+
+		// The codes 3, 0, 2 MSB first
+		const byte data[] = { 0xD0 };
+		Common::MemoryReadStream stream(data, sizeof(data));
+		Common::BitStream8MSB bits(stream);
+
+		TS_ASSERT_EQUALS(huffman.getSymbol(bits), 9u);
+		TS_ASSERT_EQUALS(huffman.getSymbol(bits), 7u);
+		TS_ASSERT_EQUALS(huffman.getSymbol(bits), 8u);
+	}
+
+	void test_end_of_stream() {
+		// A short code at the end of the stream has to be decodable, even
+		// though the lookup table wants more bits than are left
+		const uint32 codes[]   = { 0, 1, 0x3FF };
+		const uint8  lengths[] = { 1, 10, 10 };
+
+		Common::Huffman huffman(0, ARRAYSIZE(codes), codes, lengths);
+
+		const byte data[] = { 0x00 };
+		Common::MemoryReadStream stream(data, sizeof(data));
+		Common::BitStream8MSB bits(stream);
+
+		for (int i = 0; i < 8; i++)
+			TS_ASSERT_EQUALS(huffman.getSymbol(bits), 0u);
+		TS_ASSERT(bits.eos());
+	}
+};
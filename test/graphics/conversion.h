@@ -0,0 +1,44 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/conversion.h"
+
+class ConversionTestSuite : public CxxTest::TestSuite {
+	public:
+	void test_crossBlitMap_32bpp() {
+		const byte src[] = { 0, 1, 2, 0xFF,  0xFF, 2, 1, 0 };
+		const uint32 map[256] = { 0x11223344, 0x55667788, 0x99AABBCC };
+		uint32 dst[2 * 3];
+
+		for (int i = 0; i < ARRAYSIZE(dst); ++i)
+			dst[i] = 0xDEADBEEF;
+
+		TS_ASSERT(Graphics::crossBlitMap((byte *)dst, src, 3 * sizeof(uint32), 4, 3, 2, 4, map));
+
+		TS_ASSERT_EQUALS(dst[0], 0x11223344U);
+		TS_ASSERT_EQUALS(dst[1], 0x55667788U);
+		TS_ASSERT_EQUALS(dst[2], 0x99AABBCCU);
+		TS_ASSERT_EQUALS(dst[3], 0U);
+		TS_ASSERT_EQUALS(dst[4], 0x99AABBCCU);
+		TS_ASSERT_EQUALS(dst[5], 0x55667788U);
+	}
+
+	void test_crossBlitMap_16bpp() {
+		const byte src[] = { 3, 1 };
+		uint32 map[256] = { 0 };
+		map[1] = 0x1234;
+		map[3] = 0xF00F;
+		uint16 dst[2];
+
+		TS_ASSERT(Graphics::crossBlitMap((byte *)dst, src, sizeof(dst), sizeof(src), 2, 1, 2, map));
+		TS_ASSERT_EQUALS(dst[0], 0xF00F);
+		TS_ASSERT_EQUALS(dst[1], 0x1234);
+	}
+
+	void test_crossBlitMap_invalid() {
+		byte buffer[4] = { 0 };
+		const uint32 map[256] = { 0 };
+
+		TS_ASSERT(!Graphics::crossBlitMap(buffer, buffer, 4, 4, 1, 1, 4, map));
+		TS_ASSERT(!Graphics::crossBlitMap(buffer, buffer + 1, 3, 1, 1, 1, 3, map));
+	}
+};
@@ -0,0 +1,115 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/md5.h"
+#include "common/memstream.h"
+#include "graphics/pixelformat.h"
+#include "graphics/surface.h"
+#include "graphics/decoders/jpeg.h"
+
+/**
+ * A 24x19 baseline JPEG with 4:2:0 chroma subsampling and a restart marker
+ * after every MCU. It holds a flat area, gradients and stripes.
+ */
+static const byte s_jpegImage[] = {
+	0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x10, 0x4A, 0x46, 0x49, 0x46, 0x00, 0x01, 0x01, 0x00, 0x00, 0x01,
+	0x00, 0x01, 0x00, 0x00, 0xFF, 0xDB, 0x00, 0x43, 0x00, 0x08, 0x05, 0x05, 0x08, 0x0C, 0x14, 0x19,
+	0x1E, 0x06, 0x06, 0x07, 0x09, 0x0D, 0x1D, 0x1E, 0x1B, 0x07, 0x06, 0x08, 0x0C, 0x14, 0x1C, 0x22,
+	0x1C, 0x07, 0x08, 0x0B, 0x0E, 0x19, 0x2B, 0x28, 0x1F, 0x09, 0x0B, 0x12, 0x1C, 0x22, 0x36, 0x33,
+	0x26, 0x0C, 0x11, 0x1B, 0x20, 0x28, 0x34, 0x38, 0x2E, 0x18, 0x20, 0x27, 0x2B, 0x33, 0x3C, 0x3C,
+	0x32, 0x24, 0x2E, 0x2F, 0x31, 0x38, 0x32, 0x33, 0x31, 0xFF, 0xDB, 0x00, 0x43, 0x01, 0x08, 0x09,
+	0x0C, 0x17, 0x31, 0x31, 0x31, 0x31, 0x09, 0x0A, 0x0D, 0x21, 0x31, 0x31, 0x31, 0x31, 0x0C, 0x0D,
+	0x1C, 0x31, 0x31, 0x31, 0x31, 0x31, 0x17, 0x21, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31,
+	0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31,
+	0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0x31, 0xFF, 0xC0,
+	0x00, 0x11, 0x08, 0x00, 0x13, 0x00, 0x18, 0x03, 0x01, 0x22, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11,
+	0x01, 0xFF, 0xC4, 0x00, 0x1F, 0x00, 0x00, 0x01, 0x05, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
+	0x0A, 0x0B, 0xFF, 0xC4, 0x00, 0xB5, 0x10, 0x00, 0x02, 0x01, 0x03, 0x03, 0x02, 0x04, 0x03, 0x05,
+	0x05, 0x04, 0x04, 0x00, 0x00, 0x01, 0x7D, 0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21,
+	0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xA1, 0x08, 0x23,
+	0x42, 0xB1, 0xC1, 0x15, 0x52, 0xD1, 0xF0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0A, 0x16, 0x17,
+	0x18, 0x19, 0x1A, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A,
+	0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A,
+	0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A,
+	0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99,
+	0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7,
+	0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5,
+	0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE1, 0xE2, 0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF1,
+	0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 0xFA, 0xFF, 0xC4, 0x00, 0x1F, 0x01, 0x00, 0x03,
+	0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+	0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0xFF, 0xC4, 0x00, 0xB5, 0x11, 0x00,
+	0x02, 0x01, 0x02, 0x04, 0x04, 0x03, 0x04, 0x07, 0x05, 0x04, 0x04, 0x00, 0x01, 0x02, 0x77, 0x00,
+	0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71, 0x13,
+	0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xA1, 0xB1, 0xC1, 0x09, 0x23, 0x33, 0x52, 0xF0, 0x15,
+	0x62, 0x72, 0xD1, 0x0A, 0x16, 0x24, 0x34, 0xE1, 0x25, 0xF1, 0x17, 0x18, 0x19, 0x1A, 0x26, 0x27,
+	0x28, 0x29, 0x2A, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+	0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+	0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88,
+	0x89, 0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6,
+	0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4,
+	0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE2,
+	0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9,
+	0xFA, 0xFF, 0xDD, 0x00, 0x04, 0x00, 0x01, 0xFF, 0xDA, 0x00, 0x0C, 0x03, 0x01, 0x00, 0x02, 0x11,
+	0x03, 0x11, 0x00, 0x3F, 0x00, 0x9E, 0xB8, 0x7B, 0x5D, 0x05, 0x33, 0x99, 0x01, 0x12, 0xF5, 0x11,
+	0x8E, 0x9B, 0xC7, 0x4E, 0x7D, 0xFE, 0xB5, 0xDC, 0x55, 0x8B, 0x3D, 0x0F, 0x1C, 0x79, 0x3B, 0xFB,
+	0x7D, 0xA7, 0xD3, 0x3D, 0xF3, 0xFE, 0xC7, 0xD6, 0xBC, 0xCC, 0x92, 0xB2, 0x4A, 0x5C, 0xDC, 0xBF,
+	0x65, 0xAB, 0xDD, 0xAB, 0xAB, 0xDB, 0x45, 0xAD, 0xFB, 0x3F, 0x85, 0x6B, 0x7D, 0xD1, 0xED, 0xE3,
+	0x71, 0x3C, 0xAE, 0x3A, 0xEF, 0x7F, 0xD0, 0xFF, 0xD0, 0xC8, 0x83, 0x42, 0xDD, 0x8F, 0xB6, 0x2F,
+	0x97, 0xFF, 0x00, 0x3C, 0xF6, 0xFF, 0x00, 0x17, 0xD7, 0xAF, 0x4A, 0xB1, 0xFF, 0x00, 0x08, 0xF5,
+	0xAF, 0xFC, 0xF4, 0x93, 0xF2, 0xFF, 0x00, 0xEB, 0x57, 0x6F, 0x67, 0xA1, 0x6D, 0xFE, 0x0F, 0xB4,
+	0xFF, 0x00, 0xED, 0x3F, 0xE7, 0xF7, 0xAA, 0xE7, 0xF6, 0x3F, 0xFD, 0x43, 0x7F, 0x4F, 0xFE, 0xB5,
+	0x45, 0x7C, 0x64, 0x6F, 0xFB, 0xFF, 0x00, 0x62, 0xDF, 0xDA, 0x72, 0x8C, 0xA5, 0x2F, 0x9C, 0xA1,
+	0xEE, 0xBF, 0x2B, 0x6C, 0xB4, 0x7A, 0xDC, 0xFB, 0xCC, 0x2E, 0x63, 0xA6, 0x92, 0x67, 0xFF, 0xD1,
+	0x9E, 0xBB, 0x7B, 0x64, 0x55, 0x6D, 0xAA, 0xA0, 0x27, 0x0A, 0x57, 0xD9, 0xBD, 0xFD, 0xEB, 0x88,
+	0xAE, 0xE2, 0x1F, 0xF5, 0x83, 0xEA, 0x3F, 0xA5, 0x7C, 0x8C, 0x64, 0xD2, 0xBD, 0x39, 0x35, 0xEF,
+	0xC2, 0x93, 0x6B, 0xAC, 0x5F, 0x35, 0xD7, 0xA3, 0xB2, 0xBA, 0xEB, 0x61, 0x71, 0x26, 0xF0, 0xFF,
+	0x00, 0xB7, 0x9F, 0xFE, 0x92, 0x7F, 0xFF, 0xD2, 0xF5, 0x95, 0x85, 0x22, 0xC7, 0x90, 0x81, 0x73,
+	0xF7, 0xFD, 0xF1, 0xF5, 0xA9, 0x3C, 0xF7, 0xF5, 0x1F, 0x90, 0xA4, 0x9F, 0xF8, 0x7F, 0x1F, 0xE9,
+	0x4D, 0xAF, 0xCF, 0x33, 0xBA, 0xF5, 0x23, 0x52, 0x4B, 0x0B, 0x5E, 0xAC, 0x12, 0xB7, 0x24, 0x53,
+	0x69, 0x2D, 0x13, 0xD1, 0x2D, 0x37, 0xD4, 0xD7, 0x03, 0xB2, 0xE6, 0x3F, 0xFF, 0xD9,};
+
+/*
+ * Check the decoded images against the output of the original decoder, so
+ * that its optimizations can't silently change it.
+ */
+class JPEGTestSuite : public CxxTest::TestSuite {
+	Common::String hashSurface(const Graphics::Surface *surface) {
+		Common::MemoryReadStream stream((const byte *)surface->pixels, surface->pitch * surface->h);
+		return Common::computeStreamMD5AsString(stream);
+	}
+
+	Common::String decode(uint32 size, const Graphics::PixelFormat *format) {
+		Graphics::JPEGDecoder jpeg;
+		if (format)
+			jpeg.setOutputPixelFormat(*format);
+
+		Common::MemoryReadStream stream(s_jpegImage, size);
+		TS_ASSERT(jpeg.loadStream(stream));
+
+		const Graphics::Surface *surface = jpeg.getSurface();
+		TS_ASSERT_EQUALS(surface->w, 24);
+		TS_ASSERT_EQUALS(surface->h, 19);
+		return hashSurface(surface);
+	}
+
+	public:
+	void test_decode_planes() {
+		TS_ASSERT_EQUALS(decode(sizeof(s_jpegImage), 0), "91fc40da27a43e8a40cd74e0c46c4940");
+	}
+
+	void test_decode_to_format() {
+		const Graphics::PixelFormat rgba(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		TS_ASSERT_EQUALS(decode(sizeof(s_jpegImage), &rgba), "91fc40da27a43e8a40cd74e0c46c4940");
+
+		const Graphics::PixelFormat rgb565(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		TS_ASSERT_EQUALS(decode(sizeof(s_jpegImage), &rgb565), "e1941eaaae8e4f218064a93a55a6ef74");
+	}
+
+	void test_decode_without_eoi() {
+		// The entropy coded data is read ahead, which must not keep the
+		// missing EOI marker from being handled
+		const Graphics::PixelFormat rgba(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		TS_ASSERT_EQUALS(decode(sizeof(s_jpegImage) - 2, 0), "91fc40da27a43e8a40cd74e0c46c4940");
+		TS_ASSERT_EQUALS(decode(sizeof(s_jpegImage) - 2, &rgba), "91fc40da27a43e8a40cd74e0c46c4940");
+	}
+};
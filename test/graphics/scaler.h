@@ -0,0 +1,92 @@
+#include <cxxtest/TestSuite.h>
+
+#include "test/graphics/scaler_helper.h"
+
+/*
+ * Compare the output of every scaler against the output of the original C
+ * implementations, so that optimized versions can't silently change it.
+ */
+class ScalerTestSuite : public CxxTest::TestSuite {
+	void checkFormat(int bitFormat) {
+		InitScalers(bitFormat);
+
+		for (int i = 0; i < ARRAYSIZE(ScalerTest::s_scalers); ++i) {
+			const ScalerTest::ScalerInfo &info = ScalerTest::s_scalers[i];
+			TSM_ASSERT_EQUALS(info.name, ScalerTest::hashScaler(info, bitFormat), info.getMD5(bitFormat));
+		}
+
+		DestroyScalers();
+	}
+
+	public:
+	void test_scalers_555() {
+		checkFormat(555);
+	}
+
+	void test_scalers_565() {
+		checkFormat(565);
+	}
+
+	void test_scalers_8888() {
+		checkFormat(8888);
+	}
+
+	/*
+	 * Scale 555 images and the same images converted to 8888. Apart from the
+	 * lower bits the 16 bit versions lose when interpolating, the results
+	 * have to be identical.
+	 */
+	void test_scalers_8888_match_555() {
+		using namespace ScalerTest;
+
+		const Graphics::PixelFormat format555 = getFormat(555);
+		const Graphics::PixelFormat format8888 = getFormat(8888);
+		const int pitch555 = getSrcPitch(555);
+		const int pitch8888 = getSrcPitch(8888);
+
+		uint8 *src555 = new uint8[pitch555 * kSrcHeight];
+		uint8 *src8888 = new uint8[pitch8888 * kSrcHeight];
+
+		for (int image = 0; image < kNumImages; ++image) {
+			generateImage(image, 555, src555);
+			for (int y = 0; y < kSrcHeight; ++y) {
+				for (int x = 0; x < kSrcWidth; ++x) {
+					uint8 r, g, b;
+					format555.colorToRGB(getPixel(src555 + y * pitch555 + x * 2, 2), r, g, b);
+					setPixel(src8888 + y * pitch8888 + x * 4, 4, format8888.RGBToColor(r, g, b));
+				}
+			}
+
+			for (int i = 0; i < ARRAYSIZE(s_scalers); ++i) {
+				const ScalerInfo &info = s_scalers[i];
+				ScalerOutput out555(info, 555), out8888(info, 8888);
+
+				InitScalers(555);
+				info.proc(src555 + pitch555 + 2, pitch555, out555.getPixels(), out555.getPitch(), kWidth, kHeight);
+				InitScalers(8888);
+				info.proc(src8888 + pitch8888 + 4, pitch8888, out8888.getPixels(), out8888.getPitch(), kWidth, kHeight);
+
+				int maxDiff = 0;
+				for (int y = 0; y < out555.getHeight(); ++y) {
+					for (int x = 0; x < out555.getWidth(); ++x) {
+						uint8 a1, r1, g1, b1, a2, r2, g2, b2;
+						format555.colorToARGB(getPixel(out555.getPixels() + y * out555.getPitch() + x * 2, 2), a1, r1, g1, b1);
+						format8888.colorToARGB(getPixel(out8888.getPixels() + y * out8888.getPitch() + x * 4, 4), a2, r2, g2, b2);
+
+						maxDiff = MAX(maxDiff, ABS(a1 - a2));
+						maxDiff = MAX(maxDiff, ABS(r1 - r2));
+						maxDiff = MAX(maxDiff, ABS(g1 - g2));
+						maxDiff = MAX(maxDiff, ABS(b1 - b2));
+					}
+				}
+
+				TSM_ASSERT_LESS_THAN(info.name, maxDiff, 8);
+				TSM_ASSERT(info.name, out8888.checkGuard());
+			}
+		}
+
+		DestroyScalers();
+		delete[] src8888;
+		delete[] src555;
+	}
+};
@@ -0,0 +1,285 @@
+#ifndef TEST_GRAPHICS_SCALER_HELPER_H
+#define TEST_GRAPHICS_SCALER_HELPER_H
+
+// Test images, the list of scalers and their golden output hashes. Shared by
+// the scaler unit tests and the scaler benchmark.
+
+#include "common/md5.h"
+#include "common/memstream.h"
+#include "common/str.h"
+#include "common/util.h"
+
+#include "graphics/colormasks.h"
+#include "graphics/pixelformat.h"
+#include "graphics/scaler.h"
+#include "graphics/scaler/aspect.h"
+#include "graphics/scaler/downscaler.h"
+
+namespace ScalerTest {
+
+enum {
+	kWidth = 320,
+	kHeight = 200,
+	/** Source surfaces have a border like the SDL backend's _tmpscreen */
+	kSrcWidth = kWidth + 3,
+	kSrcHeight = kHeight + 3,
+	/** Untouched pixels around the output, used to detect overruns */
+	kGuard = 8,
+	kGuardColor = 0xA5A5,
+	kNumImages = 3
+};
+
+/**
+ * Aspect ratio correction the way the SDL backend does it: copy the image,
+ * then stretch it in place to 6/5 of its height.
+ */
+static void Stretch200To240(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+	Normal1x(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+#ifdef USE_SCALERS
+	stretch200To240(dstPtr, dstPitch, width, height, 0, 0, 0);
+#endif
+}
+
+struct ScalerInfo {
+	const char *name;
+	ScalerProc *proc;
+	/** The output is width * xNum / xDen by height * yNum / yDen pixels */
+	int xNum, xDen, yNum, yDen;
+	/** MD5 over the output of all test images, in 555, 565 and 8888 format */
+	const char *md5_555, *md5_565, *md5_8888;
+
+	const char *getMD5(int bitFormat) const {
+		return (bitFormat == 555) ? md5_555 : (bitFormat == 565) ? md5_565 : md5_8888;
+	}
+};
+
+static const ScalerInfo s_scalers[] = {
+	{ "Normal1x", Normal1x, 1, 1, 1, 1,
+	  "05be0e0d0131f3d8bfb6f5a7b7909f33", "68ae1203fa43956c6de0a78aca08fca4", "078473ee19ec1e8795d220a692f25180" },
+#ifdef USE_SCALERS
+	{ "Normal2x", Normal2x, 2, 1, 2, 1,
+	  "daeba743ad2c31e623a3abe744c916fb", "20e6422f82a0d8a457d037100f250751", "c383a0cd8eb31eb91ccfbca2cfe105ef" },
+	{ "Normal3x", Normal3x, 3, 1, 3, 1,
+	  "49bba3c71bf75591fba79f52ed2bb75f", "b870bf1ce3355f8c5cb7d1cfa5cdb193", "ab76e0590afad392e7df6f2150b4f4bb" },
+	{ "Normal1o5x", Normal1o5x, 3, 2, 3, 2,
+	  "9d89f8e7a26098962aa0fa3066cc2491", "9c01b3fcf50a2bcc5de325e38c084c0f", "77cc4d69c3d8e57be04ba21e9f384c63" },
+	{ "2xSaI", _2xSaI, 2, 1, 2, 1,
+	  "cb69fc8277854f1bf1a8ad6eaef012e9", "dfc907549a06a0552f1c9d06b73851d9", "79715228f179eb5a8d584ed9d35bc5dc" },
+	{ "Super2xSaI", Super2xSaI, 2, 1, 2, 1,
+	  "1b4da6a0b11721d0c094d93217c9e9c0", "6452ccdd3b8ff26c80d2e6fd6a057853", "bfd55600942ed6b006f70f127a5691cd" },
+	{ "SuperEagle", SuperEagle, 2, 1, 2, 1,
+	  "c7170f39546c3f8dc5d1a30170648888", "0ac52ca8efe42adf03fd4059e3ba1d02", "976e2dd3d317b917ba85f961f90f8707" },
+	{ "AdvMame2x", AdvMame2x, 2, 1, 2, 1,
+	  "5f523cd3894a2723c8118f095ec8ce9c", "e35942b8fa8b37b92ea5a999bceb9987", "d80550b154da54d018d9c49865774966" },
+	{ "AdvMame3x", AdvMame3x, 3, 1, 3, 1,
+	  "d922c36fcd55128aac39a9a164c4e3c4", "74587fe05222327680c7dbfd1de77cc3", "169ace63be9426a51fecf07e25a9be26" },
+#ifdef USE_HQ_SCALERS
+	{ "HQ2x", HQ2x, 2, 1, 2, 1,
+	  "5b507b7d5da1d4ac217f59af9d81dc3e", "96e7a83f6c690008f9a3bee61c6964e8", "cf0ceead84b1c0d571641074916f65fa" },
+	{ "HQ3x", HQ3x, 3, 1, 3, 1,
+	  "c373401a4216fbbcad4513b8601a3e45", "3204f28089c859b0922a8a6b571b7c7a", "187a4967ceaaed21559e11232e560af0" },
+#endif
+	{ "TV2x", TV2x, 2, 1, 2, 1,
+	  "6285beaafbb7f686369aa035b1d275ab", "0bd04ca5c95bde507e8ca45d46c14bc5", "ee9c6a40b93f08f2fbee1449e7ab9372" },
+	{ "DotMatrix", DotMatrix, 2, 1, 2, 1,
+	  "d95827d8498249f7f6ab0fe6961b9b75", "89e2e1498fa20cc3ca15faca6014171b", "8aceae1def43eaece8cd26b95df7a3a8" },
+	{ "Normal1xAspect", Normal1xAspect, 1, 1, 6, 5,
+	  "0045c808addfc043543b451d69bb16fd", "4e67f10a4520c1fefef32d4ff83a6d2f", "f0ab9917c50ddb2ef939b331ced361dc" },
+	{ "Stretch200To240", Stretch200To240, 1, 1, 6, 5,
+	  "0045c808addfc043543b451d69bb16fd", "4e67f10a4520c1fefef32d4ff83a6d2f", "f0ab9917c50ddb2ef939b331ced361dc" },
+	{ "DownscaleAllByHalf", DownscaleAllByHalf, 1, 2, 1, 2,
+	  "7eca6632cd34946ccb57680e470ebb55", "4fdde430ac576e4163e1af739d837083", "43f551a4cd98b7277973f8485fd80f2a" },
+	{ "DownscaleHorizByHalf", DownscaleHorizByHalf, 1, 2, 1, 1,
+	  "2afb622fcbb3827af03970a0bb507734", "32c6f9d30a1578b7cdbc3d9738eeb5bf", "af8af98cc1771b121ad439a753e3891c" },
+	{ "DownscaleHorizByThreeQuarters", DownscaleHorizByThreeQuarters, 3, 4, 1, 1,
+	  "0eaa9c101dc23a58669455fba8f60fb1", "e3182c1428c7dfabdec2ca0c9334e6bf", "5a258193cd842952a3e352ea318831df" },
+#endif
+};
+
+static inline Graphics::PixelFormat getFormat(int bitFormat) {
+	if (bitFormat == 555)
+		return Graphics::createPixelFormat<555>();
+	else if (bitFormat == 565)
+		return Graphics::createPixelFormat<565>();
+	else
+		return Graphics::createPixelFormat<8888>();
+}
+
+static inline int getBytesPerPixel(int bitFormat) {
+	return (bitFormat == 8888) ? 4 : 2;
+}
+
+static inline int getSrcPitch(int bitFormat) {
+	return kSrcWidth * getBytesPerPixel(bitFormat);
+}
+
+static inline uint32 getPixel(const uint8 *p, int bytesPerPixel) {
+	return (bytesPerPixel == 4) ? *(const uint32 *)p : *(const uint16 *)p;
+}
+
+static inline void setPixel(uint8 *p, int bytesPerPixel, uint32 color) {
+	if (bytesPerPixel == 4)
+		*(uint32 *)p = color;
+	else
+		*(uint16 *)p = color;
+}
+
+/** Simple LCG, so that the images don't depend on the C library */
+static inline uint32 nextRandom(uint32 &seed) {
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 16) & 0x7FFF;
+}
+
+/**
+ * Fill a source surface (including its border) with one of the test images:
+ * smooth gradients, pixel art like tiles with thin lines, and noise.
+ */
+static void generateImage(int image, int bitFormat, uint8 *buf) {
+	const Graphics::PixelFormat format = getFormat(bitFormat);
+	uint32 seed = 0x1234 + image;
+
+	// A 16 colour palette for the tiles
+	uint8 palette[16][3];
+	for (int i = 0; i < 16; ++i)
+		for (int c = 0; c < 3; ++c)
+			palette[i][c] = nextRandom(seed) & 0xFF;
+
+	uint8 tiles[(kSrcHeight + 7) / 8][(kSrcWidth + 7) / 8];
+	for (int y = 0; y < ARRAYSIZE(tiles); ++y)
+		for (int x = 0; x < ARRAYSIZE(tiles[0]); ++x)
+			tiles[y][x] = nextRandom(seed) & 15;
+
+	const int bytesPerPixel = format.bytesPerPixel;
+	const int srcPitch = getSrcPitch(bitFormat);
+
+	for (int y = 0; y < kSrcHeight; ++y) {
+		uint8 *dst = buf + y * srcPitch;
+
+		for (int x = 0; x < kSrcWidth; ++x) {
+			uint8 r, g, b;
+
+			switch (image) {
+			case 0:
+				r = x * 255 / (kSrcWidth - 1);
+				g = y * 255 / (kSrcHeight - 1);
+				b = (x + y) & 0xFF;
+				break;
+			case 1: {
+				int color = tiles[y / 8][x / 8];
+				// Single pixel lines and diagonals, which are what the
+				// edge detection of the smarter scalers is made for.
+				if ((x % 8) == (y % 8) || (y % 16) == 3)
+					color = (color + 5) & 15;
+				r = palette[color][0];
+				g = palette[color][1];
+				b = palette[color][2];
+				break;
+			}
+			default:
+				r = nextRandom(seed) & 0xFF;
+				g = nextRandom(seed) & 0xFF;
+				b = nextRandom(seed) & 0xFF;
+				break;
+			}
+
+			setPixel(dst + x * bytesPerPixel, bytesPerPixel, format.RGBToColor(r, g, b));
+		}
+	}
+}
+
+/**
+ * Destination surface with a guard band around the scaler output.
+ */
+class ScalerOutput {
+public:
+	ScalerOutput(const ScalerInfo &info, int bitFormat) {
+		_bytesPerPixel = ScalerTest::getBytesPerPixel(bitFormat);
+		_width = kWidth * info.xNum / info.xDen;
+		_height = kHeight * info.yNum / info.yDen;
+		_pitch = (_width + 2 * kGuard) * _bytesPerPixel;
+		_buffer = new uint8[_pitch * (_height + 2 * kGuard)];
+		clear();
+	}
+
+	~ScalerOutput() {
+		delete[] _buffer;
+	}
+
+	void clear() {
+		for (int i = 0; i < (_width + 2 * kGuard) * (_height + 2 * kGuard); ++i)
+			setPixel(_buffer + i * _bytesPerPixel, _bytesPerPixel, kGuardColor);
+	}
+
+	uint8 *getPixels() {
+		return _buffer + kGuard * _pitch + kGuard * _bytesPerPixel;
+	}
+
+	const uint8 *getPixels() const {
+		return _buffer + kGuard * _pitch + kGuard * _bytesPerPixel;
+	}
+
+	int getPitch() const { return _pitch; }
+	int getWidth() const { return _width; }
+	int getHeight() const { return _height; }
+	int getBytesPerPixel() const { return _bytesPerPixel; }
+
+	/** Check that nothing outside of the output has been written to */
+	bool checkGuard() const {
+		for (int y = 0; y < _height + 2 * kGuard; ++y) {
+			for (int x = 0; x < _width + 2 * kGuard; ++x) {
+				const bool inside = x >= kGuard && x < kGuard + _width && y >= kGuard && y < kGuard + _height;
+				if (!inside && getPixel(_buffer + y * _pitch + x * _bytesPerPixel, _bytesPerPixel) != kGuardColor)
+					return false;
+			}
+		}
+		return true;
+	}
+
+	/** Append the output area to data */
+	void appendTo(uint8 *data) const {
+		const int lineSize = _width * _bytesPerPixel;
+		for (int y = 0; y < _height; ++y)
+			memcpy(data + y * lineSize, getPixels() + y * _pitch, lineSize);
+	}
+
+private:
+	uint8 *_buffer;
+	int _bytesPerPixel;
+	int _width, _height, _pitch;
+};
+
+/**
+ * Run a scaler over all test images and return the MD5 of its output, or
+ * "overrun" when it wrote outside of its output area. InitScalers() has to
+ * be called with bitFormat beforehand.
+ */
+static Common::String hashScaler(const ScalerInfo &info, int bitFormat) {
+	const int srcPitch = getSrcPitch(bitFormat);
+	uint8 *src = new uint8[srcPitch * kSrcHeight];
+	ScalerOutput output(info, bitFormat);
+
+	const int imageSize = output.getWidth() * output.getHeight() * output.getBytesPerPixel();
+	uint8 *data = new uint8[imageSize * kNumImages];
+	bool overrun = false;
+
+	for (int image = 0; image < kNumImages; ++image) {
+		generateImage(image, bitFormat, src);
+		output.clear();
+		info.proc(src + srcPitch + getBytesPerPixel(bitFormat), srcPitch, output.getPixels(), output.getPitch(), kWidth, kHeight);
+
+		if (!output.checkGuard())
+			overrun = true;
+		output.appendTo(data + image * imageSize);
+	}
+
+	Common::MemoryReadStream stream(data, imageSize * kNumImages);
+	Common::String md5 = overrun ? "overrun" : Common::computeStreamMD5AsString(stream);
+
+	delete[] data;
+	delete[] src;
+	return md5;
+}
+
+} // End of namespace ScalerTest
+
+#endif
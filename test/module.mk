@@ -5,8 +5,8 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h
-TEST_LIBS    := audio/libaudio.a common/libcommon.a
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/graphics/*.h
+TEST_LIBS    := audio/libaudio.a graphics/libgraphics.a common/libcommon.a
 
 #
 TEST_FLAGS   := --runner=StdioPrinter --no-std --no-eh --include=$(srcdir)/test/cxxtest_mingw.h
@@ -35,8 +35,29 @@ test/runner.cpp: $(TESTS)
 	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
 
 
+
+######################################################################
+# Benchmarks, each a standalone program in test/benchmark.
+# Use the 'bench' target to build and run all of them. The output is tab
+# separated, see test/benchmark/benchmark.h. BENCH_PATTERN is passed to
+# every benchmark to select what it measures, e.g. BENCH_PATTERN='string/*'.
+# Edit BENCHMARKS to add more.
+######################################################################
+
+BENCHMARKS   := scalers hashmap common
+BENCH_LIBS   := graphics/libgraphics.a common/libcommon.a
+BENCH_PATTERN ?= *
+BENCH_PROGS  := $(addprefix test/benchmark/,$(addsuffix $(EXEEXT),$(BENCHMARKS)))
+
+bench: $(BENCH_PROGS)
+	@for prog in $(BENCH_PROGS); do ./$$prog "$(BENCH_PATTERN)" || exit 1; done
+test/benchmark/%$(EXEEXT): $(srcdir)/test/benchmark/%.cpp $(BENCH_LIBS) $(TESTS) $(wildcard $(srcdir)/test/benchmark/*.h $(srcdir)/common/*.h)
+	$(QUIET)$(MKDIR) test/benchmark
+	$(QUIET_LINK)$(CXX) $(TEST_CXXFLAGS) $(CPPFLAGS) -o $@ $(filter-out %.h,$+) $(TEST_LDFLAGS)
+
+
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner
+	-$(RM) test/runner.cpp test/runner $(BENCH_PROGS)
 
-.PHONY: test clean-test
+.PHONY: test bench clean-test
@@ -188,8 +188,8 @@ void BinkDecoder::readNextPacket() {
 			//                  Number of samples in bytes
 			audio.sampleCount = _bink->readUint32LE() / (2 * audio.channels);
 
-			audio.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-					audioPacketStart + 4, audioPacketEnd), true);
+			Common::SeekableSubReadStream audioPacket(_bink, audioPacketStart + 4, audioPacketEnd);
+			audio.bits = new Common::BitStreamMemory32LELSB(audioPacket);
 
 			audioTrack->decodePacket();
 
@@ -205,8 +205,8 @@ void BinkDecoder::readNextPacket() {
 	uint32 videoPacketStart = _bink->pos();
 	uint32 videoPacketEnd   = _bink->pos() + frameSize;
 
-	frame.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-			videoPacketStart, videoPacketEnd), true);
+	Common::SeekableSubReadStream videoPacket(_bink, videoPacketStart, videoPacketEnd);
+	frame.bits = new Common::BitStreamMemory32LELSB(videoPacket);
 
 	videoTrack->decodePacket(frame);
 